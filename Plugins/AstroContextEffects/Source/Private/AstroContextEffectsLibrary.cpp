@@ -9,6 +9,7 @@
 */
 
 #include "AstroContextEffectsLibrary.h"
+#include "Engine/AssetManager.h"
 #include "NiagaraSystem.h"
 #include "Sound/SoundBase.h"
 
@@ -17,24 +18,48 @@
 
 void UAstroContextEffectsLibrary::GetEffects(const FGameplayTag Effect, const FGameplayTagContainer Context,
 	TArray<USoundBase*>& Sounds, TArray<UNiagaraSystem*>& NiagaraSystems)
+{
+	if (const FAstroContextEffectsQueryResult* QueryResult = FindEffects(Effect, Context))
+	{
+		Sounds.Append(QueryResult->Sounds);
+		NiagaraSystems.Append(QueryResult->NiagaraSystems);
+	}
+}
+
+const FAstroContextEffectsQueryResult* UAstroContextEffectsLibrary::FindEffects(const FGameplayTag& Effect, const FGameplayTagContainer& Context) const
 {
 	// Make sure Effect is valid and Library is loaded
-	if (Effect.IsValid() && Context.IsValid() && EffectsLoadState == EContextEffectsLibraryLoadState::Loaded)
+	if (!Effect.IsValid() || !Context.IsValid() || EffectsLoadState != EContextEffectsLibraryLoadState::Loaded)
 	{
-		// Loop through Context Effects
-		for (const auto ActiveContextEffect : ActiveContextEffects)
+		return nullptr;
+	}
+
+	const FAstroContextEffectsQueryKey QueryKey { Effect, Context };
+	FAstroContextEffectsQueryResult* QueryResult = CachedQueryResults.Find(QueryKey);
+	if (!QueryResult)
+	{
+		QueryResult = &CachedQueryResults.Add(QueryKey);
+
+		// Only Context Effects with an exact Tag Match are checked
+		if (const TArray<int32>* ActiveContextEffectIndices = ActiveContextEffectIndicesByTag.Find(Effect))
 		{
-			// Make sure the Effect is an exact Tag Match and ensure the Context has all tags in the Effect (and neither or both are empty)
-			if (Effect.MatchesTagExact(ActiveContextEffect->EffectTag)
-				&& Context.HasAllExact(ActiveContextEffect->Context)
-				&& (ActiveContextEffect->Context.IsEmpty() == Context.IsEmpty()))
+			for (const int32 ActiveContextEffectIndex : *ActiveContextEffectIndices)
 			{
-				// Get all Matching Sounds and Niagara Systems
-				Sounds.Append(ActiveContextEffect->Sounds);
-				NiagaraSystems.Append(ActiveContextEffect->NiagaraSystems);
+				const UAstroActiveContextEffects* ActiveContextEffect = ActiveContextEffects[ActiveContextEffectIndex];
+
+				// Ensure the Context has all tags in the Effect (and neither or both are empty)
+				if (Context.HasAllExact(ActiveContextEffect->Context)
+					&& (ActiveContextEffect->Context.IsEmpty() == Context.IsEmpty()))
+				{
+					// Get all Matching Sounds and Niagara Systems
+					QueryResult->Sounds.Append(ActiveContextEffect->Sounds);
+					QueryResult->NiagaraSystems.Append(ActiveContextEffect->NiagaraSystems);
+				}
 			}
 		}
 	}
+
+	return QueryResult->Sounds.IsEmpty() && QueryResult->NiagaraSystems.IsEmpty() ? nullptr : QueryResult;
 }
 
 void UAstroContextEffectsLibrary::LoadEffects()
@@ -47,6 +72,8 @@ void UAstroContextEffectsLibrary::LoadEffects()
 
 		// Clear out any old Active Effects
 		ActiveContextEffects.Empty();
+		ActiveContextEffectIndicesByTag.Empty();
+		CachedQueryResults.Empty();
 
 		// Call internal loading function
 		LoadEffectsInternal();
@@ -59,18 +86,60 @@ EContextEffectsLibraryLoadState UAstroContextEffectsLibrary::GetContextEffectsLi
 	return EffectsLoadState;
 }
 
+void UAstroContextEffectsLibrary::GetAllNiagaraSystems(TArray<UNiagaraSystem*>& OutNiagaraSystems) const
+{
+	for (const UAstroActiveContextEffects* ActiveContextEffect : ActiveContextEffects)
+	{
+		for (UNiagaraSystem* NiagaraSystem : ActiveContextEffect->NiagaraSystems)
+		{
+			OutNiagaraSystems.AddUnique(NiagaraSystem);
+		}
+	}
+}
+
 void UAstroContextEffectsLibrary::LoadEffectsInternal()
 {
-	// TODO Add Async Loading for Libraries
+	// Gathers all effects, so that they can be streamed in a single request
+	TArray<FSoftObjectPath> EffectPaths;
+	for (const FAstroContextEffects& ContextEffect : ContextEffects)
+	{
+		if (ContextEffect.EffectTag.IsValid() && ContextEffect.Context.IsValid())
+		{
+			for (const FSoftObjectPath& Effect : ContextEffect.Effects)
+			{
+				if (!Effect.IsNull())
+				{
+					EffectPaths.AddUnique(Effect);
+				}
+			}
+		}
+	}
+
+	if (EffectPaths.IsEmpty())
+	{
+		OnEffectsStreamed();
+		return;
+	}
+
+	// NOTE: If every effect is already in memory, the delegate is called right away.
+	EffectsStreamableHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		MoveTemp(EffectPaths),
+		FStreamableDelegate::CreateUObject(this, &UAstroContextEffectsLibrary::OnEffectsStreamed));
+}
 
-	// Copy data for async load
-	TArray<FAstroContextEffects> LocalContextEffects = ContextEffects;
+void UAstroContextEffectsLibrary::OnEffectsStreamed()
+{
+	// The library may have been reloaded while this request was in flight
+	if (EffectsLoadState != EContextEffectsLibraryLoadState::Loading)
+	{
+		return;
+	}
 
 	// Prepare Active Context Effects Array
 	TArray<UAstroActiveContextEffects*> ActiveContextEffectsArray;
 
 	// Loop through Context Effects
-	for (const FAstroContextEffects& ContextEffect : LocalContextEffects)
+	for (const FAstroContextEffects& ContextEffect : ContextEffects)
 	{
 		// Make sure Tags are Valid
 		if (ContextEffect.EffectTag.IsValid() && ContextEffect.Context.IsValid())
@@ -82,24 +151,18 @@ void UAstroContextEffectsLibrary::LoadEffectsInternal()
 			NewActiveContextEffects->EffectTag = ContextEffect.EffectTag;
 			NewActiveContextEffects->Context = ContextEffect.Context;
 
-			// Try to load and add Effects to New Active Context Effects
+			// Add streamed Effects to New Active Context Effects
 			for (const FSoftObjectPath& Effect : ContextEffect.Effects)
 			{
-				if (UObject* Object = Effect.TryLoad())
+				if (UObject* Object = Effect.ResolveObject())
 				{
-					if (Object->IsA(USoundBase::StaticClass()))
+					if (USoundBase* SoundBase = Cast<USoundBase>(Object))
 					{
-						if (USoundBase* SoundBase = Cast<USoundBase>(Object))
-						{
-							NewActiveContextEffects->Sounds.Add(SoundBase);
-						}
+						NewActiveContextEffects->Sounds.Add(SoundBase);
 					}
-					else if (Object->IsA(UNiagaraSystem::StaticClass()))
+					else if (UNiagaraSystem* NiagaraSystem = Cast<UNiagaraSystem>(Object))
 					{
-						if (UNiagaraSystem* NiagaraSystem = Cast<UNiagaraSystem>(Object))
-						{
-							NewActiveContextEffects->NiagaraSystems.Add(NiagaraSystem);
-						}
+						NewActiveContextEffects->NiagaraSystems.Add(NiagaraSystem);
 					}
 				}
 			}
@@ -109,7 +172,6 @@ void UAstroContextEffectsLibrary::LoadEffectsInternal()
 		}
 	}
 
-	// TODO Call Load Complete after Async Load
 	// Mark loading complete
 	AstroContextEffectLibraryLoadingComplete(ActiveContextEffectsArray);
 }
@@ -122,5 +184,23 @@ void UAstroContextEffectsLibrary::AstroContextEffectLibraryLoadingComplete(
 
 	// Append incoming Context Effects Array to current list of Active Context Effects
 	ActiveContextEffects.Append(AstroActiveContextEffects);
+
+	BuildEffectTagIndices();
+
+	OnEffectsLoaded.Broadcast(this);
+}
+
+void UAstroContextEffectsLibrary::BuildEffectTagIndices()
+{
+	ActiveContextEffectIndicesByTag.Reset();
+	CachedQueryResults.Reset();
+
+	for (int32 ActiveContextEffectIndex = 0; ActiveContextEffectIndex < ActiveContextEffects.Num(); ActiveContextEffectIndex++)
+	{
+		if (const UAstroActiveContextEffects* ActiveContextEffect = ActiveContextEffects[ActiveContextEffectIndex])
+		{
+			ActiveContextEffectIndicesByTag.FindOrAdd(ActiveContextEffect->EffectTag).Add(ActiveContextEffectIndex);
+		}
+	}
 }
 
@@ -12,7 +12,11 @@
 
 #include "AstroContextEffectsLibrary.h"
 #include "AstroContextEffectsSubsystem.h"
+#include "Components/SceneComponent.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
 #include "Kismet/GameplayStatics.h"
+#include "NiagaraComponent.h"
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraSystem.h"
 
@@ -24,75 +28,115 @@ class UNiagaraSystem;
 class USceneComponent;
 class USoundBase;
 
+void UAstroContextEffectsSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const UAstroContextEffectsSettings* ProjectSettings = GetDefault<UAstroContextEffectsSettings>();
+	if (!ProjectSettings || ProjectSettings->PreloadedLibraries.IsEmpty())
+	{
+		return;
+	}
+
+	// Streams all preloaded libraries in a single request
+	TArray<FSoftObjectPath> LibraryPaths;
+	for (const TSoftObjectPtr<UAstroContextEffectsLibrary>& PreloadedLibrary : ProjectSettings->PreloadedLibraries)
+	{
+		if (!PreloadedLibrary.IsNull())
+		{
+			LibraryPaths.AddUnique(PreloadedLibrary.ToSoftObjectPath());
+		}
+	}
+
+	UAssetManager::GetStreamableManager().RequestAsyncLoad(LibraryPaths, FStreamableDelegate::CreateWeakLambda(this, [this, LibraryPaths]()
+	{
+		for (const FSoftObjectPath& LibraryPath : LibraryPaths)
+		{
+			if (UAstroContextEffectsLibrary* EffectsLibrary = Cast<UAstroContextEffectsLibrary>(LibraryPath.ResolveObject()))
+			{
+				PreloadedLibraries.AddUnique(EffectsLibrary);
+				AddLibraryToSet(EffectsLibrary, nullptr);
+			}
+		}
+	}));
+}
+
 void UAstroContextEffectsSubsystem::SpawnContextEffects(AActor* SpawnInstigator, const FAstroContextEffectsParameters& ContextEffectsParameters, OUT TArray<UAudioComponent*>& OutAudios, OUT TArray<UNiagaraComponent*>& OutNiagaraEffects)
 {
 	// First determine if this Actor has a matching Set of Libraries
-	if (TObjectPtr<UAstroContextEffectsSet>* EffectsLibrariesSetPtr = ActiveActorEffectsMap.Find(SpawnInstigator))
+	TObjectPtr<UAstroContextEffectsSet>* EffectsLibrariesSetPtr = ActiveActorEffectsMap.Find(SpawnInstigator);
+	UAstroContextEffectsSet* EffectsLibraries = EffectsLibrariesSetPtr ? EffectsLibrariesSetPtr->Get() : nullptr;
+	if (!EffectsLibraries)
 	{
-		// Validate the pointers from the Map Find
-		if (UAstroContextEffectsSet* EffectsLibraries = *EffectsLibrariesSetPtr)
+		return;
+	}
+
+	// Cycle through Effect Libraries
+	for (UAstroContextEffectsLibrary* EffectLibrary : EffectsLibraries->AstroContextEffectsLibraries)
+	{
+		if (!EffectLibrary)
 		{
-			// Prepare Arrays for Sounds and Niagara Systems
-			TArray<USoundBase*> TotalSounds;
-			TArray<UNiagaraSystem*> TotalNiagaraSystems;
+			continue;
+		}
 
-			// Cycle through Effect Libraries
-			for (UAstroContextEffectsLibrary* EffectLibrary : EffectsLibraries->AstroContextEffectsLibraries)
-			{
-				// Check if the Effect Library is valid and data Loaded
-				if (EffectLibrary && EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Loaded)
-				{
-					// Set up local list of Sounds and Niagara Systems
-					TArray<USoundBase*> Sounds;
-					TArray<UNiagaraSystem*> NiagaraSystems;
+		// Load effects if needed. They'll only be available once the library finishes loading.
+		if (EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Unloaded)
+		{
+			EffectLibrary->LoadEffects();
+			continue;
+		}
 
-					// Get Sounds and Niagara Systems
-					EffectLibrary->GetEffects(ContextEffectsParameters.MotionEffect, ContextEffectsParameters.Contexts, Sounds, NiagaraSystems);
+		// Get cached Sounds and Niagara Systems. This is null while the library is still loading.
+		const FAstroContextEffectsQueryResult* Effects = EffectLibrary->FindEffects(ContextEffectsParameters.MotionEffect, ContextEffectsParameters.Contexts);
+		if (!Effects)
+		{
+			continue;
+		}
 
-					// Append to accumulating array
-					TotalSounds.Append(Sounds);
-					TotalNiagaraSystems.Append(NiagaraSystems);
-				}
-				else if (EffectLibrary && EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Unloaded)
+		// Cycle through found Sounds
+		for (USoundBase* Sound : Effects->Sounds)
+		{
+			if (ShouldSpawnSoundDelegate.IsBound())
+			{
+				const FVector SoundLocation = ContextEffectsParameters.StaticMeshComponent
+					? ContextEffectsParameters.StaticMeshComponent->GetSocketTransform(ContextEffectsParameters.Bone).TransformPosition(ContextEffectsParameters.LocationOffset)
+					: ContextEffectsParameters.LocationOffset;
+				if (!ShouldSpawnSoundDelegate.Execute(Sound, SoundLocation))
 				{
-					// Else load effects
-					EffectLibrary->LoadEffects();
+					continue;
 				}
 			}
 
-			// Cycle through found Sounds
-			for (USoundBase* Sound : TotalSounds)
-			{
-				// Spawn Sounds Attached, add Audio Component to List of ACs
-				UAudioComponent* AudioComponent = UGameplayStatics::SpawnSoundAttached(Sound,
-					ContextEffectsParameters.StaticMeshComponent,
-					ContextEffectsParameters.Bone,
-					ContextEffectsParameters.LocationOffset,
-					ContextEffectsParameters.RotationOffset,
-					EAttachLocation::KeepRelativeOffset,
-					false, ContextEffectsParameters.AudioVolume, ContextEffectsParameters.AudioPitch,
-					0.0f, nullptr, nullptr, true);
-
-				OutAudios.Add(AudioComponent);
-			}
+			// Spawn Sounds Attached, add Audio Component to List of ACs
+			UAudioComponent* AudioComponent = UGameplayStatics::SpawnSoundAttached(Sound,
+				ContextEffectsParameters.StaticMeshComponent,
+				ContextEffectsParameters.Bone,
+				ContextEffectsParameters.LocationOffset,
+				ContextEffectsParameters.RotationOffset,
+				EAttachLocation::KeepRelativeOffset,
+				false, ContextEffectsParameters.AudioVolume, ContextEffectsParameters.AudioPitch,
+				0.0f, nullptr, nullptr, true);
 
-			// Cycle through found Niagara Systems
-			for (UNiagaraSystem* NiagaraSystem : TotalNiagaraSystems)
-			{
-				// Spawn Niagara Systems Attached, add Niagara Component to List of NCs
-				constexpr bool bAutoDestroy = true;
-				constexpr bool bAutoActivate = true;
-				constexpr bool bPreCullCheck = true;
-				UNiagaraComponent* NiagaraComponent = UNiagaraFunctionLibrary::SpawnSystemAttached(NiagaraSystem,
-					ContextEffectsParameters.StaticMeshComponent,
-					ContextEffectsParameters.Bone,
-					ContextEffectsParameters.LocationOffset,
-					ContextEffectsParameters.RotationOffset,
-					ContextEffectsParameters.VFXScale,
-					EAttachLocation::KeepRelativeOffset, bAutoDestroy, ENCPoolMethod::None, bAutoActivate, bPreCullCheck);
-
-				OutNiagaraEffects.Add(NiagaraComponent);
-			}
+			OutAudios.Add(AudioComponent);
+		}
+
+		// Cycle through found Niagara Systems
+		for (UNiagaraSystem* NiagaraSystem : Effects->NiagaraSystems)
+		{
+			// Spawn Niagara Systems Attached, add Niagara Component to List of NCs
+			// NOTE: Pooled components are returned to the pool once they complete, so they're never auto-destroyed.
+			constexpr bool bAutoDestroy = false;
+			constexpr bool bAutoActivate = true;
+			constexpr bool bPreCullCheck = true;
+			UNiagaraComponent* NiagaraComponent = UNiagaraFunctionLibrary::SpawnSystemAttached(NiagaraSystem,
+				ContextEffectsParameters.StaticMeshComponent,
+				ContextEffectsParameters.Bone,
+				ContextEffectsParameters.LocationOffset,
+				ContextEffectsParameters.RotationOffset,
+				ContextEffectsParameters.VFXScale,
+				EAttachLocation::KeepRelativeOffset, bAutoDestroy, ENCPoolMethod::AutoRelease, bAutoActivate, bPreCullCheck);
+
+			OutNiagaraEffects.Add(NiagaraComponent);
 		}
 	}
 }
@@ -127,22 +171,45 @@ void UAstroContextEffectsSubsystem::LoadAndAddContextEffectsLibraries(AActor* Ow
 	UAstroContextEffectsSet* EffectsLibrariesSet = NewObject<UAstroContextEffectsSet>(this);
 
 	// Cycle through Libraries getting Soft Obj Refs
+	TArray<FSoftObjectPath> UnloadedLibraryPaths;
 	for (const TSoftObjectPtr<UAstroContextEffectsLibrary>& ContextEffectSoftObj : ContextEffectsLibraries)
 	{
-		// Load Library Assets from Soft Obj refs
-		// TODO Support Async Loading of Asset Data
-		if (UAstroContextEffectsLibrary* EffectsLibrary = ContextEffectSoftObj.LoadSynchronous())
+		// Libraries that are already in memory (e.g., preloaded ones) are added right away
+		if (UAstroContextEffectsLibrary* EffectsLibrary = ContextEffectSoftObj.Get())
 		{
-			// Call load on valid Libraries
-			EffectsLibrary->LoadEffects();
-
-			// Add new library to Set
-			EffectsLibrariesSet->AstroContextEffectsLibraries.Add(EffectsLibrary);
+			AddLibraryToSet(EffectsLibrary, EffectsLibrariesSet);
+		}
+		else if (!ContextEffectSoftObj.IsNull())
+		{
+			UnloadedLibraryPaths.Add(ContextEffectSoftObj.ToSoftObjectPath());
 		}
 	}
 
 	// Update Active Actor Effects Map
 	ActiveActorEffectsMap.Emplace(OwningActor, EffectsLibrariesSet);
+
+	// Streams the remaining Libraries, and adds them to the Set once they're loaded
+	if (!UnloadedLibraryPaths.IsEmpty())
+	{
+		TWeakObjectPtr<UAstroContextEffectsSet> WeakEffectsLibrariesSet = EffectsLibrariesSet;
+		UAssetManager::GetStreamableManager().RequestAsyncLoad(UnloadedLibraryPaths, FStreamableDelegate::CreateWeakLambda(this, [this, WeakEffectsLibrariesSet, UnloadedLibraryPaths]()
+		{
+			// The actor may have unregistered its libraries while they were loading
+			UAstroContextEffectsSet* LoadedEffectsLibrariesSet = WeakEffectsLibrariesSet.Get();
+			if (!LoadedEffectsLibrariesSet)
+			{
+				return;
+			}
+
+			for (const FSoftObjectPath& LibraryPath : UnloadedLibraryPaths)
+			{
+				if (UAstroContextEffectsLibrary* EffectsLibrary = Cast<UAstroContextEffectsLibrary>(LibraryPath.ResolveObject()))
+				{
+					AddLibraryToSet(EffectsLibrary, LoadedEffectsLibrariesSet);
+				}
+			}
+		}));
+	}
 }
 
 void UAstroContextEffectsSubsystem::UnloadAndRemoveContextEffectsLibraries(AActor* OwningActor)
@@ -157,3 +224,80 @@ void UAstroContextEffectsSubsystem::UnloadAndRemoveContextEffectsLibraries(AActo
 	ActiveActorEffectsMap.Remove(OwningActor);
 }
 
+void UAstroContextEffectsSubsystem::AddLibraryToSet(UAstroContextEffectsLibrary* EffectsLibrary, UAstroContextEffectsSet* EffectsLibrariesSet)
+{
+	if (!EffectsLibrary)
+	{
+		return;
+	}
+
+	if (EffectsLibrariesSet)
+	{
+		EffectsLibrariesSet->AstroContextEffectsLibraries.Add(EffectsLibrary);
+	}
+
+	// Loads the Library's effects only once. Reloading would make the Library unavailable until the load finishes.
+	if (EffectsLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Loaded)
+	{
+		PrimeNiagaraPools(EffectsLibrary);
+		return;
+	}
+
+	if (!EffectsLibrary->OnEffectsLoaded.IsBoundToObject(this))
+	{
+		EffectsLibrary->OnEffectsLoaded.AddUObject(this, &UAstroContextEffectsSubsystem::OnLibraryEffectsLoaded);
+	}
+
+	if (EffectsLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Unloaded)
+	{
+		EffectsLibrary->LoadEffects();
+	}
+}
+
+void UAstroContextEffectsSubsystem::OnLibraryEffectsLoaded(UAstroContextEffectsLibrary* EffectsLibrary)
+{
+	if (EffectsLibrary)
+	{
+		EffectsLibrary->OnEffectsLoaded.RemoveAll(this);
+		PrimeNiagaraPools(EffectsLibrary);
+	}
+}
+
+void UAstroContextEffectsSubsystem::PrimeNiagaraPools(const UAstroContextEffectsLibrary* EffectsLibrary)
+{
+	UWorld* World = GetWorld();
+	const UAstroContextEffectsSettings* ProjectSettings = GetDefault<UAstroContextEffectsSettings>();
+	if (!EffectsLibrary || !World || !World->IsGameWorld() || !ProjectSettings)
+	{
+		return;
+	}
+
+	TArray<UNiagaraSystem*> NiagaraSystems;
+	EffectsLibrary->GetAllNiagaraSystems(NiagaraSystems);
+
+	for (UNiagaraSystem* NiagaraSystem : NiagaraSystems)
+	{
+		bool bIsAlreadyPrimed = false;
+		PrimedNiagaraSystems.Add(NiagaraSystem, &bIsAlreadyPrimed);
+		if (bIsAlreadyPrimed)
+		{
+			continue;
+		}
+
+		const int32* PoolPrimeSizeOverride = ProjectSettings->NiagaraPoolPrimeSizes.Find(TSoftObjectPtr<UNiagaraSystem>(NiagaraSystem));
+		const int32 PoolPrimeSize = PoolPrimeSizeOverride ? *PoolPrimeSizeOverride : ProjectSettings->DefaultNiagaraPoolPrimeSize;
+
+		// Creates inactive components and hands them to the world's pool, so that the first spawns don't have to create them
+		for (int32 PrimedComponentIndex = 0; PrimedComponentIndex < PoolPrimeSize; PrimedComponentIndex++)
+		{
+			constexpr bool bAutoDestroy = false;
+			constexpr bool bAutoActivate = false;
+			constexpr bool bPreCullCheck = false;
+			if (UNiagaraComponent* NiagaraComponent = UNiagaraFunctionLibrary::SpawnSystemAtLocation(World, NiagaraSystem, FVector::ZeroVector, FRotator::ZeroRotator,
+				FVector::OneVector, bAutoDestroy, bAutoActivate, ENCPoolMethod::ManualRelease, bPreCullCheck))
+			{
+				NiagaraComponent->ReleaseToPool();
+			}
+		}
+	}
+}
@@ -16,9 +16,11 @@
 #include "UObject/WeakObjectPtr.h"
 #include "AstroContextEffectsLibrary.generated.h"
 
+class UAstroContextEffectsLibrary;
 class UNiagaraSystem;
 class USoundBase;
 struct FFrame;
+struct FStreamableHandle;
 
 
 UENUM()
@@ -67,6 +69,42 @@ public:
 };
 
 DECLARE_DYNAMIC_DELEGATE_OneParam(FAstroContextEffectLibraryLoadingComplete, TArray<UAstroActiveContextEffects*>, AstroActiveContextEffects);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnAstroContextEffectsLibraryLoaded, UAstroContextEffectsLibrary*);
+
+
+/** Key used to cache the effects that match an (effect tag, context tags) query. */
+struct FAstroContextEffectsQueryKey
+{
+	FGameplayTag Effect;
+	FGameplayTagContainer Context;
+
+	bool operator==(const FAstroContextEffectsQueryKey& Other) const
+	{
+		return Effect == Other.Effect && Context.Num() == Other.Context.Num() && Context.HasAllExact(Other.Context);
+	}
+
+	friend uint32 GetTypeHash(const FAstroContextEffectsQueryKey& Key)
+	{
+		// NOTE: Tags are combined in an order-independent way, as the equality above doesn't depend on the tag order either.
+		uint32 ContextHash = 0;
+		for (const FGameplayTag& ContextTag : Key.Context)
+		{
+			ContextHash ^= GetTypeHash(ContextTag);
+		}
+		return HashCombineFast(GetTypeHash(Key.Effect), ContextHash);
+	}
+};
+
+
+/**
+* Effects that match a given query. These are resolved once and reused by every following query.
+* NOTE: The assets are kept alive by the library's ActiveContextEffects, so these don't need to be visible to the GC.
+*/
+struct FAstroContextEffectsQueryResult
+{
+	TArray<USoundBase*> Sounds;
+	TArray<UNiagaraSystem*> NiagaraSystems;
+};
 
 
 UCLASS(BlueprintType)
@@ -82,19 +120,42 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void GetEffects(const FGameplayTag Effect, const FGameplayTagContainer Context, TArray<USoundBase*>& Sounds, TArray<UNiagaraSystem*>& NiagaraSystems);
 
+	/** @return Cached effects that match the given effect and context, or nullptr if there are none. Results are computed on first use and reused afterwards. */
+	const FAstroContextEffectsQueryResult* FindEffects(const FGameplayTag& Effect, const FGameplayTagContainer& Context) const;
+
+	/** Starts loading all effects asynchronously. Queries return no effects until the load finishes. */
 	UFUNCTION(BlueprintCallable)
 	void LoadEffects();
 
 	EContextEffectsLibraryLoadState GetContextEffectsLibraryLoadState();
 
+	/** @return All Niagara systems referenced by this library. Only valid after the library is loaded. */
+	void GetAllNiagaraSystems(TArray<UNiagaraSystem*>& OutNiagaraSystems) const;
+
+	/** Called once the library finishes loading its effects. */
+	FOnAstroContextEffectsLibraryLoaded OnEffectsLoaded;
+
 private:
 	void LoadEffectsInternal();
 
+	void OnEffectsStreamed();
+
 	void AstroContextEffectLibraryLoadingComplete(TArray<UAstroActiveContextEffects*> AstroActiveContextEffects);
 
+	void BuildEffectTagIndices();
+
 	UPROPERTY(Transient)
 	TArray<TObjectPtr<UAstroActiveContextEffects>> ActiveContextEffects;
 
 	UPROPERTY(Transient)
 	EContextEffectsLibraryLoadState EffectsLoadState = EContextEffectsLibraryLoadState::Unloaded;
+
+	/** Keeps the effect assets loaded while the library is loading them. */
+	TSharedPtr<FStreamableHandle> EffectsStreamableHandle;
+
+	/** Maps each effect tag to the indices of the ActiveContextEffects that use it, so that queries don't have to scan the whole library. */
+	TMap<FGameplayTag, TArray<int32>> ActiveContextEffectIndicesByTag;
+
+	/** Cached query results. Cleared whenever the library is (re)loaded. */
+	mutable TMap<FAstroContextEffectsQueryKey, FAstroContextEffectsQueryResult> CachedQueryResults;
 };
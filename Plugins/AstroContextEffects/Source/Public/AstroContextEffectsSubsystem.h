@@ -21,12 +21,16 @@ class AActor;
 class UAudioComponent;
 class UAstroContextEffectsLibrary;
 class UNiagaraComponent;
+class UNiagaraSystem;
 class USceneComponent;
+class USoundBase;
 struct FFrame;
 struct FGameplayTag;
 struct FGameplayTagContainer;
 struct FAstroContextEffectsParameters;
 
+/** @return false if a context effect sound shouldn't be spawned at a given location (e.g., because the same sound was just played close to it). */
+DECLARE_DELEGATE_RetVal_TwoParams(bool, FAstroContextEffectsShouldSpawnSound, const USoundBase* /*Sound*/, const FVector& /*Location*/);
 
 UCLASS(config = Game, defaultconfig, meta = (DisplayName = "AstroContextEffects"))
 class UAstroContextEffectsSettings : public UDeveloperSettings
@@ -36,6 +40,21 @@ class UAstroContextEffectsSettings : public UDeveloperSettings
 public:
 	UPROPERTY(config, EditAnywhere)
 	TMap<TEnumAsByte<EPhysicalSurface>, FGameplayTag> SurfaceTypeToContextMap;
+
+	/** Libraries that are loaded asynchronously as soon as the world begins play, so that their effects are ready before the first notify. */
+	UPROPERTY(config, EditAnywhere)
+	TArray<TSoftObjectPtr<UAstroContextEffectsLibrary>> PreloadedLibraries;
+
+	/**
+	* How many pooled components are created for each Niagara system once its library is loaded.
+	* NOTE: The pool never grows beyond the system's MaxPoolSize, so that's still the upper bound.
+	*/
+	UPROPERTY(config, EditAnywhere, meta = (ClampMin = 0))
+	TMap<TSoftObjectPtr<UNiagaraSystem>, int32> NiagaraPoolPrimeSizes;
+
+	/** Pool prime size used by Niagara systems that don't have an entry in NiagaraPoolPrimeSizes. */
+	UPROPERTY(config, EditAnywhere, meta = (ClampMin = 0))
+	int32 DefaultNiagaraPoolPrimeSize = 2;
 };
 
 
@@ -50,12 +69,20 @@ public:
 };
 
 
-UCLASS()
+UCLASS(MinimalAPI)
 class UAstroContextEffectsSubsystem : public UWorldSubsystem
 {
 	GENERATED_BODY()
 
 public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+public:
+	/**
+	* Spawns all effects that match the given parameters, for the libraries registered by SpawnInstigator.
+	* Sounds rejected by ShouldSpawnSoundDelegate are skipped, so OutAudios may miss some of them.
+	* NOTE: Niagara components are pooled and released automatically once they finish, so they shouldn't be kept around by the caller.
+	*/
 	UFUNCTION(BlueprintCallable, Category = "ContextEffects")
 	void SpawnContextEffects(AActor* SpawnInstigator, const FAstroContextEffectsParameters& ContextEffectsParameters, TArray<UAudioComponent*>& OutAudios, TArray<UNiagaraComponent*>& OutNiagaraEffects);
 
@@ -68,8 +95,24 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "ContextEffects")
 	void UnloadAndRemoveContextEffectsLibraries(AActor* OwningActor);
 
+	/** Lets the game budget context effect sounds. Every sound is spawned while this is unbound. */
+	FAstroContextEffectsShouldSpawnSound ShouldSpawnSoundDelegate;
+
+private:
+	void AddLibraryToSet(UAstroContextEffectsLibrary* EffectsLibrary, UAstroContextEffectsSet* EffectsLibrariesSet);
+	void OnLibraryEffectsLoaded(UAstroContextEffectsLibrary* EffectsLibrary);
+	void PrimeNiagaraPools(const UAstroContextEffectsLibrary* EffectsLibrary);
+
 private:
 	UPROPERTY(Transient)
 	TMap<TObjectPtr<AActor>, TObjectPtr<UAstroContextEffectsSet>> ActiveActorEffectsMap;
 
+	/** Libraries from UAstroContextEffectsSettings::PreloadedLibraries. Kept alive for the whole world lifetime. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAstroContextEffectsLibrary>> PreloadedLibraries;
+
+	/** Niagara systems whose pools were already primed in this world. */
+	UPROPERTY(Transient)
+	TSet<TObjectPtr<UNiagaraSystem>> PrimedNiagaraSystems;
+
 };
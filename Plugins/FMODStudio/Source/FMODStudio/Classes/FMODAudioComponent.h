@@ -140,6 +140,7 @@ class FMODSTUDIO_API UFMODAudioComponent : public USceneComponent
 
     friend struct FFMODEventControlExecutionToken;
     friend struct FPlayingToken;
+    friend class FFMODOcclusionScheduler;
     friend FMOD_RESULT F_CALLBACK UFMODAudioComponent_EventCallback(FMOD_STUDIO_EVENT_CALLBACK_TYPE type, FMOD_STUDIO_EVENTINSTANCE *event, void *parameters);
 
 public:
@@ -354,9 +355,18 @@ private:
     /** Update gain and low-pass based on interior volumes. */
     void UpdateInteriorVolumes();
 
-    /** Update attenuation if we have it set. */
+    /** Update attenuation if we have it set. Occlusion is traced separately, by the occlusion scheduler. */
     void UpdateAttenuation();
 
+    /** Set the occlusion value the parameter should move towards. Called by the occlusion scheduler with its latest trace result. */
+    void SetOcclusionTarget(float Target, bool bSnap);
+
+    /** Move the occlusion parameter towards its target, at InterpSpeed units per second. */
+    void UpdateOcclusion(float DeltaTime, float InterpSpeed);
+
+    /** Reset the occlusion parameter to unoccluded, and invalidate the value last applied to the Event. */
+    void ResetOcclusion();
+
     /** Apply Volume and LPF into event. */
     void ApplyVolumeLPF();
 
@@ -427,8 +437,12 @@ private:
     float LastVolume;
     /** Previously set LPF value. Used for automating volume and/or LPF with Ambient Zones. */
     float LastLPF;
-    /** Was the object occluded in the previous frame. */
-    bool wasOccluded;
+    /** Latest occlusion value traced by the occlusion scheduler. */
+    float OcclusionTarget;
+    /** Interpolated occlusion value. Used so that staggered occlusion traces don't cause audible steps. */
+    float OcclusionCurrent;
+    /** Previously set occlusion value. */
+    float LastOcclusion;
     /** Stored ID of the Occlusion parameter of the Event (if applicable). */
     FMOD_STUDIO_PARAMETER_ID OcclusionID;
     /** Stored ID of the Volume parameter of the Event (if applicable). */
@@ -308,6 +308,13 @@ public:
     UPROPERTY(config, EditAnywhere, Category = InitSettings)
     int32 FileBufferSize;
 
+    /**
+     * Size in bytes of the per-file read-ahead buffer (65536 by default), or 0 to disable read-ahead.
+     * Reads smaller than this are served from a buffer that is refilled from disk, which mostly benefits streaming banks.
+     */
+    UPROPERTY(config, EditAnywhere, Category = InitSettings)
+    int32 FileReadAheadSize;
+
     /**
      * Studio update period in milliseconds, or 0 for default (which means 20ms).
      */
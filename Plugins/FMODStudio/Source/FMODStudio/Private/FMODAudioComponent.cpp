@@ -5,6 +5,7 @@
 #include "FMODUtils.h"
 #include "FMODEvent.h"
 #include "FMODListener.h"
+#include "FMODOcclusionScheduler.h"
 #include "FMODSettings.h"
 #include "fmod_studio.hpp"
 #include "Misc/App.h"
@@ -36,7 +37,9 @@ UFMODAudioComponent::UFMODAudioComponent(const FObjectInitializer &ObjectInitial
     , AmbientLPF(0.0f)
     , LastVolume(1.0f)
     , LastLPF(MAX_FILTER_FREQUENCY)
-    , wasOccluded(false)
+    , OcclusionTarget(0.0f)
+    , OcclusionCurrent(0.0f)
+    , LastOcclusion(-1.0f)
     , OcclusionID()
     , AmbientVolumeID()
     , AmbientLPFID()
@@ -261,40 +264,46 @@ void UFMODAudioComponent::UpdateAttenuation()
     if (!GetOwner())
         return; // May not have owner when previewing animations
 
-    if (!AttenuationDetails.bOverrideAttenuation && !OcclusionDetails.bEnableOcclusion)
-    {
-        return;
-    }
-
     if (AttenuationDetails.bOverrideAttenuation)
     {
         SetProperty(EFMODEventProperty::MinimumDistance, AttenuationDetails.MinimumDistance);
         SetProperty(EFMODEventProperty::MaximumDistance, AttenuationDetails.MaximumDistance);
     }
 
-    // Use occlusion part of settings
-    if (OcclusionDetails.bEnableOcclusion && bApplyOcclusionParameter)
-    {
-        static FName NAME_SoundOcclusion = FName(TEXT("SoundOcclusion"));
-        FCollisionQueryParams Params(NAME_SoundOcclusion, OcclusionDetails.bUseComplexCollisionForOcclusion, GetOwner());
-
-        const FVector &Location = GetComponentLocation();
-        const FFMODListener &Listener = GetStudioModule().GetNearestListener(Location);
+    // Occlusion is traced by FFMODOcclusionScheduler, under a per-frame budget, instead of once per component per update
+}
 
-        bool bIsOccluded = GWorld->LineTraceTestByChannel(Location, Listener.Transform.GetLocation(), OcclusionDetails.OcclusionTraceChannel, Params);
+void UFMODAudioComponent::SetOcclusionTarget(float Target, bool bSnap)
+{
+    OcclusionTarget = Target;
+    if (bSnap)
+    {
+        OcclusionCurrent = Target;
+    }
+}
 
-        if (bIsOccluded != wasOccluded)
-        {
-            StudioInstance->setParameterByID(OcclusionID, bIsOccluded ? 1.0f : 0.0f);
-            wasOccluded = bIsOccluded;
-        }
+void UFMODAudioComponent::UpdateOcclusion(float DeltaTime, float InterpSpeed)
+{
+    if (!StudioInstance || !bApplyOcclusionParameter)
+    {
+        return;
     }
-    else
+
+    OcclusionCurrent = FMath::FInterpConstantTo(OcclusionCurrent, OcclusionTarget, DeltaTime, InterpSpeed);
+    if (OcclusionCurrent != LastOcclusion)
     {
-        wasOccluded = false;
+        StudioInstance->setParameterByID(OcclusionID, OcclusionCurrent);
+        LastOcclusion = OcclusionCurrent;
     }
 }
 
+void UFMODAudioComponent::ResetOcclusion()
+{
+    OcclusionTarget = 0.0f;
+    OcclusionCurrent = 0.0f;
+    LastOcclusion = -1.0f;
+}
+
 void UFMODAudioComponent::ApplyVolumeLPF()
 {
     if (bApplyAmbientVolumes)
@@ -766,6 +775,11 @@ void UFMODAudioComponent::PlayInternal(EFMODSystemContext::Type Context, bool bR
                 bApplyOcclusionParameter = true;
             }
         }
+        // NOTE: Only components that have occlusion enabled when their event starts are traced
+        if (bApplyOcclusionParameter && OcclusionDetails.bEnableOcclusion)
+        {
+            FFMODOcclusionScheduler::Get().Register(this);
+        }
 
         paramDesc = {};
         param = Settings.AmbientVolumeParameter;
@@ -868,7 +882,7 @@ void UFMODAudioComponent::Stop()
         StudioInstance->stop(FMOD_STUDIO_STOP_ALLOWFADEOUT);
     }
 
-    wasOccluded = false;
+    ResetOcclusion();
 }
 
 void UFMODAudioComponent::Release()
@@ -909,6 +923,8 @@ void UFMODAudioComponent::ReleaseEventInstance()
         StudioInstance->release();
         StudioInstance = nullptr;
     }
+
+    FFMODOcclusionScheduler::Get().Unregister(this);
 }
 
 void UFMODAudioComponent::KeyOff()
@@ -5,9 +5,13 @@
 #include "FMODUtils.h"
 #include "HAL/FileManager.h"
 #include "GenericPlatform/GenericPlatformProcess.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformTLS.h"
 #include "HAL/Runnable.h"
 #include "HAL/RunnableThread.h"
 #include "Misc/ScopeLock.h"
+#include <atomic>
 #include "FMODStudioPrivatePCH.h"
 
 FMOD_RESULT F_CALLBACK FMODLogCallback(FMOD_DEBUG_FLAGS flags, const char *file, int line, const char *func, const char *message)
@@ -59,24 +63,37 @@ FMOD_RESULT F_CALLBACK FMODErrorCallback(FMOD_SYSTEM *system, FMOD_SYSTEM_CALLBA
     return FMOD_OK;
 }
 
-class FFMODFileSystem : public FRunnable
+namespace FMODFileSystemStatics
+{
+    // Upper bounds (in microseconds) of each callback latency bucket. The last bucket holds everything above the last bound.
+    static const double LatencyBucketBoundsUs[FFMODFileSystemStats::LatencyBucketCount - 1] = { 50.0, 250.0, 1000.0, 5000.0, 20000.0 };
+}
+
+// Per-handle state. Every handle owns its archive and read-ahead buffer, so callbacks on different handles never share state.
+struct FFMODFileHandle
+{
+    FArchive *mArchive = nullptr;
+    int64 mSize = 0;
+
+    // Position as seen by FMOD. The archive is only seeked lazily, right before it's actually read from.
+    int64 mPosition = 0;
+
+    TArray<uint8> mReadAheadBuffer;
+    int64 mReadAheadStart = 0;
+    int64 mReadAheadLength = 0;
+};
+
+// NOTE: FMOD may call these callbacks from several of its threads at once (e.g. the stream thread, the bank loading thread, and
+// the nonblocking loader). Handles are split into a small pool of stripes, so that only callbacks on handles that hash to the
+// same stripe ever contend, instead of every callback serializing through a single lock.
+// IFileManager and FArchive are never used from FMOD's own threads: every stripe owns a UE thread that runs the archive I/O of its
+// handles, and the FMOD thread waits for it to complete. Seeks only move the logical position, so they don't need the I/O thread.
+class FFMODFileSystem
 {
 public:
     FFMODFileSystem()
-        : mHandleIn(nullptr)
-        , mName(nullptr)
-        , mFileSize(nullptr)
-        , mHandleOut(nullptr)
-        , mBuffer(nullptr)
-        , mSizeBytes(0)
-        , mBytesRead(nullptr)
-        , mSeekPosition(0)
-        , mCommand(COMMAND_MAX)
-        , mResult(FMOD_OK)
-        , mReferenceCount(0)
-        , mThread(nullptr)
-        , mCommandReadyEvent(nullptr)
-        , mCommandCompleteEvent(nullptr)
+        : mReferenceCount(0)
+        , mReadAheadSize(0)
     {
     }
 
@@ -98,11 +115,10 @@ public:
 
         if (mReferenceCount == 1)
         {
-            check(!mThread);
-
-            mCommandReadyEvent = FGenericPlatformProcess::GetSynchEventFromPool();
-            mCommandCompleteEvent = FGenericPlatformProcess::GetSynchEventFromPool();
-            mThread = FRunnableThread::Create(this, TEXT("FMOD File Access Coordinator"));
+            for (int32 i = 0; i < StripeCount; ++i)
+            {
+                mStripes[i].Start(i);
+            }
         }
     }
 
@@ -111,124 +127,302 @@ public:
         FScopeLock lock(&mCrit);
 
         check(mReferenceCount > 0);
-        check(mThread);
 
         --mReferenceCount;
 
         if (mReferenceCount == 0)
         {
-            verifyfmod(RunCommand(COMMAND_STOP));
-            mThread->WaitForCompletion();
-
-            FGenericPlatformProcess::ReturnSynchEventToPool(mCommandReadyEvent);
-            mCommandReadyEvent = nullptr;
-            FGenericPlatformProcess::ReturnSynchEventToPool(mCommandCompleteEvent);
-            mCommandCompleteEvent = nullptr;
-            delete mThread;
-            mThread = nullptr;
+            for (int32 i = 0; i < StripeCount; ++i)
+            {
+                mStripes[i].Stop();
+            }
         }
     }
 
-    void Attach(FMOD::System *system, int32 fileBufferSize)
+    void Attach(FMOD::System *system, int32 fileBufferSize, int32 readAheadSize)
     {
-        check(mThread);
+        check(mReferenceCount > 0);
 
+        mReadAheadSize = FMath::Max(readAheadSize, 0);
         verifyfmod(system->setFileSystem(OpenCallback, CloseCallback, ReadCallback, SeekCallback, 0, 0, fileBufferSize));
     }
 
-    uint32 Run() override
+    void GetStats(FFMODFileSystemStats &stats) const
     {
-        bool stopRequested = false;
-
-        while (!stopRequested)
+        stats.OpenCount = mOpenCount.load(std::memory_order_relaxed);
+        stats.ReadCount = mReadCount.load(std::memory_order_relaxed);
+        stats.BytesRequested = mBytesRequested.load(std::memory_order_relaxed);
+        stats.BytesReadFromDisk = mBytesReadFromDisk.load(std::memory_order_relaxed);
+        stats.ReadAheadHits = mReadAheadHits.load(std::memory_order_relaxed);
+        stats.LockWaitSeconds = FPlatformTime::ToSeconds64(mLockWaitCycles.load(std::memory_order_relaxed));
+        stats.UpdateThreadCallbackCount = mUpdateThreadCallbackCount.load(std::memory_order_relaxed);
+        stats.StudioUpdateCount = mStudioUpdateCount.load(std::memory_order_relaxed);
+        stats.MaxStudioUpdateSeconds = FPlatformTime::ToSeconds64(mMaxStudioUpdateCycles.load(std::memory_order_relaxed));
+        for (int32 i = 0; i < FFMODFileSystemStats::LatencyBucketCount; ++i)
         {
-            mCommandReadyEvent->Wait();
-
-            switch (mCommand)
-            {
-                case COMMAND_OPEN:
-                    mResult = OpenInternal(mName, mFileSize, mHandleOut);
-                    break;
-                case COMMAND_CLOSE:
-                    mResult = CloseInternal(mHandleIn);
-                    break;
-                case COMMAND_READ:
-                    mResult = ReadInternal(mHandleIn, mBuffer, mSizeBytes, mBytesRead);
-                    break;
-                case COMMAND_SEEK:
-                    mResult = SeekInternal(mHandleIn, mSeekPosition);
-                    break;
-                case COMMAND_STOP:
-                    stopRequested = true;
-                    mResult = FMOD_OK;
-                    break;
-            }
+            stats.CallbackLatencyHistogram[i] = mLatencyHistogram[i].load(std::memory_order_relaxed);
+        }
+    }
 
-            mCommandCompleteEvent->Trigger();
+    void ResetStats()
+    {
+        mOpenCount.store(0, std::memory_order_relaxed);
+        mReadCount.store(0, std::memory_order_relaxed);
+        mBytesRequested.store(0, std::memory_order_relaxed);
+        mBytesReadFromDisk.store(0, std::memory_order_relaxed);
+        mReadAheadHits.store(0, std::memory_order_relaxed);
+        mLockWaitCycles.store(0, std::memory_order_relaxed);
+        mUpdateThreadCallbackCount.store(0, std::memory_order_relaxed);
+        mStudioUpdateCount.store(0, std::memory_order_relaxed);
+        mMaxStudioUpdateCycles.store(0, std::memory_order_relaxed);
+        for (int32 i = 0; i < FFMODFileSystemStats::LatencyBucketCount; ++i)
+        {
+            mLatencyHistogram[i].store(0, std::memory_order_relaxed);
         }
+    }
 
-        return 0;
+    void AttachStudioUpdateProbe(FMOD::Studio::System *system)
+    {
+        verifyfmod(system->setCallback(StudioUpdateCallback, FMOD_STUDIO_SYSTEM_CALLBACK_PREUPDATE | FMOD_STUDIO_SYSTEM_CALLBACK_POSTUPDATE));
     }
 
 private:
+    // Every stripe owns a thread, so this is kept small. Streams and banks rarely have more than a few handles open at once.
+    static constexpr int32 StripeCount = 4;
+
     enum Command
     {
         COMMAND_OPEN,
         COMMAND_CLOSE,
         COMMAND_READ,
-        COMMAND_SEEK,
         COMMAND_STOP,
         COMMAND_MAX,
     };
 
-    FMOD_RESULT RunCommand(Command command)
+    // The lock and I/O thread shared by every handle that hashes to it. The command parameters are guarded by mLock,
+    // which callbacks hold until the command completes.
+    class FStripe : public FRunnable
     {
-        check(mThread);
+    public:
+        void Start(int32 index)
+        {
+            check(!mThread);
+
+            mCommandReadyEvent = FGenericPlatformProcess::GetSynchEventFromPool();
+            mCommandCompleteEvent = FGenericPlatformProcess::GetSynchEventFromPool();
+            mThread = FRunnableThread::Create(this, *FString::Printf(TEXT("FMOD File Access %d"), index));
+        }
+
+        void Stop()
+        {
+            FScopeLock lock(&mLock);
+
+            check(mThread);
+
+            verifyfmod(RunCommand(COMMAND_STOP));
+            mThread->WaitForCompletion();
+
+            FGenericPlatformProcess::ReturnSynchEventToPool(mCommandReadyEvent);
+            mCommandReadyEvent = nullptr;
+            FGenericPlatformProcess::ReturnSynchEventToPool(mCommandCompleteEvent);
+            mCommandCompleteEvent = nullptr;
+            delete mThread;
+            mThread = nullptr;
+        }
+
+        uint32 Run() override
+        {
+            bool stopRequested = false;
+
+            while (!stopRequested)
+            {
+                mCommandReadyEvent->Wait();
+
+                switch (mCommand)
+                {
+                    case COMMAND_OPEN:
+                        mResult = OpenInternal(mName, mFileSize, mHandleOut);
+                        break;
+                    case COMMAND_CLOSE:
+                        mResult = CloseInternal(mHandleIn);
+                        break;
+                    case COMMAND_READ:
+                        mResult = ReadInternal(mHandleIn, mBuffer, mSizeBytes, mBytesRead);
+                        break;
+                    case COMMAND_STOP:
+                        stopRequested = true;
+                        mResult = FMOD_OK;
+                        break;
+                    default:
+                        mResult = FMOD_ERR_INTERNAL;
+                        break;
+                }
+
+                mCommandCompleteEvent->Trigger();
+            }
+
+            return 0;
+        }
+
+        // Must be called with mLock held
+        FMOD_RESULT RunCommand(Command command)
+        {
+            check(mThread);
+
+            mCommand = command;
+            mCommandReadyEvent->Trigger();
+            mCommandCompleteEvent->Wait();
 
-        mCommand = command;
-        mCommandReadyEvent->Trigger();
-        mCommandCompleteEvent->Wait();
+            return mResult;
+        }
+
+        FCriticalSection mLock;
+
+        // Parameter for Close and Read
+        void *mHandleIn = nullptr;
+
+        // Parameters for Open
+        const char *mName = nullptr;
+        unsigned int *mFileSize = nullptr;
+        void **mHandleOut = nullptr;
+
+        // Parameters for Read
+        void *mBuffer = nullptr;
+        unsigned int mSizeBytes = 0;
+        unsigned int *mBytesRead = nullptr;
 
-        return mResult;
+    private:
+        Command mCommand = COMMAND_MAX;
+        FMOD_RESULT mResult = FMOD_OK;
+
+        FRunnableThread *mThread = nullptr;
+        FEvent *mCommandReadyEvent = nullptr;
+        FEvent *mCommandCompleteEvent = nullptr;
+    };
+
+    FStripe &GetStripe(void *handle)
+    {
+        return mStripes[(UPTRINT(handle) >> 4) % StripeCount];
     }
 
-    // Parameter for Close, Seek and Read
-    void *mHandleIn;
+    // Locks a stripe for the lifetime of the scope, and accounts for the time spent waiting on it.
+    class FScopedStripeLock
+    {
+    public:
+        FScopedStripeLock(FFMODFileSystem &fileSystem, FStripe &stripe)
+            : mStripe(stripe)
+        {
+            if (!mStripe.mLock.TryLock())
+            {
+                const uint64 waitStart = FPlatformTime::Cycles64();
+                mStripe.mLock.Lock();
+                fileSystem.mLockWaitCycles.fetch_add(FPlatformTime::Cycles64() - waitStart, std::memory_order_relaxed);
+            }
+        }
+
+        ~FScopedStripeLock()
+        {
+            mStripe.mLock.Unlock();
+        }
+
+    private:
+        FStripe &mStripe;
+    };
 
-    // Parameters for Open
-    const char *mName;
-    unsigned int *mFileSize;
-    void **mHandleOut;
+    // Records how long a callback took, from construction until the end of the scope.
+    class FScopedCallbackLatency
+    {
+    public:
+        explicit FScopedCallbackLatency(FFMODFileSystem &fileSystem)
+            : mFileSystem(fileSystem)
+            , mStartCycles(FPlatformTime::Cycles64())
+        {
+            const uint32 updateThreadId = fileSystem.mStudioUpdateThreadId.load(std::memory_order_relaxed);
+            if (updateThreadId != 0 && updateThreadId == FPlatformTLS::GetCurrentThreadId())
+            {
+                fileSystem.mUpdateThreadCallbackCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        ~FScopedCallbackLatency()
+        {
+            const double latencyUs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - mStartCycles) * 1000.0;
+            int32 bucket = 0;
+            while (bucket < FFMODFileSystemStats::LatencyBucketCount - 1 && latencyUs > FMODFileSystemStatics::LatencyBucketBoundsUs[bucket])
+            {
+                ++bucket;
+            }
+            mFileSystem.mLatencyHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
 
-    // Parameters for Read
-    void *mBuffer;
-    unsigned int mSizeBytes;
-    unsigned int *mBytesRead;
+    private:
+        FFMODFileSystem &mFileSystem;
+        uint64 mStartCycles;
+    };
 
-    // Parameter for Seek
-    unsigned int mSeekPosition;
+    // Called at the start and end of every Studio update. With async updates, both run on the Studio update thread.
+    static FMOD_RESULT F_CALLBACK StudioUpdateCallback(FMOD_STUDIO_SYSTEM *system, FMOD_STUDIO_SYSTEM_CALLBACK_TYPE type, void *commanddata, void *userdata);
 
-    Command mCommand;
-    FMOD_RESULT mResult;
+    // Reads straight from the archive, seeking it first if FMOD moved the handle since the last read.
+    static void ReadFromArchive(FFMODFileHandle &fileHandle, int64 position, void *buffer, int64 sizebytes);
 
     int mReferenceCount;
-    FRunnableThread *mThread;
-    FEvent *mCommandReadyEvent;
-    FEvent *mCommandCompleteEvent;
+    int32 mReadAheadSize;
 
     FCriticalSection mCrit;
+    FStripe mStripes[StripeCount];
+
+    // Opens have no handle to hash yet, so they are spread over the stripes in turn
+    std::atomic<uint32> mNextOpenStripe { 0 };
+
+    std::atomic<int64> mOpenCount { 0 };
+    std::atomic<int64> mReadCount { 0 };
+    std::atomic<int64> mBytesRequested { 0 };
+    std::atomic<int64> mBytesReadFromDisk { 0 };
+    std::atomic<int64> mReadAheadHits { 0 };
+    std::atomic<uint64> mLockWaitCycles { 0 };
+    std::atomic<int64> mLatencyHistogram[FFMODFileSystemStats::LatencyBucketCount] = {};
+
+    std::atomic<uint32> mStudioUpdateThreadId { 0 };
+    std::atomic<int64> mUpdateThreadCallbackCount { 0 };
+    std::atomic<int64> mStudioUpdateCount { 0 };
+    std::atomic<uint64> mMaxStudioUpdateCycles { 0 };
+    uint64 mStudioUpdateStartCycles = 0;
 };
 
 static FFMODFileSystem gFileSystem;
 
-FMOD_RESULT F_CALLBACK FFMODFileSystem::OpenCallback(const char *name, unsigned int *filesize, void **handle, void * /*userdata*/)
+FMOD_RESULT F_CALLBACK FFMODFileSystem::StudioUpdateCallback(FMOD_STUDIO_SYSTEM * /*system*/, FMOD_STUDIO_SYSTEM_CALLBACK_TYPE type, void * /*commanddata*/, void * /*userdata*/)
 {
-    FScopeLock lock(&gFileSystem.mCrit);
-    gFileSystem.mName = name;
-    gFileSystem.mFileSize = filesize;
-    gFileSystem.mHandleOut = handle;
+    // NOTE: Only the runtime system is probed, so the start time is never shared between update threads
+    if (type == FMOD_STUDIO_SYSTEM_CALLBACK_PREUPDATE)
+    {
+        gFileSystem.mStudioUpdateThreadId.store(FPlatformTLS::GetCurrentThreadId(), std::memory_order_relaxed);
+        gFileSystem.mStudioUpdateStartCycles = FPlatformTime::Cycles64();
+    }
+    else if (type == FMOD_STUDIO_SYSTEM_CALLBACK_POSTUPDATE && gFileSystem.mStudioUpdateStartCycles != 0)
+    {
+        const uint64 updateCycles = FPlatformTime::Cycles64() - gFileSystem.mStudioUpdateStartCycles;
+        uint64 maxUpdateCycles = gFileSystem.mMaxStudioUpdateCycles.load(std::memory_order_relaxed);
+        while (updateCycles > maxUpdateCycles && !gFileSystem.mMaxStudioUpdateCycles.compare_exchange_weak(maxUpdateCycles, updateCycles, std::memory_order_relaxed))
+        {
+        }
+        gFileSystem.mStudioUpdateCount.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    return gFileSystem.RunCommand(COMMAND_OPEN);
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALLBACK FFMODFileSystem::OpenCallback(const char *name, unsigned int *filesize, void **handle, void * /*userdata*/)
+{
+    FScopedCallbackLatency latency(gFileSystem);
+    FStripe &stripe = gFileSystem.mStripes[gFileSystem.mNextOpenStripe.fetch_add(1, std::memory_order_relaxed) % StripeCount];
+    FScopedStripeLock lock(gFileSystem, stripe);
+    stripe.mName = name;
+    stripe.mFileSize = filesize;
+    stripe.mHandleOut = handle;
+
+    return stripe.RunCommand(COMMAND_OPEN);
 }
 
 FMOD_RESULT FFMODFileSystem::OpenInternal(const char *name, unsigned int *filesize, void **handle)
@@ -241,8 +435,14 @@ FMOD_RESULT FFMODFileSystem::OpenInternal(const char *name, unsigned int *filesi
         {
             return FMOD_ERR_FILE_NOTFOUND;
         }
-        *filesize = Archive->TotalSize();
-        *handle = Archive;
+
+        FFMODFileHandle *FileHandle = new FFMODFileHandle();
+        FileHandle->mArchive = Archive;
+        FileHandle->mSize = Archive->TotalSize();
+
+        *filesize = (unsigned int)FileHandle->mSize;
+        *handle = FileHandle;
+        gFileSystem.mOpenCount.fetch_add(1, std::memory_order_relaxed);
         UE_LOG(LogFMOD, Verbose, TEXT("  TotalSize = %d"), *filesize);
     }
 
@@ -251,10 +451,12 @@ FMOD_RESULT FFMODFileSystem::OpenInternal(const char *name, unsigned int *filesi
 
 FMOD_RESULT F_CALLBACK FFMODFileSystem::CloseCallback(void *handle, void * /*userdata*/)
 {
-    FScopeLock lock(&gFileSystem.mCrit);
-    gFileSystem.mHandleIn = handle;
+    FScopedCallbackLatency latency(gFileSystem);
+    FStripe &stripe = gFileSystem.GetStripe(handle);
+    FScopedStripeLock lock(gFileSystem, stripe);
+    stripe.mHandleIn = handle;
 
-    return gFileSystem.RunCommand(COMMAND_CLOSE);
+    return stripe.RunCommand(COMMAND_CLOSE);
 }
 
 FMOD_RESULT FFMODFileSystem::CloseInternal(void *handle)
@@ -264,22 +466,36 @@ FMOD_RESULT FFMODFileSystem::CloseInternal(void *handle)
         return FMOD_ERR_INVALID_PARAM;
     }
 
-    FArchive *Archive = (FArchive *)handle;
-    UE_LOG(LogFMOD, Verbose, TEXT("FFMODFileSystem::CloseCallback closing archive %p"), Archive);
-    delete Archive;
+    FFMODFileHandle *FileHandle = (FFMODFileHandle *)handle;
+    UE_LOG(LogFMOD, Verbose, TEXT("FFMODFileSystem::CloseCallback closing archive %p"), FileHandle->mArchive);
+    delete FileHandle->mArchive;
+    delete FileHandle;
 
     return FMOD_OK;
 }
 
 FMOD_RESULT F_CALLBACK FFMODFileSystem::ReadCallback(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread, void * /*userdata*/)
 {
-    FScopeLock lock(&gFileSystem.mCrit);
-    gFileSystem.mHandleIn = handle;
-    gFileSystem.mBuffer = buffer;
-    gFileSystem.mSizeBytes = sizebytes;
-    gFileSystem.mBytesRead = bytesread;
+    FScopedCallbackLatency latency(gFileSystem);
+    FStripe &stripe = gFileSystem.GetStripe(handle);
+    FScopedStripeLock lock(gFileSystem, stripe);
+    stripe.mHandleIn = handle;
+    stripe.mBuffer = buffer;
+    stripe.mSizeBytes = sizebytes;
+    stripe.mBytesRead = bytesread;
+
+    return stripe.RunCommand(COMMAND_READ);
+}
+
+void FFMODFileSystem::ReadFromArchive(FFMODFileHandle &fileHandle, int64 position, void *buffer, int64 sizebytes)
+{
+    if (fileHandle.mArchive->Tell() != position)
+    {
+        fileHandle.mArchive->Seek(position);
+    }
 
-    return gFileSystem.RunCommand(COMMAND_READ);
+    fileHandle.mArchive->Serialize(buffer, sizebytes);
+    gFileSystem.mBytesReadFromDisk.fetch_add(sizebytes, std::memory_order_relaxed);
 }
 
 FMOD_RESULT FFMODFileSystem::ReadInternal(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread)
@@ -291,12 +507,45 @@ FMOD_RESULT FFMODFileSystem::ReadInternal(void *handle, void *buffer, unsigned i
 
     if (bytesread)
     {
-        FArchive *Archive = (FArchive *)handle;
+        FFMODFileHandle *FileHandle = (FFMODFileHandle *)handle;
+
+        int64 BytesLeft = FileHandle->mSize - FileHandle->mPosition;
+        int64 ReadAmount = FMath::Max(FMath::Min((int64)sizebytes, BytesLeft), (int64)0);
+        int64 CopiedAmount = 0;
+        uint8 *OutBuffer = (uint8 *)buffer;
 
-        int64 BytesLeft = Archive->TotalSize() - Archive->Tell();
-        int64 ReadAmount = FMath::Min((int64)sizebytes, BytesLeft);
+        gFileSystem.mReadCount.fetch_add(1, std::memory_order_relaxed);
+        gFileSystem.mBytesRequested.fetch_add(ReadAmount, std::memory_order_relaxed);
 
-        Archive->Serialize(buffer, ReadAmount);
+        // Serves as much as possible from the read-ahead buffer
+        const int64 ReadAheadOffset = FileHandle->mPosition - FileHandle->mReadAheadStart;
+        if (ReadAheadOffset >= 0 && ReadAheadOffset < FileHandle->mReadAheadLength)
+        {
+            CopiedAmount = FMath::Min(ReadAmount, FileHandle->mReadAheadLength - ReadAheadOffset);
+            FMemory::Memcpy(OutBuffer, FileHandle->mReadAheadBuffer.GetData() + ReadAheadOffset, CopiedAmount);
+            gFileSystem.mReadAheadHits.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Reads the rest from disk. Small reads refill the read-ahead buffer, while large ones go straight into FMOD's buffer.
+        const int64 RemainingAmount = ReadAmount - CopiedAmount;
+        const int64 RemainingPosition = FileHandle->mPosition + CopiedAmount;
+        const int32 ReadAheadSize = gFileSystem.mReadAheadSize;
+        if (RemainingAmount > 0 && RemainingAmount < ReadAheadSize)
+        {
+            const int64 FillAmount = FMath::Min((int64)ReadAheadSize, FileHandle->mSize - RemainingPosition);
+            FileHandle->mReadAheadBuffer.SetNumUninitialized(ReadAheadSize, EAllowShrinking::No);
+            ReadFromArchive(*FileHandle, RemainingPosition, FileHandle->mReadAheadBuffer.GetData(), FillAmount);
+            FileHandle->mReadAheadStart = RemainingPosition;
+            FileHandle->mReadAheadLength = FillAmount;
+
+            FMemory::Memcpy(OutBuffer + CopiedAmount, FileHandle->mReadAheadBuffer.GetData(), RemainingAmount);
+        }
+        else if (RemainingAmount > 0)
+        {
+            ReadFromArchive(*FileHandle, RemainingPosition, OutBuffer + CopiedAmount, RemainingAmount);
+        }
+
+        FileHandle->mPosition += ReadAmount;
         *bytesread = (unsigned int)ReadAmount;
         if (ReadAmount < (int64)sizebytes)
         {
@@ -310,11 +559,10 @@ FMOD_RESULT FFMODFileSystem::ReadInternal(void *handle, void *buffer, unsigned i
 
 FMOD_RESULT F_CALLBACK FFMODFileSystem::SeekCallback(void *handle, unsigned int pos, void * /*userdata*/)
 {
-    FScopeLock lock(&gFileSystem.mCrit);
-    gFileSystem.mHandleIn = handle;
-    gFileSystem.mSeekPosition = pos;
+    FScopedCallbackLatency latency(gFileSystem);
+    FScopedStripeLock lock(gFileSystem, gFileSystem.GetStripe(handle));
 
-    return gFileSystem.RunCommand(COMMAND_SEEK);
+    return SeekInternal(handle, pos);
 }
 
 FMOD_RESULT FFMODFileSystem::SeekInternal(void *handle, unsigned int pos)
@@ -324,12 +572,38 @@ FMOD_RESULT FFMODFileSystem::SeekInternal(void *handle, unsigned int pos)
         return FMOD_ERR_INVALID_PARAM;
     }
 
-    FArchive *Archive = (FArchive *)handle;
-    Archive->Seek(pos);
+    // NOTE: Seeking only moves the logical position, so that seeks within the read-ahead buffer never touch the archive
+    FFMODFileHandle *FileHandle = (FFMODFileHandle *)handle;
+    FileHandle->mPosition = pos;
 
     return FMOD_OK;
 }
 
+static FAutoConsoleCommand GDumpFMODFileSystemStatsCommand(
+    TEXT("fmod.DumpFileSystemStats"),
+    TEXT("Prints the FMOD file system counters (reads, bytes, read-ahead hits, lock wait time and callback latencies)."),
+    FConsoleCommandDelegate::CreateLambda([]()
+    {
+        FFMODFileSystemStats Stats;
+        GetFMODFileSystemStats(Stats);
+
+        UE_LOG(LogFMOD, Display, TEXT("FMOD file system: Opens=%lld Reads=%lld BytesRequested=%lld BytesReadFromDisk=%lld ReadAheadHits=%lld LockWait=%.3fms"),
+            Stats.OpenCount, Stats.ReadCount, Stats.BytesRequested, Stats.BytesReadFromDisk, Stats.ReadAheadHits, Stats.LockWaitSeconds * 1000.0);
+        UE_LOG(LogFMOD, Display, TEXT("  Callback latency: <=50us=%lld <=250us=%lld <=1ms=%lld <=5ms=%lld <=20ms=%lld >20ms=%lld"),
+            Stats.CallbackLatencyHistogram[0], Stats.CallbackLatencyHistogram[1], Stats.CallbackLatencyHistogram[2],
+            Stats.CallbackLatencyHistogram[3], Stats.CallbackLatencyHistogram[4], Stats.CallbackLatencyHistogram[5]);
+        UE_LOG(LogFMOD, Display, TEXT("  Studio update: Updates=%lld MaxUpdate=%.3fms UpdateThreadFileCallbacks=%lld"),
+            Stats.StudioUpdateCount, Stats.MaxStudioUpdateSeconds * 1000.0, Stats.UpdateThreadCallbackCount);
+    }));
+
+static FAutoConsoleCommand GResetFMODFileSystemStatsCommand(
+    TEXT("fmod.ResetFileSystemStats"),
+    TEXT("Resets the FMOD file system counters, so that fmod.DumpFileSystemStats only covers what happens from now on."),
+    FConsoleCommandDelegate::CreateLambda([]()
+    {
+        ResetFMODFileSystemStats();
+    }));
+
 void AcquireFMODFileSystem()
 {
     gFileSystem.IncrementReferenceCount();
@@ -340,7 +614,22 @@ void ReleaseFMODFileSystem()
     gFileSystem.DecrementReferenceCount();
 }
 
-void AttachFMODFileSystem(FMOD::System *system, int32 fileBufferSize)
+void AttachFMODFileSystem(FMOD::System *system, int32 fileBufferSize, int32 readAheadSize)
+{
+    gFileSystem.Attach(system, fileBufferSize, readAheadSize);
+}
+
+void GetFMODFileSystemStats(FFMODFileSystemStats &stats)
+{
+    gFileSystem.GetStats(stats);
+}
+
+void ResetFMODFileSystemStats()
+{
+    gFileSystem.ResetStats();
+}
+
+void AttachFMODStudioUpdateProbe(FMOD::Studio::System *system)
 {
-    gFileSystem.Attach(system, fileBufferSize);
+    gFileSystem.AttachStudioUpdateProbe(system);
 }
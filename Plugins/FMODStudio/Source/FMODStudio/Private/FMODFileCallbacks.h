@@ -3,11 +3,37 @@
 #pragma once
 
 #include "fmod.hpp"
+#include "fmod_studio.hpp"
 #include "GenericPlatform/GenericPlatform.h"
 
 FMOD_RESULT F_CALLBACK FMODLogCallback(FMOD_DEBUG_FLAGS flags, const char *file, int line, const char *func, const char *message);
 FMOD_RESULT F_CALLBACK FMODErrorCallback(FMOD_SYSTEM *system, FMOD_SYSTEM_CALLBACK_TYPE type, void *commanddata1, void *commanddata2, void *userdata);
 
+struct FFMODFileSystemStats
+{
+    static constexpr FGenericPlatformTypes::int32 LatencyBucketCount = 6;
+
+    FGenericPlatformTypes::int64 OpenCount = 0;
+    FGenericPlatformTypes::int64 ReadCount = 0;
+    FGenericPlatformTypes::int64 BytesRequested = 0;
+    FGenericPlatformTypes::int64 BytesReadFromDisk = 0;
+    FGenericPlatformTypes::int64 ReadAheadHits = 0;
+    double LockWaitSeconds = 0.0;
+
+    // File callbacks that ran on the Studio update thread. Any of these means file I/O is stalling the Studio update.
+    FGenericPlatformTypes::int64 UpdateThreadCallbackCount = 0;
+    FGenericPlatformTypes::int64 StudioUpdateCount = 0;
+    double MaxStudioUpdateSeconds = 0.0;
+
+    // Callback counts by latency: <=50us, <=250us, <=1ms, <=5ms, <=20ms, >20ms.
+    FGenericPlatformTypes::int64 CallbackLatencyHistogram[LatencyBucketCount] = {};
+};
+
 void AcquireFMODFileSystem();
 void ReleaseFMODFileSystem();
-void AttachFMODFileSystem(FMOD::System *system, FGenericPlatformTypes::int32 fileBufferSize);
+void AttachFMODFileSystem(FMOD::System *system, FGenericPlatformTypes::int32 fileBufferSize, FGenericPlatformTypes::int32 readAheadSize);
+void GetFMODFileSystemStats(FFMODFileSystemStats &stats);
+void ResetFMODFileSystemStats();
+
+// Times every Studio update, and records the update thread, so that file callbacks running on it can be counted.
+void AttachFMODStudioUpdateProbe(FMOD::Studio::System *system);
@@ -0,0 +1,262 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2024.
+
+#include "FMODOcclusionScheduler.h"
+#include "FMODAudioComponent.h"
+#include "FMODListener.h"
+#include "FMODStudioModule.h"
+#include "fmod_studio.hpp"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "FMODStudioPrivatePCH.h"
+
+static int32 GFMODOcclusionMaxTracesPerFrame = 8;
+static FAutoConsoleVariableRef CVarFMODOcclusionMaxTracesPerFrame(
+    TEXT("fmod.Occlusion.MaxTracesPerFrame"),
+    GFMODOcclusionMaxTracesPerFrame,
+    TEXT("Maximum amount of occlusion traces issued per frame. Due components over this budget are deferred to the next frames, most overdue first."),
+    ECVF_Default);
+
+static float GFMODOcclusionMinInterval = 0.1f;
+static FAutoConsoleVariableRef CVarFMODOcclusionMinInterval(
+    TEXT("fmod.Occlusion.MinInterval"),
+    GFMODOcclusionMinInterval,
+    TEXT("How often (in seconds) the occlusion of an audible component next to the listener is refreshed."),
+    ECVF_Default);
+
+static float GFMODOcclusionMaxInterval = 0.5f;
+static FAutoConsoleVariableRef CVarFMODOcclusionMaxInterval(
+    TEXT("fmod.Occlusion.MaxInterval"),
+    GFMODOcclusionMaxInterval,
+    TEXT("How often (in seconds) the occlusion of an audible component at fmod.Occlusion.FarDistance or further is refreshed."),
+    ECVF_Default);
+
+static float GFMODOcclusionFarDistance = 5000.0f;
+static FAutoConsoleVariableRef CVarFMODOcclusionFarDistance(
+    TEXT("fmod.Occlusion.FarDistance"),
+    GFMODOcclusionFarDistance,
+    TEXT("Distance (in cm) to the listener from which components are refreshed at fmod.Occlusion.MaxInterval."),
+    ECVF_Default);
+
+static float GFMODOcclusionVirtualIntervalScale = 4.0f;
+static FAutoConsoleVariableRef CVarFMODOcclusionVirtualIntervalScale(
+    TEXT("fmod.Occlusion.VirtualIntervalScale"),
+    GFMODOcclusionVirtualIntervalScale,
+    TEXT("Refresh interval multiplier for components whose event instance is virtual (i.e., currently inaudible)."),
+    ECVF_Default);
+
+static float GFMODOcclusionInterpSpeed = 4.0f;
+static FAutoConsoleVariableRef CVarFMODOcclusionInterpSpeed(
+    TEXT("fmod.Occlusion.InterpSpeed"),
+    GFMODOcclusionInterpSpeed,
+    TEXT("How fast (in units per second) the occlusion parameter moves towards the latest trace result. 0 applies results immediately."),
+    ECVF_Default);
+
+static FAutoConsoleCommand GDumpFMODOcclusionStatsCommand(
+    TEXT("fmod.DumpOcclusionStats"),
+    TEXT("Prints the FMOD occlusion scheduler counters."),
+    FConsoleCommandDelegate::CreateLambda([]()
+    {
+        const FFMODOcclusionStats Stats = FFMODOcclusionScheduler::Get().GetStats();
+        UE_LOG(LogFMOD, Display, TEXT("FMOD occlusion: Components=%d PendingTraces=%d TracesIssued=%lld TracesCompleted=%lld TracesDropped=%lld DeferredTraces=%lld"),
+            Stats.RegisteredComponents, Stats.PendingTraces, Stats.TracesIssued, Stats.TracesCompleted, Stats.TracesDropped, Stats.DeferredTraces);
+    }));
+
+// Traces that haven't completed after this many frames are assumed lost (e.g., their world was torn down) and get reissued.
+static constexpr uint64 PendingTraceTimeoutFrames = 3;
+
+FFMODOcclusionScheduler &FFMODOcclusionScheduler::Get()
+{
+    static FFMODOcclusionScheduler Scheduler;
+    return Scheduler;
+}
+
+void FFMODOcclusionScheduler::Register(UFMODAudioComponent *component)
+{
+    if (!component)
+    {
+        return;
+    }
+
+    int32 entryIndex = FindEntry(component);
+    if (entryIndex == INDEX_NONE)
+    {
+        entryIndex = mEntries.AddDefaulted();
+        mEntries[entryIndex].Component = component;
+    }
+
+    // A (re)started event is traced as soon as the budget allows it, and takes its first result without interpolating
+    FEntry &entry = mEntries[entryIndex];
+    entry.LastTraceTime = -DBL_MAX;
+    entry.PendingTraceId = 0;
+    entry.bSnapNextResult = true;
+}
+
+void FFMODOcclusionScheduler::Unregister(UFMODAudioComponent *component)
+{
+    const int32 entryIndex = FindEntry(component);
+    if (entryIndex != INDEX_NONE)
+    {
+        mEntries.RemoveAtSwap(entryIndex, 1, EAllowShrinking::No);
+    }
+}
+
+void FFMODOcclusionScheduler::Tick(float deltaTime)
+{
+    if (mEntries.IsEmpty())
+    {
+        return;
+    }
+
+    const double currentTime = FApp::GetCurrentTime();
+    const float minInterval = FMath::Max(GFMODOcclusionMinInterval, 0.0f);
+    const float maxInterval = FMath::Max(GFMODOcclusionMaxInterval, minInterval);
+    IFMODStudioModule &module = IFMODStudioModule::Get();
+
+    // Drops components that were destroyed without unregistering, before any entry index is handed out
+    mEntries.RemoveAllSwap([](const FEntry &entry) { return !entry.Component.IsValid(); }, EAllowShrinking::No);
+
+    mDueEntries.Reset();
+    for (int32 entryIndex = 0; entryIndex < mEntries.Num(); ++entryIndex)
+    {
+        FEntry &entry = mEntries[entryIndex];
+        UFMODAudioComponent *component = entry.Component.Get();
+        if (!component->StudioInstance || !component->bApplyOcclusionParameter || !component->IsActive())
+        {
+            continue;
+        }
+
+        if (!component->OcclusionDetails.bEnableOcclusion)
+        {
+            // Occlusion was disabled at runtime, so the parameter is left at its last value.
+            // If it's enabled again, the component is traced as soon as possible and takes that result without interpolating.
+            entry.LastTraceTime = -DBL_MAX;
+            entry.PendingTraceId = 0;
+            entry.bSnapNextResult = true;
+            continue;
+        }
+
+        if (entry.PendingTraceId != 0)
+        {
+            if (GFrameCounter > entry.PendingTraceFrame + PendingTraceTimeoutFrames)
+            {
+                entry.PendingTraceId = 0;
+                entry.LastTraceTime = -DBL_MAX;
+                mStats.TracesDropped++;
+            }
+        }
+        else if (component->GetOwner())
+        {
+            const FVector location = component->GetComponentLocation();
+            const float listenerDistance = FVector::Dist(location, module.GetNearestListener(location).Transform.GetLocation());
+            const float distanceAlpha = GFMODOcclusionFarDistance > 0.0f ? FMath::Clamp(listenerDistance / GFMODOcclusionFarDistance, 0.0f, 1.0f) : 1.0f;
+            float interval = FMath::Lerp(minInterval, maxInterval, distanceAlpha);
+
+            bool bVirtual = false;
+            if (component->StudioInstance->isVirtual(&bVirtual) == FMOD_OK && bVirtual)
+            {
+                interval *= FMath::Max(GFMODOcclusionVirtualIntervalScale, 1.0f);
+            }
+
+            // NOTE: Components that have never been traced are infinitely overdue, so they always go first
+            const double elapsed = currentTime - entry.LastTraceTime;
+            const float overdue = interval > 0.0f ? (float)(elapsed / interval) : FLT_MAX;
+            if (overdue >= 1.0f)
+            {
+                mDueEntries.Add({ overdue, entryIndex });
+            }
+        }
+
+        component->UpdateOcclusion(deltaTime, GFMODOcclusionInterpSpeed);
+    }
+
+    const int32 traceBudget = FMath::Max(GFMODOcclusionMaxTracesPerFrame, 1);
+    if (mDueEntries.Num() > traceBudget)
+    {
+        mDueEntries.Sort([](const FDueEntry &a, const FDueEntry &b) { return a.Overdue > b.Overdue; });
+        mStats.DeferredTraces += mDueEntries.Num() - traceBudget;
+    }
+
+    for (int32 dueIndex = 0; dueIndex < FMath::Min(mDueEntries.Num(), traceBudget); ++dueIndex)
+    {
+        IssueTrace(mEntries[mDueEntries[dueIndex].EntryIndex], currentTime);
+    }
+}
+
+void FFMODOcclusionScheduler::Reset()
+{
+    mEntries.Empty();
+    mDueEntries.Empty();
+}
+
+FFMODOcclusionStats FFMODOcclusionScheduler::GetStats() const
+{
+    FFMODOcclusionStats stats = mStats;
+    stats.RegisteredComponents = mEntries.Num();
+    for (const FEntry &entry : mEntries)
+    {
+        stats.PendingTraces += entry.PendingTraceId != 0 ? 1 : 0;
+    }
+    return stats;
+}
+
+void FFMODOcclusionScheduler::IssueTrace(FEntry &entry, double currentTime)
+{
+    UFMODAudioComponent *component = entry.Component.Get();
+    UWorld *world = component ? component->GetWorld() : nullptr;
+    if (!world)
+    {
+        return;
+    }
+
+    if (!mTraceDelegate.IsBound())
+    {
+        mTraceDelegate.BindRaw(this, &FFMODOcclusionScheduler::OnTraceCompleted);
+    }
+
+    // Trace ids are only used to match results with their entry, so 0 is skipped to keep it meaning "no trace pending"
+    const uint32 traceId = mNextTraceId++;
+    if (mNextTraceId == 0)
+    {
+        mNextTraceId = 1;
+    }
+
+    static FName NAME_SoundOcclusion = FName(TEXT("SoundOcclusion"));
+    const FCollisionQueryParams params(NAME_SoundOcclusion, component->OcclusionDetails.bUseComplexCollisionForOcclusion, component->GetOwner());
+    const FVector location = component->GetComponentLocation();
+    const FFMODListener &listener = IFMODStudioModule::Get().GetNearestListener(location);
+
+    world->AsyncLineTraceByChannel(EAsyncTraceType::Test, location, listener.Transform.GetLocation(), component->OcclusionDetails.OcclusionTraceChannel,
+        params, FCollisionResponseParams::DefaultResponseParam, &mTraceDelegate, traceId);
+
+    entry.PendingTraceId = traceId;
+    entry.PendingTraceFrame = GFrameCounter;
+    entry.LastTraceTime = currentTime;
+    mStats.TracesIssued++;
+}
+
+void FFMODOcclusionScheduler::OnTraceCompleted(const FTraceHandle &handle, FTraceDatum &datum)
+{
+    for (FEntry &entry : mEntries)
+    {
+        if (entry.PendingTraceId != datum.UserData)
+        {
+            continue;
+        }
+
+        entry.PendingTraceId = 0;
+        mStats.TracesCompleted++;
+
+        if (UFMODAudioComponent *component = entry.Component.Get())
+        {
+            const bool bOccluded = FHitResult::GetFirstBlockingHit(datum.OutHits) != nullptr;
+            component->SetOcclusionTarget(bOccluded ? 1.0f : 0.0f, entry.bSnapNextResult);
+            entry.bSnapNextResult = false;
+        }
+        return;
+    }
+}
+
+int32 FFMODOcclusionScheduler::FindEntry(const UFMODAudioComponent *component) const
+{
+    return mEntries.IndexOfByPredicate([component](const FEntry &entry) { return entry.Component.Get() == component; });
+}
@@ -0,0 +1,66 @@
+// Copyright (c), Firelight Technologies Pty, Ltd. 2012-2024.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "WorldCollision.h"
+
+class UFMODAudioComponent;
+
+struct FFMODOcclusionStats
+{
+    int32 RegisteredComponents = 0;
+    int32 PendingTraces = 0;
+    int64 TracesIssued = 0;
+    int64 TracesCompleted = 0;
+    int64 TracesDropped = 0;
+    // Due components that were pushed to a later frame, because the frame's trace budget ran out.
+    int64 DeferredTraces = 0;
+};
+
+// Owns the occlusion traces of every occlusion-enabled UFMODAudioComponent.
+// Components are traced under a per-frame budget, most overdue first, with audible and close emitters refreshed more often.
+// Traces are issued asynchronously, so their results land on the next frame, and the occlusion parameter is
+// interpolated towards the latest result so that staggered updates stay inaudible.
+class FFMODOcclusionScheduler
+{
+public:
+    static FFMODOcclusionScheduler &Get();
+
+    void Register(UFMODAudioComponent *component);
+    void Unregister(UFMODAudioComponent *component);
+
+    void Tick(float deltaTime);
+
+    // Drops every component and in-flight trace. Called when the studio systems are torn down.
+    void Reset();
+
+    FFMODOcclusionStats GetStats() const;
+
+private:
+    struct FEntry
+    {
+        TWeakObjectPtr<UFMODAudioComponent> Component;
+        double LastTraceTime = -DBL_MAX;
+        uint64 PendingTraceFrame = 0;
+        uint32 PendingTraceId = 0;
+        bool bSnapNextResult = true;
+    };
+
+    struct FDueEntry
+    {
+        float Overdue;
+        int32 EntryIndex;
+    };
+
+    void IssueTrace(FEntry &entry, double currentTime);
+    void OnTraceCompleted(const FTraceHandle &handle, FTraceDatum &datum);
+    int32 FindEntry(const UFMODAudioComponent *component) const;
+
+    TArray<FEntry> mEntries;
+    TArray<FDueEntry> mDueEntries;
+    FTraceDelegate mTraceDelegate;
+    uint32 mNextTraceId = 1;
+    FFMODOcclusionStats mStats;
+};
@@ -52,6 +52,7 @@ UFMODSettings::UFMODSettings(const FObjectInitializer &ObjectInitializer)
     , DSPBufferLength(0)
     , DSPBufferCount(0)
     , FileBufferSize(2048)
+    , FileReadAheadSize(65536)
     , StudioUpdatePeriod(0)
     , bLockAllBuses(false)
     , LiveUpdatePort(9264)
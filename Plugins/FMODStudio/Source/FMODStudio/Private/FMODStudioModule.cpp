@@ -9,6 +9,7 @@
 #include "FMODUtils.h"
 #include "FMODEvent.h"
 #include "FMODListener.h"
+#include "FMODOcclusionScheduler.h"
 #include "FMODSnapshotReverb.h"
 
 #include "FMODAudioLinkModule.h"
@@ -691,7 +692,7 @@ void FFMODStudioModule::CreateStudioSystem(EFMODSystemContext::Type Type)
 
     verifyfmod(lowLevelSystem->setSoftwareFormat(SampleRate, OutputMode, 0));
     verifyfmod(lowLevelSystem->setSoftwareChannels(Settings.GetRealChannelCount()));
-    AttachFMODFileSystem(lowLevelSystem, Settings.FileBufferSize);
+    AttachFMODFileSystem(lowLevelSystem, Settings.FileBufferSize, Settings.FileReadAheadSize);
 
     if (Settings.DSPBufferLength > 0 && Settings.DSPBufferCount > 0)
     {
@@ -742,6 +743,11 @@ void FFMODStudioModule::CreateStudioSystem(EFMODSystemContext::Type Type)
 
     verifyfmod(StudioSystem[Type]->initialize(Settings.TotalChannelCount, StudioInitFlags, InitFlags, InitData));
 
+    if (Type == EFMODSystemContext::Runtime)
+    {
+        AttachFMODStudioUpdateProbe(StudioSystem[Type]);
+    }
+
     for (FString PluginName : Settings.PluginFiles)
     {
         if (!PluginName.IsEmpty())
@@ -855,6 +861,8 @@ bool FFMODStudioModule::Tick(float DeltaTime)
     {
         verifyfmod(ClockSinks[EFMODSystemContext::Editor]->LastResult);
     }
+
+    FFMODOcclusionScheduler::Get().Tick(DeltaTime);
     return true;
 }
 
@@ -1237,6 +1245,7 @@ void FFMODStudioModule::ShutdownModule()
     DestroyStudioSystem(EFMODSystemContext::Auditioning);
     DestroyStudioSystem(EFMODSystemContext::Runtime);
     DestroyStudioSystem(EFMODSystemContext::Editor);
+    FFMODOcclusionScheduler::Get().Reset();
 
     if (FMODAudioLinkModule)
     {
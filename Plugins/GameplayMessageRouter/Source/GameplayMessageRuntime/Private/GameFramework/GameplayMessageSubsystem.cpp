@@ -19,9 +19,23 @@ namespace UE
 		static FAutoConsoleVariableRef CVarShouldLogMessages(TEXT("GameplayMessageSubsystem.LogMessages"),
 			ShouldLogMessages,
 			TEXT("Should messages broadcast through the gameplay message subsystem be logged?"));
+
+		static void DumpChannelStats(UWorld* World)
+		{
+			if (World && UGameplayMessageSubsystem::HasInstance(World))
+			{
+				UGameplayMessageSubsystem::Get(World).DumpChannelStats();
+			}
+		}
+
+		static FAutoConsoleCommandWithWorld CmdDumpChannelStats(TEXT("GameplayMessageSubsystem.DumpChannelStats"),
+			TEXT("Logs how many messages were broadcast on each channel, and how long it took to dispatch them."),
+			FConsoleCommandWithWorldDelegate::CreateStatic(&DumpChannelStats));
 	}
 }
 
+DECLARE_CYCLE_STAT(TEXT("GameplayMessage Broadcast"), STAT_GameplayMessageBroadcast, STATGROUP_Game);
+
 //////////////////////////////////////////////////////////////////////
 // FGameplayMessageListenerHandle
 
@@ -58,6 +72,8 @@ bool UGameplayMessageSubsystem::HasInstance(const UObject* WorldContextObject)
 void UGameplayMessageSubsystem::Deinitialize()
 {
 	ListenerMap.Reset();
+	ChannelHierarchyCache.Reset();
+	ChannelStats.Reset();
 
 	Super::Deinitialize();
 }
@@ -81,43 +97,118 @@ void UGameplayMessageSubsystem::BroadcastMessageInternal(FGameplayTag Channel, c
 		UE_LOG(LogGameplayMessageSubsystem, Log, TEXT("BroadcastMessage(%s, %s, %s)"), pContextString ? **pContextString : *GetPathNameSafe(this), *Channel.ToString(), *HumanReadableMessage);
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_GameplayMessageBroadcast);
+	const uint64 BroadcastStartCycles = FPlatformTime::Cycles64();
+
 	// Broadcast the message
-	bool bOnInitialTag = true;
-	for (FGameplayTag Tag = Channel; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	const FChannelHierarchy ChannelHierarchy = GetChannelHierarchy(Channel);
+	for (int32 HierarchyIndex = 0; HierarchyIndex < ChannelHierarchy.Num(); HierarchyIndex++)
 	{
-		if (const FChannelListenerList* pList = ListenerMap.Find(Tag))
+		const FGameplayTag Tag = ChannelHierarchy[HierarchyIndex];
+		const bool bOnInitialTag = HierarchyIndex == 0;
+
+		const TUniquePtr<FChannelListenerList>* pListPtr = ListenerMap.Find(Tag);
+		if (!pListPtr)
 		{
-			// Copy in case there are removals while handling callbacks
-			TArray<FGameplayMessageListenerData> ListenerArray(pList->Listeners);
+			continue;
+		}
 
-			for (const FGameplayMessageListenerData& Listener : ListenerArray)
+		// Iterates the list in place instead of copying it. While BroadcastDepth is set, removals are deferred and additions are
+		// queued in PendingListeners, so the entries we're iterating are never moved by re-entrant register/unregister calls.
+		// Listeners registered during this broadcast won't receive this message, which matches the old copy behavior.
+		FChannelListenerList& List = **pListPtr;
+		List.BroadcastDepth++;
+
+		const int32 NumListeners = List.Listeners.Num();
+		for (int32 ListenerIndex = 0; ListenerIndex < NumListeners; ListenerIndex++)
+		{
+			FGameplayMessageListenerData& Listener = List.Listeners[ListenerIndex];
+			if (Listener.bPendingRemoval)
+			{
+				continue;
+			}
+
+			if (bOnInitialTag || (Listener.MatchType == EGameplayMessageMatch::PartialMatch))
 			{
-				if (bOnInitialTag || (Listener.MatchType == EGameplayMessageMatch::PartialMatch))
+				if (Listener.bHadValidType && !Listener.ListenerStructType.IsValid())
+				{
+					UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("Listener struct type has gone invalid on Channel %s. Removing listener from list"), *Channel.ToString());
+					UnregisterListenerInternal(Tag, Listener.HandleID);
+					continue;
+				}
+
+				// The receiving type must be either a parent of the sending type or completely ambiguous (for internal use)
+				const UScriptStruct* ListenerStructType = Listener.ListenerStructType.Get();
+				if (!Listener.bHadValidType || StructType == ListenerStructType || StructType == Listener.LastAcceptedStructType || StructType->IsChildOf(ListenerStructType))
+				{
+					Listener.LastAcceptedStructType = StructType;
+					Listener.ReceivedCallback(Channel, StructType, MessageBytes);
+				}
+				else
 				{
-					if (Listener.bHadValidType && !Listener.ListenerStructType.IsValid())
-					{
-						UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("Listener struct type has gone invalid on Channel %s. Removing listener from list"), *Channel.ToString());
-						UnregisterListenerInternal(Channel, Listener.HandleID);
-						continue;
-					}
-
-					// The receiving type must be either a parent of the sending type or completely ambiguous (for internal use)
-					if (!Listener.bHadValidType || StructType->IsChildOf(Listener.ListenerStructType.Get()))
-					{
-						Listener.ReceivedCallback(Channel, StructType, MessageBytes);
-					}
-					else
-					{
-						UE_LOG(LogGameplayMessageSubsystem, Error, TEXT("Struct type mismatch on channel %s (broadcast type %s, listener at %s was expecting type %s)"),
-							*Channel.ToString(),
-							*StructType->GetPathName(),
-							*Tag.ToString(),
-							*Listener.ListenerStructType->GetPathName());
-					}
+					UE_LOG(LogGameplayMessageSubsystem, Error, TEXT("Struct type mismatch on channel %s (broadcast type %s, listener at %s was expecting type %s)"),
+						*Channel.ToString(),
+						*StructType->GetPathName(),
+						*Tag.ToString(),
+						*Listener.ListenerStructType->GetPathName());
 				}
 			}
 		}
-		bOnInitialTag = false;
+
+		List.BroadcastDepth--;
+		if (List.BroadcastDepth == 0)
+		{
+			// NOTE: This may remove the list from ListenerMap, so List can't be used after this
+			FlushPendingListenerChanges(Tag, List);
+		}
+	}
+
+	RecordBroadcast(Channel, BroadcastStartCycles);
+}
+
+UGameplayMessageSubsystem::FChannelHierarchy UGameplayMessageSubsystem::GetChannelHierarchy(FGameplayTag Channel)
+{
+	// Gameplay tags can't change at runtime, so the ancestry of a channel never has to be invalidated
+	if (const FChannelHierarchy* CachedHierarchy = ChannelHierarchyCache.Find(Channel))
+	{
+		return *CachedHierarchy;
+	}
+
+	FChannelHierarchy& NewHierarchy = ChannelHierarchyCache.Add(Channel);
+	for (FGameplayTag Tag = Channel; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+	{
+		NewHierarchy.Add(Tag);
+	}
+
+	return NewHierarchy;
+}
+
+void UGameplayMessageSubsystem::RecordBroadcast(FGameplayTag Channel, const uint64 StartCycles)
+{
+	const double BroadcastTimeMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+	FGameplayMessageChannelStats& Stats = ChannelStats.FindOrAdd(Channel);
+	Stats.BroadcastCount++;
+	Stats.TotalTimeMs += BroadcastTimeMs;
+	Stats.MaxTimeMs = FMath::Max(Stats.MaxTimeMs, BroadcastTimeMs);
+	TotalBroadcastCount++;
+}
+
+void UGameplayMessageSubsystem::DumpChannelStats() const
+{
+	TArray<TPair<FGameplayTag, FGameplayMessageChannelStats>> SortedStats = ChannelStats.Array();
+	SortedStats.Sort([](const TPair<FGameplayTag, FGameplayMessageChannelStats>& A, const TPair<FGameplayTag, FGameplayMessageChannelStats>& B)
+	{
+		return A.Value.TotalTimeMs > B.Value.TotalTimeMs;
+	});
+
+	UE_LOG(LogGameplayMessageSubsystem, Log, TEXT("Gameplay message channel stats (%lld broadcasts):"), TotalBroadcastCount);
+	for (const TPair<FGameplayTag, FGameplayMessageChannelStats>& ChannelStat : SortedStats)
+	{
+		const FGameplayMessageChannelStats& Stats = ChannelStat.Value;
+		const double AverageTimeMs = Stats.BroadcastCount > 0 ? Stats.TotalTimeMs / Stats.BroadcastCount : 0.0;
+		UE_LOG(LogGameplayMessageSubsystem, Log, TEXT("  %s: Count=%lld Total=%.3fms Avg=%.4fms Max=%.4fms"),
+			*ChannelStat.Key.ToString(), Stats.BroadcastCount, Stats.TotalTimeMs, AverageTimeMs, Stats.MaxTimeMs);
 	}
 }
 
@@ -146,15 +237,27 @@ DEFINE_FUNCTION(UGameplayMessageSubsystem::execK2_BroadcastMessage)
 
 FGameplayMessageListenerHandle UGameplayMessageSubsystem::RegisterListenerInternal(FGameplayTag Channel, TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback, const UScriptStruct* StructType, EGameplayMessageMatch MatchType)
 {
-	FChannelListenerList& List = ListenerMap.FindOrAdd(Channel);
+	TUniquePtr<FChannelListenerList>& ListPtr = ListenerMap.FindOrAdd(Channel);
+	if (!ListPtr.IsValid())
+	{
+		ListPtr = MakeUnique<FChannelListenerList>();
+	}
+	FChannelListenerList& List = *ListPtr;
 
-	FGameplayMessageListenerData& Entry = List.Listeners.AddDefaulted_GetRef();
+	// Defers the addition if the list is being broadcast, so the listeners being iterated aren't reallocated
+	const bool bIsBroadcasting = List.BroadcastDepth > 0;
+	FGameplayMessageListenerData& Entry = bIsBroadcasting ? List.PendingListeners.AddDefaulted_GetRef() : List.Listeners.AddDefaulted_GetRef();
 	Entry.ReceivedCallback = MoveTemp(Callback);
 	Entry.ListenerStructType = StructType;
 	Entry.bHadValidType = StructType != nullptr;
 	Entry.HandleID = ++List.HandleID;
 	Entry.MatchType = MatchType;
 
+	if (!bIsBroadcasting)
+	{
+		List.ListenerIndices.Add(Entry.HandleID, List.Listeners.Num() - 1);
+	}
+
 	return FGameplayMessageListenerHandle(this, Channel, Entry.HandleID);
 }
 
@@ -174,18 +277,82 @@ void UGameplayMessageSubsystem::UnregisterListener(FGameplayMessageListenerHandl
 
 void UGameplayMessageSubsystem::UnregisterListenerInternal(FGameplayTag Channel, int32 HandleID)
 {
-	if (FChannelListenerList* pList = ListenerMap.Find(Channel))
+	const TUniquePtr<FChannelListenerList>* pListPtr = ListenerMap.Find(Channel);
+	if (!pListPtr)
 	{
-		int32 MatchIndex = pList->Listeners.IndexOfByPredicate([ID = HandleID](const FGameplayMessageListenerData& Other) { return Other.HandleID == ID; });
-		if (MatchIndex != INDEX_NONE)
+		return;
+	}
+
+	FChannelListenerList& List = **pListPtr;
+
+	int32 MatchIndex = INDEX_NONE;
+	if (List.ListenerIndices.RemoveAndCopyValue(HandleID, MatchIndex))
+	{
+		if (List.BroadcastDepth > 0)
 		{
-			pList->Listeners.RemoveAtSwap(MatchIndex);
+			// The list is being iterated, so the entry is only flagged here, and removed once the broadcast is over.
+			// NOTE: We can't reset the callback either, as we may be inside of it.
+			FGameplayMessageListenerData& Listener = List.Listeners[MatchIndex];
+			if (!Listener.bPendingRemoval)
+			{
+				Listener.bPendingRemoval = true;
+				List.NumPendingRemovals++;
+			}
 		}
-
-		if (pList->Listeners.Num() == 0)
+		else
 		{
-			ListenerMap.Remove(Channel);
+			List.Listeners.RemoveAtSwap(MatchIndex, EAllowShrinking::No);
+
+			// Fixes up the index of the listener that was swapped into the removed slot
+			if (List.Listeners.IsValidIndex(MatchIndex))
+			{
+				List.ListenerIndices.Add(List.Listeners[MatchIndex].HandleID, MatchIndex);
+			}
 		}
 	}
+	else
+	{
+		// Listeners registered during a broadcast are only indexed once they're flushed
+		List.PendingListeners.RemoveAllSwap([HandleID](const FGameplayMessageListenerData& Other) { return Other.HandleID == HandleID; });
+	}
+
+	if (List.BroadcastDepth == 0 && List.IsEmpty())
+	{
+		ListenerMap.Remove(Channel);
+	}
 }
 
+void UGameplayMessageSubsystem::FlushPendingListenerChanges(FGameplayTag Channel, FChannelListenerList& List)
+{
+	check(List.BroadcastDepth == 0);
+
+	if (List.NumPendingRemovals == 0 && List.PendingListeners.IsEmpty())
+	{
+		return;
+	}
+
+	if (List.NumPendingRemovals > 0)
+	{
+		List.Listeners.RemoveAllSwap([](const FGameplayMessageListenerData& Listener) { return Listener.bPendingRemoval; }, EAllowShrinking::No);
+		List.NumPendingRemovals = 0;
+	}
+
+	if (!List.PendingListeners.IsEmpty())
+	{
+		List.Listeners.Append(MoveTemp(List.PendingListeners));
+		List.PendingListeners.Reset();
+	}
+
+	// Removals swap listeners around, so the whole index has to be rebuilt.
+	// This only happens when listeners were registered or unregistered during a broadcast.
+	List.ListenerIndices.Reset();
+	for (int32 ListenerIndex = 0; ListenerIndex < List.Listeners.Num(); ListenerIndex++)
+	{
+		List.ListenerIndices.Add(List.Listeners[ListenerIndex].HandleID, ListenerIndex);
+	}
+
+	if (List.Listeners.IsEmpty())
+	{
+		ListenerMap.Remove(Channel);
+	}
+}
@@ -66,6 +66,32 @@ struct FGameplayMessageListenerData
 	// Adding some logging and extra variables around some potential problems with this
 	TWeakObjectPtr<const UScriptStruct> ListenerStructType = nullptr;
 	bool bHadValidType = false;
+
+	// Set when the listener is unregistered while its channel is being broadcast. The entry is only removed once the broadcast is over.
+	bool bPendingRemoval = false;
+
+	// Last broadcast struct type that passed the type check, so that we don't need to run IsChildOf for every message
+	const UScriptStruct* LastAcceptedStructType = nullptr;
+};
+
+/**
+ * Broadcast statistics for a single channel
+ */
+USTRUCT(BlueprintType)
+struct GAMEPLAYMESSAGERUNTIME_API FGameplayMessageChannelStats
+{
+	GENERATED_BODY()
+
+	// How many times a message was broadcast on this channel
+	UPROPERTY(BlueprintReadOnly, Category=Messaging)
+	int64 BroadcastCount = 0;
+
+	// Time spent dispatching messages on this channel, including nested broadcasts made by listeners
+	UPROPERTY(BlueprintReadOnly, Category=Messaging)
+	double TotalTimeMs = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category=Messaging)
+	double MaxTimeMs = 0.0;
 };
 
 /**
@@ -198,6 +224,19 @@ public:
 	 */
 	void UnregisterListener(FGameplayMessageListenerHandle Handle);
 
+	/**
+	 * @return broadcast statistics for every channel that had at least one message broadcast on it
+	 */
+	const TMap<FGameplayTag, FGameplayMessageChannelStats>& GetChannelStats() const { return ChannelStats; }
+
+	/**
+	 * @return how many messages were broadcast since this subsystem was initialized, on all channels
+	 */
+	int64 GetTotalBroadcastCount() const { return TotalBroadcastCount; }
+
+	// Logs the broadcast statistics of all channels, sorted by total time
+	void DumpChannelStats() const;
+
 protected:
 	/**
 	 * Broadcast a message on the specified channel
@@ -223,14 +262,48 @@ private:
 
 	void UnregisterListenerInternal(FGameplayTag Channel, int32 HandleID);
 
+	// Tag ancestry of a channel, starting with the channel itself and walking up to the root tag
+	using FChannelHierarchy = TArray<FGameplayTag, TInlineAllocator<8>>;
+
+	// Returns the cached ancestry of a channel, building it the first time the channel is used.
+	// NOTE: This returns a copy on purpose, as listeners may broadcast to new channels and grow the cache while we're dispatching.
+	FChannelHierarchy GetChannelHierarchy(FGameplayTag Channel);
+
+	void RecordBroadcast(FGameplayTag Channel, const uint64 StartCycles);
+
 private:
 	// List of all entries for a given channel
 	struct FChannelListenerList
 	{
 		TArray<FGameplayMessageListenerData> Listeners;
+
+		// Listeners registered while this list was being broadcast. They're appended to Listeners once the broadcast is over,
+		// so Listeners is never reallocated while we're iterating it.
+		TArray<FGameplayMessageListenerData> PendingListeners;
+
+		// Index of each listener in Listeners, by handle ID, so that unregistering doesn't need to search the list
+		TMap<int32, int32> ListenerIndices;
+
 		int32 HandleID = 0;
+
+		// How many broadcasts are currently iterating this list. Greater than 1 when a listener broadcasts on the same channel.
+		int32 BroadcastDepth = 0;
+
+		int32 NumPendingRemovals = 0;
+
+		bool IsEmpty() const { return Listeners.Num() == NumPendingRemovals && PendingListeners.IsEmpty(); }
 	};
 
+	// Applies the removals and additions that were deferred while the list was being broadcast
+	void FlushPendingListenerChanges(FGameplayTag Channel, FChannelListenerList& List);
+
 private:
-	TMap<FGameplayTag, FChannelListenerList> ListenerMap;
+	// NOTE: Lists are heap allocated so that they keep their address while listeners register new channels during a broadcast
+	TMap<FGameplayTag, TUniquePtr<FChannelListenerList>> ListenerMap;
+
+	TMap<FGameplayTag, FChannelHierarchy> ChannelHierarchyCache;
+
+	TMap<FGameplayTag, FGameplayMessageChannelStats> ChannelStats;
+
+	int64 TotalBroadcastCount = 0;
 };
@@ -40,6 +40,7 @@ public class AstroShowdown : ModuleRules
 		PrivateDependencyModuleNames.AddRange(new string[] {
             "AIModule",
             "AnimToTexture",
+            "AstroContextEffects",
 			"CommonGame",
             "CommonInput",
 			"CommonLoadingScreen",
@@ -57,6 +58,7 @@ public class AstroShowdown : ModuleRules
 			"ModularGameplayActors",
             "NiagaraCore",
             "Niagara",
+            "RenderCore",
             "StructUtils",
             "UMG"
         });
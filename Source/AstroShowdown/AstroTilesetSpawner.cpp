@@ -17,6 +17,25 @@
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogAstroTileset, Log, All);
+DEFINE_LOG_CATEGORY(LogAstroTileset);
+
+namespace AstroTilesetSpawnerVars
+{
+	static bool bIncrementalGenerationEnabled = true;
+	static FAutoConsoleVariableRef CVarIncrementalGenerationEnabled(
+		TEXT("AstroTilesetSpawner.IncrementalGenerationEnabled"),
+		bIncrementalGenerationEnabled,
+		TEXT("When enabled, tileset spawners only regenerate the spline segments that changed. When disabled, every generation starts from scratch."),
+		ECVF_Default);
+}
+
+namespace AstroTilesetSpawnerStatics
+{
+	/** Size (in cm) of each cell of the proxy mesh grid. Should be close to the size of the most common proxy meshes (i.e., doors). */
+	static constexpr float ProxyMeshCellSize = 500.f;
+}
+
 
 AAstroTilesetSpawner::AAstroTilesetSpawner() : Super()
 {
@@ -46,6 +65,16 @@ void AAstroTilesetSpawner::OnConstruction(const FTransform& Transform)
 	Generate();
 }
 
+#if WITH_EDITOR
+void AAstroTilesetSpawner::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	// Undo restores the spawned meshes without going through generation, so the caches can no longer be trusted
+	TilesetCaches.Reset();
+}
+#endif
+
 namespace AstroUtils
 {
 	namespace Private
@@ -81,18 +110,33 @@ void AAstroTilesetSpawner::Generate()
 		return;
 	}
 
-	// Clears everything before starting
-	ClearAllMeshes();
-	CacheProxyMeshBounds();
+	DECLARE_SCOPE_CYCLE_COUNTER(TEXT("Generate Tilesets"), STAT_AstroTilesetSpawnerGenerate, STATGROUP_Game);
+	const double GenerationStartTime = FPlatformTime::Seconds();
+	GenerationStats = FAstroTilesetGenerationStats();
 
 	// Reorigins the spline
 	SplineComponent->SetRelativeLocation(FVector::ZeroVector);
 
+	CacheProxyMeshBounds();
+
+	// Incremental generation relies on the caches matching the spawned meshes. If they don't (e.g., the spawner was just loaded), clears everything before starting.
+	if (!AstroTilesetSpawnerVars::bIncrementalGenerationEnabled || TilesetCaches.Num() != Tilesets.Num() || !AreTilesetCachesValid())
+	{
+		ClearAllMeshes();
+		TilesetCaches.Reset();
+		TilesetCaches.SetNum(Tilesets.Num());
+	}
+
 	// Generates all tilesets
-	for (const FAstroTilesetInfo& Tileset : Tilesets)
+	const uint32 SplineHash = ComputeSplineHash();
+	for (int32 TilesetIndex = 0; TilesetIndex < Tilesets.Num(); TilesetIndex++)
 	{
-		GenerateTileset(Tileset);
+		GenerateTileset(Tilesets[TilesetIndex], SplineHash, TilesetCaches[TilesetIndex]);
 	}
+
+	GenerationStats.GenerationMs = static_cast<float>((FPlatformTime::Seconds() - GenerationStartTime) * 1000.0);
+	UE_LOG(LogAstroTileset, Verbose, TEXT("[%hs] %s: Regenerated %d segments, reused %d segments, updated %d instances (%.2fms)"), __FUNCTION__, *GetName(),
+		GenerationStats.RegeneratedSegments, GenerationStats.ReusedSegments, GenerationStats.UpdatedInstances, GenerationStats.GenerationMs);
 }
 
 namespace AstroUtils
@@ -115,10 +159,67 @@ namespace AstroUtils
 			const FBoxSphereBounds MeshBounds = Mesh->GetBounds();
 			return FMath::RoundToFloat(MeshBounds.BoxExtent.X * 2.f);
 		}
+
+		const FISMComponentDescriptor* GetMeshDescriptor(const UAstroTilesetData* TilesetData, const int32 MeshDescriptorIndex)
+		{
+			if (!TilesetData)
+			{
+				return nullptr;
+			}
+
+			// NOTE: INDEX_NONE stands for the corner mesh
+			const TInstancedStruct<FISMComponentDescriptor>* MeshDescriptor = MeshDescriptorIndex == INDEX_NONE ? &TilesetData->CornerMeshDescriptor
+				: TilesetData->BaseMeshDescriptors.IsValidIndex(MeshDescriptorIndex) ? &TilesetData->BaseMeshDescriptors[MeshDescriptorIndex] : nullptr;
+			return MeshDescriptor && MeshDescriptor->IsValid() ? MeshDescriptor->GetPtr() : nullptr;
+		}
+
+		template <typename T>
+		uint32 HashValue(const T& Value, const uint32 Hash)
+		{
+			return FCrc::MemCrc32(&Value, sizeof(T), Hash);
+		}
+
+		uint32 HashGenerationState(const TBitArray<>& ConsumedProxies, const int32 PickedMeshIndex)
+		{
+			uint32 Hash = HashValue(PickedMeshIndex, 0);
+			for (TConstSetBitIterator<> It(ConsumedProxies); It; ++It)
+			{
+				Hash = HashValue(It.GetIndex(), Hash);
+			}
+			return Hash;
+		}
+
+		uint32 ComputeTilesetHash(const FAstroTilesetInfo& InTileset, const TArray<float>& BaseMeshLengths)
+		{
+			const UAstroTilesetData* TilesetData = InTileset.TilesetData;
+			uint32 Hash = HashValue(TilesetData, 0);
+			Hash = HashValue(InTileset.PositionOffset, Hash);
+			Hash = HashValue(InTileset.RotationOffset, Hash);
+			Hash = HashValue(InTileset.CornerFilter, Hash);
+			if (TilesetData)
+			{
+				Hash = HashValue(TilesetData->FillPolicy, Hash);
+				Hash = HashValue(static_cast<bool>(TilesetData->bIgnoreProxyMeshes), Hash);
+				for (int32 MeshDescriptorIndex = INDEX_NONE; MeshDescriptorIndex < TilesetData->BaseMeshDescriptors.Num(); MeshDescriptorIndex++)
+				{
+					const FISMComponentDescriptor* MeshDescriptor = GetMeshDescriptor(TilesetData, MeshDescriptorIndex);
+					Hash = HashValue(MeshDescriptor ? MeshDescriptor->ComputeHash() : 0u, Hash);
+				}
+			}
+
+			// NOTE: Mesh lengths are part of the hash, so that reimporting a mesh with different bounds regenerates the tileset
+			for (const float MeshLength : BaseMeshLengths)
+			{
+				Hash = HashValue(MeshLength, Hash);
+			}
+
+			// NOTE: Zero is reserved for caches that were never generated
+			return Hash != 0 ? Hash : 1;
+		}
 	}
 }
 
-void AAstroTilesetSpawner::GenerateTileset(const FAstroTilesetInfo& InTileset)
+void AAstroTilesetSpawner::GenerateTileset(const FAstroTilesetInfo& InTileset, const uint32 SplineHash, FAstroTilesetCache& TilesetCache)
 {
 	if (!SplineComponent)
 	{
@@ -128,99 +229,211 @@ void AAstroTilesetSpawner::GenerateTileset(const FAstroTilesetInfo& InTileset)
 	UAstroTilesetData* TilesetData = InTileset.TilesetData;
 	if (!TilesetData || TilesetData->BaseMeshDescriptors.IsEmpty())
 	{
+		for (const TPair<int32, TWeakObjectPtr<UInstancedStaticMeshComponent>>& MeshComponent : TilesetCache.MeshComponents)
+		{
+			if (MeshComponent.Value.IsValid())
+			{
+				MeshComponent.Value->DestroyComponent();
+			}
+		}
+		TilesetCache = FAstroTilesetCache();
 		return;
 	}
 
-	using FAstroTilesetInfoBatcher = TMap<const FISMComponentDescriptor*, TArray<FTransform>>;
-	FAstroTilesetInfoBatcher Batcher;
+	// Caches the length of each mesh once, instead of once per sample
+	TArray<float> BaseMeshLengths;
+	BaseMeshLengths.Reserve(TilesetData->BaseMeshDescriptors.Num());
+	for (const TInstancedStruct<FISMComponentDescriptor>& MeshDescriptor : TilesetData->BaseMeshDescriptors)
+	{
+		BaseMeshLengths.Add(AstroUtils::Private::GetMeshLengthX(MeshDescriptor));
+	}
+
+	// If the tileset settings changed, every segment and mesh has to be regenerated from scratch
+	const uint32 TilesetHash = AstroUtils::Private::ComputeTilesetHash(InTileset, BaseMeshLengths);
+	if (TilesetCache.TilesetHash != TilesetHash)
+	{
+		for (const TPair<int32, TWeakObjectPtr<UInstancedStaticMeshComponent>>& MeshComponent : TilesetCache.MeshComponents)
+		{
+			if (MeshComponent.Value.IsValid())
+			{
+				MeshComponent.Value->DestroyComponent();
+			}
+		}
+		TilesetCache = FAstroTilesetCache();
+		TilesetCache.TilesetHash = TilesetHash;
+	}
+
+	// Maps each mesh descriptor that was touched to whether its instance count changed
+	// NOTE: Segments own contiguous instance ranges, so a count change shifts every range after it, and the whole mesh has to be rebuilt
+	TMap<int32, bool> DirtyMeshes;
+	TArray<int32> DirtySegmentIndices;
 
-	int32 PickedMeshIndex = -1;		// NOTE: We keep this at an outer scope because we reuse it when calculating the alternate fill method
-	const int32 SplineSegmentCount = SplineComponent->GetNumberOfSplineSegments();
 	const int32 SplinePointCount = SplineComponent->GetNumberOfSplinePoints();
-	TArray<FBox> LocalProxyMeshBounds = ProxyMeshBounds;
-	for (int32 CurrentPointIndex = 0; CurrentPointIndex < SplineSegmentCount; CurrentPointIndex++)
+	const int32 SplineSegmentCount = FMath::Max(FMath::Min(SplineComponent->GetNumberOfSplineSegments(), SplinePointCount - 1), 0);
+	for (int32 RemovedSegmentIndex = SplineSegmentCount; RemovedSegmentIndex < TilesetCache.Segments.Num(); RemovedSegmentIndex++)
 	{
-		const int32 NextPointIndex = CurrentPointIndex + 1;
-		if (CurrentPointIndex >= SplinePointCount || NextPointIndex >= SplinePointCount)
+		for (const TPair<int32, TArray<FTransform>>& SegmentInstances : TilesetCache.Segments[RemovedSegmentIndex].InstanceTransforms)
 		{
-			break;
+			DirtyMeshes.Add(SegmentInstances.Key, true);
 		}
+	}
+	TilesetCache.Segments.SetNum(SplineSegmentCount);
 
-		// Generates mesh descriptors + instances for the line segment using the fill policy
-		const float SegmentStartDistance = SplineComponent->GetDistanceAlongSplineAtSplinePoint(CurrentPointIndex);
-		const float SegmentEndDistance = SplineComponent->GetDistanceAlongSplineAtSplinePoint(NextPointIndex);
-		float CurrentSegmentDistance = SegmentStartDistance;
-		while (CurrentSegmentDistance < SegmentEndDistance)
+	// Generates mesh instances for each dirty segment, carrying the generation state over from segment to segment
+	// NOTE: We keep the picked mesh at an outer scope because we reuse it when calculating the alternate fill method
+	TBitArray<> ConsumedProxies(false, ProxyMeshBounds.Num());
+	int32 PickedMeshIndex = INDEX_NONE;
+	for (int32 SegmentIndex = 0; SegmentIndex < SplineSegmentCount; SegmentIndex++)
+	{
+		FAstroTilesetSegmentCache& SegmentCache = TilesetCache.Segments[SegmentIndex];
+		uint32 SegmentHash = HashCombineFast(SplineHash, ComputeSegmentHash(SegmentIndex));
+		SegmentHash = HashCombineFast(SegmentHash, AstroUtils::Private::HashGenerationState(ConsumedProxies, PickedMeshIndex));
+		if (SegmentCache.InputHash == SegmentHash)
 		{
-			switch (TilesetData->FillPolicy)
-			{
-			case EAstroTilesetFillPolicy::Greedy:
-				PickGreedyMesh(TilesetData, CurrentSegmentDistance, SegmentEndDistance, OUT PickedMeshIndex);
-				break;
-			case EAstroTilesetFillPolicy::Alternate:
-				PickAlternatedMesh(TilesetData, OUT PickedMeshIndex);
-				break;
-			}
+			ConsumedProxies = SegmentCache.ConsumedProxies;
+			PickedMeshIndex = SegmentCache.PickedMeshIndex;
+			GenerationStats.ReusedSegments++;
+			continue;
+		}
 
-			if (!TilesetData->BaseMeshDescriptors.IsValidIndex(PickedMeshIndex))
-			{
-				break;
-			}
+		TMap<int32, TArray<FTransform>> PreviousInstanceTransforms = MoveTemp(SegmentCache.InstanceTransforms);
+		SegmentCache.InstanceTransforms.Reset();
+		GenerateSegment(InTileset, BaseMeshLengths, SegmentIndex, ConsumedProxies, PickedMeshIndex, OUT SegmentCache.InstanceTransforms);
+		SegmentCache.InputHash = SegmentHash;
+		SegmentCache.ConsumedProxies = ConsumedProxies;
+		SegmentCache.PickedMeshIndex = PickedMeshIndex;
 
-			const TInstancedStruct<FISMComponentDescriptor>& MeshDescriptor = TilesetData->BaseMeshDescriptors[PickedMeshIndex];
-			const FISMComponentDescriptor* MeshDescriptorPtr = MeshDescriptor.IsValid() ? MeshDescriptor.GetPtr() : nullptr;
-			if (!MeshDescriptorPtr)
+		for (const TPair<int32, TArray<FTransform>>& SegmentInstances : SegmentCache.InstanceTransforms)
+		{
+			const TArray<FTransform>* PreviousSegmentInstances = PreviousInstanceTransforms.Find(SegmentInstances.Key);
+			const bool bInstanceCountChanged = !PreviousSegmentInstances || PreviousSegmentInstances->Num() != SegmentInstances.Value.Num();
+			DirtyMeshes.FindOrAdd(SegmentInstances.Key, false) |= bInstanceCountChanged;
+		}
+		for (const TPair<int32, TArray<FTransform>>& PreviousSegmentInstances : PreviousInstanceTransforms)
+		{
+			if (!SegmentCache.InstanceTransforms.Contains(PreviousSegmentInstances.Key))
 			{
-				break;
+				DirtyMeshes.Add(PreviousSegmentInstances.Key, true);
 			}
+		}
+
+		DirtySegmentIndices.Add(SegmentIndex);
+		GenerationStats.RegeneratedSegments++;
+	}
+
+	// Generates one mesh instance for the corner mesh on top of each vertex
+	// NOTE: Corners are cheap, so they're always regenerated, and only rebuilt if any of them changed
+	TArray<FTransform> CornerTransforms;
+	GenerateCorners(InTileset, OUT CornerTransforms);
+	bool bCornersChanged = CornerTransforms.Num() != TilesetCache.CornerTransforms.Num() || (!CornerTransforms.IsEmpty() && !TilesetCache.MeshComponents.Contains(INDEX_NONE));
+	for (int32 CornerIndex = 0; CornerIndex < CornerTransforms.Num() && !bCornersChanged; CornerIndex++)
+	{
+		bCornersChanged = !CornerTransforms[CornerIndex].Equals(TilesetCache.CornerTransforms[CornerIndex]);
+	}
+	if (bCornersChanged)
+	{
+		TilesetCache.CornerTransforms = MoveTemp(CornerTransforms);
+		DirtyMeshes.Add(INDEX_NONE, true);
+	}
+
+	// Spawns or updates the meshes of every dirty segment
+	for (const TPair<int32, bool>& DirtyMesh : DirtyMeshes)
+	{
+		if (DirtyMesh.Value)
+		{
+			RebuildMeshInstances(TilesetData, TilesetCache, DirtyMesh.Key);
+		}
+	}
 
-			const float MeshLength = AstroUtils::Private::GetMeshLengthX(MeshDescriptor);
-			if (MeshLength == 0.f)
+	for (const int32 DirtySegmentIndex : DirtySegmentIndices)
+	{
+		for (const TPair<int32, TArray<FTransform>>& SegmentInstances : TilesetCache.Segments[DirtySegmentIndex].InstanceTransforms)
+		{
+			if (const bool* bRebuilt = DirtyMeshes.Find(SegmentInstances.Key); bRebuilt && !*bRebuilt)
 			{
-				break;
+				UpdateMeshInstanceRange(TilesetCache, SegmentInstances.Key, DirtySegmentIndex);
 			}
+		}
+	}
+}
 
-			// If the mesh is intersecting with any of the proxy meshes, then don't spawn it
-			const float TargetSegmentDistance = FMath::Clamp(CurrentSegmentDistance + MeshLength, SegmentStartDistance, SegmentEndDistance);
-			const float HalfMeshSegment = (CurrentSegmentDistance + TargetSegmentDistance) / 2.f;
-			FBox HitSamplingFilterMask = FBox(ForceInitToZero);
-			if (!TilesetData->bIgnoreProxyMeshes && (
-				IsSplinePointWithinProxyMeshBounds(CurrentSegmentDistance, LocalProxyMeshBounds, OUT HitSamplingFilterMask)
-				|| IsSplinePointWithinProxyMeshBounds(HalfMeshSegment, LocalProxyMeshBounds, OUT HitSamplingFilterMask)))
-			{
-				const float ProxyBoundSize = HitSamplingFilterMask.GetExtent().X * 2.f;
-				CurrentSegmentDistance += ProxyBoundSize;
+void AAstroTilesetSpawner::GenerateSegment(const FAstroTilesetInfo& InTileset, const TArray<float>& BaseMeshLengths, const int32 SegmentIndex, TBitArray<>& ConsumedProxies, int32& PickedMeshIndex, OUT TMap<int32, TArray<FTransform>>& OutInstanceTransforms) const
+{
+	const UAstroTilesetData* TilesetData = InTileset.TilesetData;
+	if (!SplineComponent || !TilesetData)
+	{
+		return;
+	}
 
-				LocalProxyMeshBounds.Remove(HitSamplingFilterMask);
-				continue;
-			}
+	// Generates mesh descriptors + instances for the line segment using the fill policy
+	const float SegmentStartDistance = SplineComponent->GetDistanceAlongSplineAtSplinePoint(SegmentIndex);
+	const float SegmentEndDistance = SplineComponent->GetDistanceAlongSplineAtSplinePoint(SegmentIndex + 1);
+	float CurrentSegmentDistance = SegmentStartDistance;
+	while (CurrentSegmentDistance < SegmentEndDistance)
+	{
+		switch (TilesetData->FillPolicy)
+		{
+		case EAstroTilesetFillPolicy::Greedy:
+			PickGreedyMesh(BaseMeshLengths, CurrentSegmentDistance, SegmentEndDistance, OUT PickedMeshIndex);
+			break;
+		case EAstroTilesetFillPolicy::Alternate:
+			PickAlternatedMesh(TilesetData, OUT PickedMeshIndex);
+			break;
+		}
 
-			// Spawns the mesh at halfway along the distance between the mesh segment start and end
-			// NOTE: This assumes that the meshes are pivoted around their center.
-			const float CurrentInputKey = SplineComponent->GetInputKeyValueAtDistanceAlongSpline(HalfMeshSegment);
-			const FVector CurrentSplinePosition = SplineComponent->GetLocationAtSplineInputKey(CurrentInputKey, ESplineCoordinateSpace::World);
-			const FRotator CurrentSplineRotation = SplineComponent->GetRotationAtDistanceAlongSpline(HalfMeshSegment, ESplineCoordinateSpace::World);
+		if (!AstroUtils::Private::GetMeshDescriptor(TilesetData, PickedMeshIndex) || !BaseMeshLengths.IsValidIndex(PickedMeshIndex))
+		{
+			break;
+		}
 
-			FTransform MeshTransform;
-			MeshTransform.SetTranslation(CurrentSplinePosition);
-			MeshTransform.SetRotation((CurrentSplineRotation + InTileset.RotationOffset).Quaternion());
-			MeshTransform.SetScale3D(FVector::OneVector);
+		const float MeshLength = BaseMeshLengths[PickedMeshIndex];
+		if (MeshLength == 0.f)
+		{
+			break;
+		}
 
-			Batcher.FindOrAdd(MeshDescriptorPtr).Add(MeshTransform);
+		// If the mesh is intersecting with any of the proxy meshes, then don't spawn it
+		const float TargetSegmentDistance = FMath::Clamp(CurrentSegmentDistance + MeshLength, SegmentStartDistance, SegmentEndDistance);
+		const float HalfMeshSegment = (CurrentSegmentDistance + TargetSegmentDistance) / 2.f;
+		int32 HitProxyIndex = INDEX_NONE;
+		if (!TilesetData->bIgnoreProxyMeshes && (
+			IsSplinePointWithinProxyMeshBounds(CurrentSegmentDistance, ConsumedProxies, OUT HitProxyIndex)
+			|| IsSplinePointWithinProxyMeshBounds(HalfMeshSegment, ConsumedProxies, OUT HitProxyIndex)))
+		{
+			const float ProxyBoundSize = ProxyMeshBounds[HitProxyIndex].GetExtent().X * 2.f;
+			CurrentSegmentDistance += ProxyBoundSize;
 
-			CurrentSegmentDistance = TargetSegmentDistance;
+			ConsumedProxies[HitProxyIndex] = true;
+			continue;
 		}
+
+		// Spawns the mesh at halfway along the distance between the mesh segment start and end
+		// NOTE: This assumes that the meshes are pivoted around their center.
+		const float CurrentInputKey = SplineComponent->GetInputKeyValueAtDistanceAlongSpline(HalfMeshSegment);
+		const FVector CurrentSplinePosition = SplineComponent->GetLocationAtSplineInputKey(CurrentInputKey, ESplineCoordinateSpace::World);
+		const FRotator CurrentSplineRotation = SplineComponent->GetRotationAtDistanceAlongSpline(HalfMeshSegment, ESplineCoordinateSpace::World);
+
+		FTransform MeshTransform;
+		MeshTransform.SetTranslation(CurrentSplinePosition);
+		MeshTransform.SetRotation((CurrentSplineRotation + InTileset.RotationOffset).Quaternion());
+		MeshTransform.SetScale3D(FVector::OneVector);
+
+		OutInstanceTransforms.FindOrAdd(PickedMeshIndex).Add(MeshTransform);
+
+		CurrentSegmentDistance = TargetSegmentDistance;
 	}
-	
-	// Generates one mesh descriptor for the corner mesh on top of each vertex
-	for (int32 CurrentPointIndex = 0; CurrentPointIndex < SplinePointCount; CurrentPointIndex++)
+}
+
+void AAstroTilesetSpawner::GenerateCorners(const FAstroTilesetInfo& InTileset, OUT TArray<FTransform>& OutCornerTransforms) const
+{
+	if (!SplineComponent || !AstroUtils::Private::GetMeshDescriptor(InTileset.TilesetData, INDEX_NONE))
 	{
-		const FISMComponentDescriptor* CornerMeshDescriptorPtr = TilesetData->CornerMeshDescriptor.IsValid() ? TilesetData->CornerMeshDescriptor.GetPtr() : nullptr;
-		if (!CornerMeshDescriptorPtr)
-		{
-			break;
-		}
+		return;
+	}
 
+	const int32 SplinePointCount = SplineComponent->GetNumberOfSplinePoints();
+	for (int32 CurrentPointIndex = 0; CurrentPointIndex < SplinePointCount; CurrentPointIndex++)
+	{
 		const uint8 IgnoreFirstFlag = static_cast<uint8>(EAstroTilesetCornerFilter::IgnoreFirst);
 		if (CurrentPointIndex == 0 && (InTileset.CornerFilter & IgnoreFirstFlag))
 		{
@@ -248,36 +461,157 @@ void AAstroTilesetSpawner::GenerateTileset(const FAstroTilesetInfo& InTileset)
 		MeshTransform.SetTranslation(CurrentSplinePosition);
 		MeshTransform.SetRotation((CurrentSplineRotation + InTileset.RotationOffset).Quaternion());
 		MeshTransform.SetScale3D(FVector::OneVector);
-		Batcher.FindOrAdd(CornerMeshDescriptorPtr).Add(MeshTransform);
+		OutCornerTransforms.Add(MeshTransform);
 	}
+}
 
-	// Spawns all mesh descriptors and their instances
-	TSet<const FISMComponentDescriptor*> BatchedMeshes;
-	Batcher.GetKeys(OUT BatchedMeshes);
-	for (const FISMComponentDescriptor* MeshDescriptorPtr : BatchedMeshes)
+void AAstroTilesetSpawner::RebuildMeshInstances(const UAstroTilesetData* TilesetData, FAstroTilesetCache& TilesetCache, const int32 MeshDescriptorIndex)
+{
+	TArray<FTransform> InstanceTransforms;
+	if (MeshDescriptorIndex == INDEX_NONE)
+	{
+		InstanceTransforms = TilesetCache.CornerTransforms;
+	}
+	else
 	{
-		if (!MeshDescriptorPtr)
+		for (const FAstroTilesetSegmentCache& SegmentCache : TilesetCache.Segments)
 		{
-			continue;
+			if (const TArray<FTransform>* SegmentInstances = SegmentCache.InstanceTransforms.Find(MeshDescriptorIndex))
+			{
+				InstanceTransforms.Append(*SegmentInstances);
+			}
 		}
+	}
 
-		const TArray<FTransform>& InstanceTransforms = Batcher[MeshDescriptorPtr];
-		if (InstanceTransforms.IsEmpty())
+	UInstancedStaticMeshComponent* MeshComponent = TilesetCache.MeshComponents.FindRef(MeshDescriptorIndex).Get();
+	const FISMComponentDescriptor* MeshDescriptorPtr = AstroUtils::Private::GetMeshDescriptor(TilesetData, MeshDescriptorIndex);
+	if (InstanceTransforms.IsEmpty() || !MeshDescriptorPtr)
+	{
+		if (MeshComponent)
 		{
-			continue;
+			MeshComponent->DestroyComponent();
 		}
+		TilesetCache.MeshComponents.Remove(MeshDescriptorIndex);
+		return;
+	}
 
+	if (!MeshComponent)
+	{
 		// NOTE: We need to use this method to ensure that the component is serialized and shows up on the editor
-		UInstancedStaticMeshComponent* MeshComponent = CastChecked<UInstancedStaticMeshComponent>(UAstroUtilitiesBlueprintLibrary::AddInstancedComponent(this, this, MeshDescriptorPtr->ComponentClass));
+		MeshComponent = CastChecked<UInstancedStaticMeshComponent>(UAstroUtilitiesBlueprintLibrary::AddInstancedComponent(this, this, MeshDescriptorPtr->ComponentClass));
 		MeshDescriptorPtr->InitComponent(MeshComponent);
 		MeshComponent->SetMobility(EComponentMobility::Static);
 		MeshComponent->AttachToComponent(MeshContainerComponent, FAttachmentTransformRules::KeepRelativeTransform);
+		TilesetCache.MeshComponents.Add(MeshDescriptorIndex, MeshComponent);
+	}
+
+	// Initializes all instances
+	constexpr bool bReturnIndices = false;
+	constexpr bool bWorldSpace = true;
+	MeshComponent->ClearInstances();
+	MeshComponent->AddInstances(InstanceTransforms, bReturnIndices, bWorldSpace);
+	GenerationStats.UpdatedInstances += InstanceTransforms.Num();
+}
 
-		// Initializes all instances
-		constexpr bool bReturnIndices = false;
-		constexpr bool bWorldSpace = true;
-		MeshComponent->AddInstances(InstanceTransforms, bReturnIndices, bWorldSpace);
+void AAstroTilesetSpawner::UpdateMeshInstanceRange(FAstroTilesetCache& TilesetCache, const int32 MeshDescriptorIndex, const int32 SegmentIndex)
+{
+	UInstancedStaticMeshComponent* MeshComponent = TilesetCache.MeshComponents.FindRef(MeshDescriptorIndex).Get();
+	const TArray<FTransform>* SegmentInstances = TilesetCache.Segments[SegmentIndex].InstanceTransforms.Find(MeshDescriptorIndex);
+	if (!ensure(MeshComponent) || !SegmentInstances)
+	{
+		return;
 	}
+
+	// Finds where this segment's range starts, by skipping the instances of every segment before it
+	int32 StartInstanceIndex = 0;
+	for (int32 PreviousSegmentIndex = 0; PreviousSegmentIndex < SegmentIndex; PreviousSegmentIndex++)
+	{
+		if (const TArray<FTransform>* PreviousSegmentInstances = TilesetCache.Segments[PreviousSegmentIndex].InstanceTransforms.Find(MeshDescriptorIndex))
+		{
+			StartInstanceIndex += PreviousSegmentInstances->Num();
+		}
+	}
+
+	constexpr bool bWorldSpace = true;
+	constexpr bool bMarkRenderStateDirty = true;
+	constexpr bool bTeleport = true;
+	MeshComponent->BatchUpdateInstancesTransforms(StartInstanceIndex, *SegmentInstances, bWorldSpace, bMarkRenderStateDirty, bTeleport);
+	GenerationStats.UpdatedInstances += SegmentInstances->Num();
+}
+
+bool AAstroTilesetSpawner::AreTilesetCachesValid() const
+{
+	for (const FAstroTilesetCache& TilesetCache : TilesetCaches)
+	{
+		for (const TPair<int32, TWeakObjectPtr<UInstancedStaticMeshComponent>>& MeshComponent : TilesetCache.MeshComponents)
+		{
+			if (!MeshComponent.Value.IsValid())
+			{
+				return false;
+			}
+
+			int32 ExpectedInstanceCount = 0;
+			if (MeshComponent.Key == INDEX_NONE)
+			{
+				ExpectedInstanceCount = TilesetCache.CornerTransforms.Num();
+			}
+			else
+			{
+				for (const FAstroTilesetSegmentCache& SegmentCache : TilesetCache.Segments)
+				{
+					const TArray<FTransform>* SegmentInstances = SegmentCache.InstanceTransforms.Find(MeshComponent.Key);
+					ExpectedInstanceCount += SegmentInstances ? SegmentInstances->Num() : 0;
+				}
+			}
+
+			if (MeshComponent.Value->GetInstanceCount() != ExpectedInstanceCount)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+uint32 AAstroTilesetSpawner::ComputeSplineHash() const
+{
+	// NOTE: Anything that affects every segment goes here (i.e., the spline's transform, and the proxy meshes)
+	const FTransform SplineTransform = SplineComponent ? SplineComponent->GetComponentTransform() : FTransform::Identity;
+	uint32 Hash = AstroUtils::Private::HashValue(SplineTransform.GetLocation(), 0);
+	Hash = AstroUtils::Private::HashValue(SplineTransform.GetRotation(), Hash);
+	Hash = AstroUtils::Private::HashValue(SplineTransform.GetScale3D(), Hash);
+	if (SplineComponent)
+	{
+		Hash = AstroUtils::Private::HashValue(SplineComponent->ReparamStepsPerSegment, Hash);
+		Hash = AstroUtils::Private::HashValue(SplineComponent->IsClosedLoop(), Hash);
+	}
+
+	for (const FBox& ProxyMeshBox : ProxyMeshBounds)
+	{
+		Hash = AstroUtils::Private::HashValue(ProxyMeshBox.Min, Hash);
+		Hash = AstroUtils::Private::HashValue(ProxyMeshBox.Max, Hash);
+	}
+
+	return Hash;
+}
+
+uint32 AAstroTilesetSpawner::ComputeSegmentHash(const int32 SegmentIndex) const
+{
+	// NOTE: A segment's shape only depends on its two spline points, as their tangents are stored along with them
+	uint32 Hash = 0;
+	for (const int32 SplinePointIndex : { SegmentIndex, SegmentIndex + 1 })
+	{
+		const FSplinePoint SplinePoint = SplineComponent->GetSplinePointAt(SplinePointIndex, ESplineCoordinateSpace::Local);
+		Hash = AstroUtils::Private::HashValue(SplinePoint.InputKey, Hash);
+		Hash = AstroUtils::Private::HashValue(SplinePoint.Position, Hash);
+		Hash = AstroUtils::Private::HashValue(SplinePoint.ArriveTangent, Hash);
+		Hash = AstroUtils::Private::HashValue(SplinePoint.LeaveTangent, Hash);
+		Hash = AstroUtils::Private::HashValue(SplinePoint.Rotation, Hash);
+		Hash = AstroUtils::Private::HashValue(SplinePoint.Type, Hash);
+	}
+
+	return Hash;
 }
 
 void AAstroTilesetSpawner::ClearAllMeshes()
@@ -289,6 +623,7 @@ void AAstroTilesetSpawner::ClearAllMeshes()
 void AAstroTilesetSpawner::CacheProxyMeshBounds()
 {
 	ProxyMeshBounds.Empty();
+	ProxyMeshCells.Reset();
 
 	for (const TSubclassOf<AActor>& SamplingFilterClass : ProxyMeshClasses)
 	{
@@ -311,9 +646,26 @@ void AAstroTilesetSpawner::CacheProxyMeshBounds()
 			}
 		}
 	}
+
+	// Bins every proxy in all the cells its bounds overlap, so that each sample only has to test the proxies around it
+	for (int32 ProxyIndex = 0; ProxyIndex < ProxyMeshBounds.Num(); ProxyIndex++)
+	{
+		const FBox& ProxyBounds = ProxyMeshBounds[ProxyIndex];
+		const int32 MinCellX = FMath::FloorToInt32(ProxyBounds.Min.X / AstroTilesetSpawnerStatics::ProxyMeshCellSize);
+		const int32 MinCellY = FMath::FloorToInt32(ProxyBounds.Min.Y / AstroTilesetSpawnerStatics::ProxyMeshCellSize);
+		const int32 MaxCellX = FMath::FloorToInt32(ProxyBounds.Max.X / AstroTilesetSpawnerStatics::ProxyMeshCellSize);
+		const int32 MaxCellY = FMath::FloorToInt32(ProxyBounds.Max.Y / AstroTilesetSpawnerStatics::ProxyMeshCellSize);
+		for (int32 CellX = MinCellX; CellX <= MaxCellX; CellX++)
+		{
+			for (int32 CellY = MinCellY; CellY <= MaxCellY; CellY++)
+			{
+				ProxyMeshCells.FindOrAdd(FIntPoint(CellX, CellY)).Add(ProxyIndex);
+			}
+		}
+	}
 }
 
-bool AAstroTilesetSpawner::IsSplinePointWithinProxyMeshBounds(const float DistanceAlongSpline, const TArray<FBox>& InProxyMeshBounds, OUT FBox& OutHitMask) const
+bool AAstroTilesetSpawner::IsSplinePointWithinProxyMeshBounds(const float DistanceAlongSpline, const TBitArray<>& ConsumedProxies, OUT int32& OutProxyIndex) const
 {
 	if (!SplineComponent)
 	{
@@ -321,11 +673,22 @@ bool AAstroTilesetSpawner::IsSplinePointWithinProxyMeshBounds(const float Distan
 	}
 
 	const FVector SplinePosition = SplineComponent->GetLocationAtDistanceAlongSpline(DistanceAlongSpline, ESplineCoordinateSpace::World);
-	for (const FBox& ProxyMeshBox : InProxyMeshBounds)
+	const FIntPoint SplinePositionCell = FIntPoint(
+		FMath::FloorToInt32(SplinePosition.X / AstroTilesetSpawnerStatics::ProxyMeshCellSize),
+		FMath::FloorToInt32(SplinePosition.Y / AstroTilesetSpawnerStatics::ProxyMeshCellSize));
+
+	const TArray<int32>* CellProxyIndices = ProxyMeshCells.Find(SplinePositionCell);
+	if (!CellProxyIndices)
 	{
-		if (FMath::PointBoxIntersection(SplinePosition, ProxyMeshBox))
+		return false;
+	}
+
+	// NOTE: Proxies are binned in index order, so the first hit is always the one with the lowest index
+	for (const int32 ProxyIndex : *CellProxyIndices)
+	{
+		if (!ConsumedProxies[ProxyIndex] && FMath::PointBoxIntersection(SplinePosition, ProxyMeshBounds[ProxyIndex]))
 		{
-			OutHitMask = ProxyMeshBox;
+			OutProxyIndex = ProxyIndex;
 			return true;
 		}
 	}
@@ -333,29 +696,18 @@ bool AAstroTilesetSpawner::IsSplinePointWithinProxyMeshBounds(const float Distan
 	return false;
 }
 
-void AAstroTilesetSpawner::PickGreedyMesh(const UAstroTilesetData* TilesetData, const float DistanceAlongSplineA, const float DistanceAlongSplineB, OUT int32& OutMeshDescriptorIndex)
+void AAstroTilesetSpawner::PickGreedyMesh(const TArray<float>& BaseMeshLengths, const float DistanceAlongSplineA, const float DistanceAlongSplineB, OUT int32& OutMeshDescriptorIndex) const
 {
-	if (!TilesetData)
-	{
-		return;
-	}
-
-	ensure(TilesetData->BaseMeshDescriptors.Num() > 0);
+	ensure(BaseMeshLengths.Num() > 0);
 
 	float CurrentMeshLength = -1.f;
 
 	const float SegmentLength = DistanceAlongSplineB - DistanceAlongSplineA;
-	const int32 BaseMeshCount = TilesetData->BaseMeshDescriptors.Num();
+	const int32 BaseMeshCount = BaseMeshLengths.Num();
 	for (int32 BaseMeshIndex = 0; BaseMeshIndex < BaseMeshCount; BaseMeshIndex++)
 	{
-		TInstancedStruct<FISMComponentDescriptor> CurrentMeshDescriptor = TilesetData->BaseMeshDescriptors[BaseMeshIndex];
-		if (!CurrentMeshDescriptor.IsValid())
-		{
-			continue;
-		}
-
 		// Picks the largest mesh, or uses the first one as default if none would fit
-		const float MeshSize = AstroUtils::Private::GetMeshLengthX(CurrentMeshDescriptor);
+		const float MeshSize = BaseMeshLengths[BaseMeshIndex];
 		if (BaseMeshIndex == 0 || (MeshSize > CurrentMeshLength && MeshSize <= SegmentLength) || (CurrentMeshLength > SegmentLength && MeshSize <= SegmentLength))
 		{
 			OutMeshDescriptorIndex = BaseMeshIndex;
@@ -365,7 +717,7 @@ void AAstroTilesetSpawner::PickGreedyMesh(const UAstroTilesetData* TilesetData,
 	}
 }
 
-void AAstroTilesetSpawner::PickAlternatedMesh(const UAstroTilesetData* TilesetData, OUT int32& OutMeshDescriptorIndex)
+void AAstroTilesetSpawner::PickAlternatedMesh(const UAstroTilesetData* TilesetData, OUT int32& OutMeshDescriptorIndex) const
 {
 	OutMeshDescriptorIndex = -1;
 
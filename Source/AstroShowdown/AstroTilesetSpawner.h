@@ -12,6 +12,7 @@
 #include "AstroTilesetSpawner.generated.h"
 
 class UAstroTilesetData;
+class UInstancedStaticMeshComponent;
 
 UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
 enum class EAstroTilesetCornerFilter : uint8
@@ -60,6 +61,59 @@ public:
 
 };
 
+USTRUCT(BlueprintType)
+struct FAstroTilesetGenerationStats
+{
+	GENERATED_BODY()
+
+public:
+	/** Spline segments whose instances were regenerated by the last generation. */
+	UPROPERTY(VisibleAnywhere)
+	int32 RegeneratedSegments = 0;
+
+	/** Spline segments whose instances were reused from the previous generation. */
+	UPROPERTY(VisibleAnywhere)
+	int32 ReusedSegments = 0;
+
+	/** ISM instances that were added or had their transforms updated by the last generation. */
+	UPROPERTY(VisibleAnywhere)
+	int32 UpdatedInstances = 0;
+
+	UPROPERTY(VisibleAnywhere)
+	float GenerationMs = 0.f;
+
+};
+
+/** Instances generated for a single spline segment of a tileset. */
+struct FAstroTilesetSegmentCache
+{
+	/** Hash of every input the segment depends on. The segment is only regenerated when it changes. */
+	uint32 InputHash = 0;
+
+	/** Instance transforms, by base mesh descriptor index. */
+	TMap<int32, TArray<FTransform>> InstanceTransforms;
+
+	/** Generation state right after this segment, which is carried over to the next one. */
+	TBitArray<> ConsumedProxies;
+	int32 PickedMeshIndex = INDEX_NONE;
+};
+
+/** Everything that was generated for a tileset, so that the next generation only has to regenerate dirty segments. */
+struct FAstroTilesetCache
+{
+	/** Hash of the tileset settings. When it changes, the tileset is regenerated from scratch. */
+	uint32 TilesetHash = 0;
+
+	TArray<FAstroTilesetSegmentCache> Segments;
+	TArray<FTransform> CornerTransforms;
+
+	/**
+	* ISM of each mesh descriptor, by base mesh descriptor index (INDEX_NONE for the corner mesh).
+	* NOTE: Instances are laid out segment by segment, so each segment owns a contiguous range of instances.
+	*/
+	TMap<int32, TWeakObjectPtr<UInstancedStaticMeshComponent>> MeshComponents;
+};
+
 
 class USplineComponent;
 
@@ -74,6 +128,11 @@ public:
 	AAstroTilesetSpawner();
 protected:
 	virtual void OnConstruction(const FTransform& Transform);
+
+#if WITH_EDITOR
+public:
+	virtual void PostEditUndo() override;
+#endif
 #pragma endregion
 
 protected:
@@ -105,20 +164,46 @@ protected:
 	UPROPERTY(VisibleAnywhere)
 	TArray<FBox> ProxyMeshBounds;
 
+	UPROPERTY(VisibleAnywhere, Transient)
+	FAstroTilesetGenerationStats GenerationStats;
+
 
 private:
 	void Generate();
-	void GenerateTileset(const FAstroTilesetInfo& InTileset);
+	void GenerateTileset(const FAstroTilesetInfo& InTileset, const uint32 SplineHash, FAstroTilesetCache& TilesetCache);
+	void GenerateSegment(const FAstroTilesetInfo& InTileset, const TArray<float>& BaseMeshLengths, const int32 SegmentIndex, TBitArray<>& ConsumedProxies, int32& PickedMeshIndex, OUT TMap<int32, TArray<FTransform>>& OutInstanceTransforms) const;
+	void GenerateCorners(const FAstroTilesetInfo& InTileset, OUT TArray<FTransform>& OutCornerTransforms) const;
 	void ClearAllMeshes();
 	void CacheProxyMeshBounds();
 
-	/** @return True when @param DistanceAlongSpline is within any of the proxy mesh bounds. */
-	bool IsSplinePointWithinProxyMeshBounds(const float DistanceAlongSpline, const TArray<FBox>& InProxyMeshBounds, OUT FBox& OutHitMask) const;
+	/** Recreates all instances of a mesh descriptor. Needed whenever the instance count of any of its segments changes. */
+	void RebuildMeshInstances(const UAstroTilesetData* TilesetData, FAstroTilesetCache& TilesetCache, const int32 MeshDescriptorIndex);
+	/** Updates the instance range that a single segment owns in the ISM of a mesh descriptor. */
+	void UpdateMeshInstanceRange(FAstroTilesetCache& TilesetCache, const int32 MeshDescriptorIndex, const int32 SegmentIndex);
+
+	/** @return True if every cached ISM still exists, and still has the instances the cache expects it to have. */
+	bool AreTilesetCachesValid() const;
+
+	uint32 ComputeSplineHash() const;
+	uint32 ComputeSegmentHash(const int32 SegmentIndex) const;
+
+	/**
+	* @return True when @param DistanceAlongSpline is within any of the proxy mesh bounds that weren't consumed yet.
+	* NOTE: When multiple proxies overlap, the one with the lowest index wins, so that generation stays deterministic.
+	*/
+	bool IsSplinePointWithinProxyMeshBounds(const float DistanceAlongSpline, const TBitArray<>& ConsumedProxies, OUT int32& OutProxyIndex) const;
 
 	/** Picks the largest available mesh that would fit the segment. Defaults to the first mesh if none would fit. */
-	void PickGreedyMesh(const UAstroTilesetData* TilesetData, const float DistanceAlongSplineA, const float DistanceAlongSplineB, OUT int32& OutMeshDescriptorIndex);
+	void PickGreedyMesh(const TArray<float>& BaseMeshLengths, const float DistanceAlongSplineA, const float DistanceAlongSplineB, OUT int32& OutMeshDescriptorIndex) const;
 
 	/** Picks mesh 0, then 1, then 2, ..., then back to 0. */
-	void PickAlternatedMesh(const UAstroTilesetData* TilesetData, OUT int32& OutMeshDescriptorIndex);
+	void PickAlternatedMesh(const UAstroTilesetData* TilesetData, OUT int32& OutMeshDescriptorIndex) const;
+
+private:
+	/** Uniform 2D (XY) grid over ProxyMeshBounds, with the indices of the proxies overlapping each cell. */
+	TMap<FIntPoint, TArray<int32>> ProxyMeshCells;
+
+	/** One cache per entry in Tilesets. Transient, so a freshly loaded spawner always does a full generation. */
+	TArray<FAstroTilesetCache> TilesetCaches;
 
 };
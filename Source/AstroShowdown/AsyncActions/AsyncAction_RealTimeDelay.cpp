@@ -30,15 +30,17 @@ void UAsyncAction_RealTimeDelay::Activate()
 {
 	Super::Activate();
 
+	UAstroTimeDilationSubsystem* TimeDilationSubsystem = SubsystemUtils::GetWorldSubsystem<UAstroTimeDilationSubsystem>(World.Get());
 	if (DelayDuration <= 0.f)
 	{
-		OnComplete.Broadcast();
-		OnCompleteDelegate.Broadcast();
-		SetReadyToDestroy();
+		OnDelayFinished();
 	}
-	else if (World.IsValid())
+	else if (TimeDilationSubsystem)
 	{
-		DelayTimerHandle = World->GetTimerManager().SetTimerForNextTick(this, &UAsyncAction_RealTimeDelay::OnDelayTick);
+		// NOTE: Clamps the frame delta, as this delay used to skip ahead when the game was unpaused
+		constexpr bool bLoop = false;
+		constexpr bool bClampFrameDelta = true;
+		TimeDilationSubsystem->SetAbsoluteTimer(DelayTimerHandle, FTimerDelegate::CreateUObject(this, &UAsyncAction_RealTimeDelay::OnDelayFinished), DelayDuration, bLoop, bClampFrameDelta);
 	}
 	else
 	{
@@ -51,27 +53,17 @@ void UAsyncAction_RealTimeDelay::Cancel()
 {
 	Super::Cancel();
 
-	if (DelayTimerHandle.IsValid() && World.IsValid())
+	UAstroTimeDilationSubsystem* TimeDilationSubsystem = SubsystemUtils::GetWorldSubsystem<UAstroTimeDilationSubsystem>(World.Get());
+	if (DelayTimerHandle.IsValid() && TimeDilationSubsystem)
 	{
-		World->GetTimerManager().ClearTimer(DelayTimerHandle);
+		TimeDilationSubsystem->ClearAbsoluteTimer(DelayTimerHandle);
 	}
 }
 
-void UAsyncAction_RealTimeDelay::OnDelayTick()
+void UAsyncAction_RealTimeDelay::OnDelayFinished()
 {
-	UAstroTimeDilationSubsystem* TimeDilationSubsystem = SubsystemUtils::GetWorldSubsystem<UAstroTimeDilationSubsystem>(World.Get());
-	const float DeltaTime = (TimeDilationSubsystem ? TimeDilationSubsystem->GetRealTimeDeltaSeconds() : 0.f);
-	const float DeltaTimeClamped = FMath::Min(DeltaTime, 1.f / 30.f);		// We need this because RealTimeDelta is broken and jumps when the game is unpaused
-	CurrentDelayCounter += DeltaTimeClamped;
-	if (CurrentDelayCounter >= DelayDuration)
-	{
-		OnComplete.Broadcast();
-		OnCompleteDelegate.Broadcast();
-		SetReadyToDestroy();
-	}
-	else if (World.IsValid())
-	{
-		DelayTimerHandle = World->GetTimerManager().SetTimerForNextTick(this, &UAsyncAction_RealTimeDelay::OnDelayTick);
-	}
+	DelayTimerHandle.Invalidate();
+	OnComplete.Broadcast();
+	OnCompleteDelegate.Broadcast();
+	SetReadyToDestroy();
 }
-
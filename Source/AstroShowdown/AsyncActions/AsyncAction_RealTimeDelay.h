@@ -8,8 +8,8 @@
 
 #pragma once
 
+#include "AstroTimeDilationSubsystem.h"
 #include "Engine/CancellableAsyncAction.h"
-#include "TimerManager.h"
 #include "UObject/SoftObjectPtr.h"
 #include "AsyncAction_RealTimeDelay.generated.h"
 
@@ -33,10 +33,9 @@ public:
 
 private:
 	TWeakObjectPtr<UWorld> World = nullptr;
-	FTimerHandle DelayTimerHandle;
+	FAstroRealTimeTimerHandle DelayTimerHandle;
 
 	float DelayDuration = 0.f;
-	float CurrentDelayCounter = 0.f;
 
 public:
 	UFUNCTION(BlueprintCallable, BlueprintCosmetic, meta = (WorldContext = "InWorldContextObject", BlueprintInternalUseOnly = "true"))
@@ -46,6 +45,6 @@ public:
 	virtual void Cancel() override;
 
 private:
-	void OnDelayTick();
+	void OnDelayFinished();
 
 };
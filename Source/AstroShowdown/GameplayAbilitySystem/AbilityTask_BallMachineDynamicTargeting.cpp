@@ -7,9 +7,11 @@
 */
 
 #include "AbilityTask_BallMachineDynamicTargeting.h"
+#include "AstroBallMachineTargetingSubsystem.h"
+#include "AstroPerfCounters.h"
 #include "BallMachine.h"
 #include "GameFramework/MovementComponent.h"
-#include "Kismet/GameplayStatics.h"
+#include "Kismet/KismetSystemLibrary.h"
 
 namespace BallMachineDynamicTargetingVars
 {
@@ -19,14 +21,11 @@ namespace BallMachineDynamicTargetingVars
 		bDebugLineofSightEnabled,
 		TEXT("When enabled, will allow debug drawing of target LoS checks."),
 		ECVF_Default);
-
-	constexpr float LineOfSightClampInterval = 0.15f;
 }
 
 UAbilityTask_BallMachineDynamicTargeting::UAbilityTask_BallMachineDynamicTargeting(const FObjectInitializer& InObjectInitializer) : Super(InObjectInitializer)
 {
 	bTickingTask = true;
-	LineOfSightClampCounter = BallMachineDynamicTargetingVars::LineOfSightClampInterval;		// Forces first tick to do LoS
 }
 
 UAbilityTask_BallMachineDynamicTargeting* UAbilityTask_BallMachineDynamicTargeting::ExecuteBallMachineDynamicTargeting(UGameplayAbility* OwningAbility, ABallMachine* InBallMachine, FName TaskInstanceName)
@@ -36,6 +35,26 @@ UAbilityTask_BallMachineDynamicTargeting* UAbilityTask_BallMachineDynamicTargeti
 	return MyObj;
 }
 
+void UAbilityTask_BallMachineDynamicTargeting::Activate()
+{
+	Super::Activate();
+
+	if (UAstroBallMachineTargetingSubsystem* TargetingSubsystem = UAstroBallMachineTargetingSubsystem::Get(this))
+	{
+		TargetingSubsystem->RegisterShooter(BallMachine.Get());
+	}
+}
+
+void UAbilityTask_BallMachineDynamicTargeting::OnDestroy(bool bInOwnerFinished)
+{
+	if (UAstroBallMachineTargetingSubsystem* TargetingSubsystem = UAstroBallMachineTargetingSubsystem::Get(this))
+	{
+		TargetingSubsystem->UnregisterShooter(BallMachine.Get());
+	}
+
+	Super::OnDestroy(bInOwnerFinished);
+}
+
 void UAbilityTask_BallMachineDynamicTargeting::TickTask(float DeltaTime)
 {
 	Super::TickTask(DeltaTime);
@@ -48,17 +67,18 @@ void UAbilityTask_BallMachineDynamicTargeting::TickTask(float DeltaTime)
 	if (TWeakObjectPtr<AActor> DynamicTargetActor = FindOrGetDynamicTarget(); DynamicTargetActor.IsValid())
 	{
 		// Checks if target position is within line of sight, and if it's not, clamps it to the closest object in LoS.
-		// NOTE (1): This operation performs a line trace, so as an optimization, we're NOT gonna do it every frame.
+		// NOTE (1): The line traces are batched by UAstroBallMachineTargetingSubsystem, which refreshes them periodically under a per-frame budget.
+		// The first trace for a new target runs immediately, so the limiter below is never left unset.
 		// NOTE (2): Each time LoS is calculated, we're going to cache the distance from ball machine to target, and use it as a limiter
 		// to avoid going beyond geometry in frames where LoS is not calculated, but player is still behind an object.
 		const FVector BallMachinePosition = BallMachine->GetActorLocation();
-		FVector TargetActorPosition = DynamicTargetActor->GetActorLocation();
-		LineOfSightClampCounter += DeltaTime;
-		if (LineOfSightClampCounter >= BallMachineDynamicTargetingVars::LineOfSightClampInterval)
+		const FVector TargetActorPosition = DynamicTargetActor->GetActorLocation();
+		if (UAstroBallMachineTargetingSubsystem* TargetingSubsystem = UAstroBallMachineTargetingSubsystem::Get(this))
 		{
-			UAbilityTask_BallMachineDynamicTargeting::ClampTargetPositionWithLineOfSight(BallMachine.Get(), BallMachinePosition, OUT TargetActorPosition);
-			CurrentLineOfSightCheckedDistance = (TargetActorPosition - BallMachinePosition).Length();
-			LineOfSightClampCounter = FMath::RandRange(-0.02f, 0.02f);		// Avoids bunching LoS checks in the same frame
+			if (const TOptional<float> LineOfSightDistance = TargetingSubsystem->GetLineOfSightDistance(BallMachine.Get(), DynamicTargetActor.Get()))
+			{
+				CurrentLineOfSightCheckedDistance = LineOfSightDistance.GetValue();
+			}
 		}
 
 		// Calculates target position. Might clamp it with the LoS limiter.
@@ -90,10 +110,8 @@ TWeakObjectPtr<AActor> UAbilityTask_BallMachineDynamicTargeting::FindOrGetDynami
 		if (BallMachine.IsValid())
 		{
 			const FThrowAtTargetParameters& ThrowParameters = BallMachine->ThrowParameters;
-			TArray<AActor*> OutCandidateActors;
-			UGameplayStatics::GetAllActorsOfClass(this, ThrowParameters.ThrowTargetActorClass, OUT OutCandidateActors);
-
-			CachedThrowTargetActor = OutCandidateActors.IsValidIndex(0) ? OutCandidateActors[0] : nullptr;
+			UAstroBallMachineTargetingSubsystem* TargetingSubsystem = UAstroBallMachineTargetingSubsystem::Get(this);
+			CachedThrowTargetActor = TargetingSubsystem ? TargetingSubsystem->FindTarget(ThrowParameters.ThrowTargetActorClass) : nullptr;
 		}
 	}
 
@@ -128,6 +146,7 @@ void UAbilityTask_BallMachineDynamicTargeting::ClampTargetPositionWithLineOfSigh
 	const FVector HeightOffset{ 0, 0, 10.f };
 
 	FHitResult OutHit;
+	AstroPerfCounters::AddTraceCalls();
 	UKismetSystemLibrary::LineTraceSingleForObjects(Instigator,
 		FVector::VectorPlaneProject(StartPosition, FVector::UpVector) + HeightOffset,
 		FVector::VectorPlaneProject(OutTargetPosition, FVector::UpVector) + HeightOffset,
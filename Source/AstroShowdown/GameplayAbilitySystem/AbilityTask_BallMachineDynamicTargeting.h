@@ -22,7 +22,9 @@ class UAbilityTask_BallMachineDynamicTargeting : public UAbilityTask
 public:
 	UAbilityTask_BallMachineDynamicTargeting(const FObjectInitializer& InObjectInitializer);
 
+	virtual void Activate() override;
 	virtual void TickTask(float DeltaTime) override;
+	virtual void OnDestroy(bool bInOwnerFinished) override;
 #pragma endregion
 
 #pragma region UAbilityTask_BallMachineDynamicTargeting
@@ -38,7 +40,7 @@ public:
 	static void ClampTargetPositionWithLineOfSight(AActor* Instigator, const FVector& StartPosition, OUT FVector& OutTargetPosition);
 
 private:
-	float LineOfSightClampCounter = 0.f;
+	/** Last line of sight distance reported by UAstroBallMachineTargetingSubsystem. Used as a limiter until a fresh one comes in. */
 	float CurrentLineOfSightCheckedDistance = 99999.f;
 
 private:
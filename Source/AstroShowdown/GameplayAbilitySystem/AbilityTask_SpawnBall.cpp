@@ -10,6 +10,7 @@
 
 #include "AbilitySystemComponent.h"
 #include "AstroBall.h"
+#include "AstroBallPoolManager.h"
 #include "EngineGlobals.h"
 #include "Engine/Engine.h"
 
@@ -70,7 +71,9 @@ bool UAbilityTask_SpawnBall::BeginSpawningActor(UGameplayAbility* OwningAbility,
 
 			if (AbilityTaskSpawnBallVars::ShouldSpawnFromPool)
 			{
-				SpawnedBall = UAstroBallPoolManager::Get(this)->SpawnBall(BallClass);
+				// NOTE: The ball is only activated by FinishSpawningActor, once it's been placed at its spawn location
+				UAstroBallPoolManager* BallPoolManager = UAstroBallPoolManager::Get(this);
+				SpawnedBall = BallPoolManager ? BallPoolManager->AcquireBall(BallClass) : nullptr;
 			}
 			else
 			{
@@ -133,107 +136,3 @@ void UAbilityTask_SpawnBall::FinishSpawningActor(UGameplayAbility* OwningAbility
 	EndTask();
 }
 
-
-////////////////////////////////////////////////////////////////
-// UAstroBallPoolManager
-////////////////////////////////////////////////////////////////
-
-UWorld* UAstroBallPoolManager::GetWorld() const
-{
-	return Cast<UWorld>(GetOuter());
-}
-
-AAstroBall* UAstroBallPoolManager::SpawnBall(TSubclassOf<AAstroBall> BallClass)
-{
-	AAstroBall* Ball = GetBallFromPool(BallClass);
-	ensureMsgf(Ball->IsDead(), TEXT("Assumes balls pulled from the pool are always dead"));
-	Ball->ActivateFromPool();
-	return Ball;
-}
-
-void UAstroBallPoolManager::ResizePoolOfClass(TSubclassOf<AAstroBall> BallClass)
-{
-	constexpr int32 ResizePoolCount = 30;
-
-	FBallArray& BallsArray = PooledBalls.FindOrAdd(BallClass);
-	for (int32 Index = 0; Index < ResizePoolCount; Index++)
-	{
-		// Ball activation/deactivation events will modify PooledBalls, so there's no need to do it explicitly here
-		AAstroBall* AstroBall = Cast<AAstroBall>(GetWorld()->SpawnActor(BallClass.Get()));
-		AstroBall->OnAstroBallActivated.AddUObject(this, &UAstroBallPoolManager::OnAstroBallActivated);
-		AstroBall->OnAstroBallDeactivated.AddDynamic(this, &UAstroBallPoolManager::OnAstroBallDeactivated);
-		AstroBall->ReturnToPool();
-		AllBalls.Add(AstroBall);
-	}
-}
-
-bool UAstroBallPoolManager::IsPoolOfClassEmpty(TSubclassOf<AAstroBall> BallClass) const
-{
-	return !PooledBalls.Contains(BallClass) || PooledBalls[BallClass].Balls.IsEmpty();
-}
-
-AAstroBall* UAstroBallPoolManager::GetBallFromPool(TSubclassOf<AAstroBall> BallClass)
-{
-	if (IsPoolOfClassEmpty(BallClass))
-	{
-		ResizePoolOfClass(BallClass);
-	}
-
-	// Pulls the ball from the current index and increments it
-	const FBallArray& BallsArray = PooledBalls[BallClass];
-	if (ensure(BallsArray.Balls.IsValidIndex(0)))
-	{
-		return BallsArray.Balls[0];
-	}
-
-	return nullptr;
-}
-
-void UAstroBallPoolManager::OnAstroBallActivated(AAstroBall* ActiveBall)
-{
-	TSubclassOf<AAstroBall> ActiveBallClass = ActiveBall->GetClass();
-	if (ensure(PooledBalls.Contains(ActiveBallClass)))
-	{
-		PooledBalls[ActiveBallClass].Balls.Remove(ActiveBall);
-	}
-}
-
-void UAstroBallPoolManager::OnAstroBallDeactivated(AAstroBall* InactiveBall)
-{
-	TSubclassOf<AAstroBall> ActiveBallClass = InactiveBall->GetClass();
-	if (ensure(PooledBalls.Contains(ActiveBallClass)))
-	{
-		PooledBalls[ActiveBallClass].Balls.AddUnique(InactiveBall);
-	}
-}
-
-void UAstroBallPoolManager::OnWorldBeginTearDown(UWorld* World)
-{
-	// Removes UAstroBallPoolManager from the root to allow its garbage collection, as it was added to the root during spawn
-	RemoveFromRoot();
-
-	// Removes the activation/deactivation delegates from all balls
-	for (TWeakObjectPtr<AAstroBall> Ball : AllBalls)
-	{
-		if (Ball.IsValid())
-		{
-			Ball->OnAstroBallActivated.RemoveAll(this);
-			Ball->OnAstroBallDeactivated.RemoveDynamic(this, &UAstroBallPoolManager::OnAstroBallDeactivated);
-		}
-	}
-	AllBalls.Empty();
-}
-
-UAstroBallPoolManager* UAstroBallPoolManager::Get(const UObject* WorldContextObject)
-{
-	if (!Instance.IsValid())
-	{
-		// Spawns UAstroBallPoolManager and adds it to the world root to avoid garbage collection
-		Instance = NewObject<UAstroBallPoolManager>(WorldContextObject->GetWorld());
-		Instance->AddToRoot();
-
-		FWorldDelegates::OnWorldBeginTearDown.AddUObject(Instance.Get(), &UAstroBallPoolManager::OnWorldBeginTearDown);
-	}
-
-	return Instance.Get();
-}
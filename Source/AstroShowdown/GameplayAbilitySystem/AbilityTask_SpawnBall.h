@@ -87,64 +87,3 @@ private:
 
 };
 
-
-////////////////////////////////////////////////////////////////
-// UAstroBallPoolManager
-////////////////////////////////////////////////////////////////
-
-USTRUCT()
-struct FBallArray
-{
-	GENERATED_BODY()
-
-public:
-	UPROPERTY()
-	TArray<TObjectPtr<AAstroBall>> Balls;
-};
-
-UCLASS()
-class ASTROSHOWDOWN_API UAstroBallPoolManager : public UObject
-{
-	GENERATED_BODY()
-
-#pragma region UObject
-public:
-	virtual UWorld* GetWorld() const override;
-#pragma endregion
-
-
-#pragma region UAstroBallPoolManager
-public:
-	UFUNCTION(BlueprintCallable)
-	static UAstroBallPoolManager* Get(const UObject* WorldContextObject);
-
-	UFUNCTION(BlueprintCallable)
-	AAstroBall* SpawnBall(TSubclassOf<AAstroBall> BallClass);
-
-private:
-	void ResizePoolOfClass(TSubclassOf<AAstroBall> BallClass);
-	bool IsPoolOfClassEmpty(TSubclassOf<AAstroBall> BallClass) const;
-	AAstroBall* GetBallFromPool(TSubclassOf<AAstroBall> BallClass);
-
-private:
-	UFUNCTION()
-	void OnAstroBallActivated(AAstroBall* ActiveBall);
-	UFUNCTION()
-	void OnAstroBallDeactivated(AAstroBall* InactiveBall);
-	UFUNCTION()
-	void OnWorldBeginTearDown(UWorld* World);
-
-private:
-	/** Stores an array of balls for each class type. */
-	UPROPERTY()
-	TMap<TSubclassOf<AAstroBall>, FBallArray> PooledBalls;
-
-	/** Keeps track of all balls, pooled or active. We need this to unregister the activation/deactivation delegates from balls on world cleanup. */
-	UPROPERTY()
-	TArray<TWeakObjectPtr<AAstroBall>> AllBalls;
-
-private:
-	static inline TWeakObjectPtr<UAstroBallPoolManager> Instance = nullptr;
-#pragma endregion
-
-};
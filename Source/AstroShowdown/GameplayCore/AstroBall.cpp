@@ -7,6 +7,7 @@
 */
 
 #include "AstroBall.h"
+#include "AstroBallPoolManager.h"
 
 #include "AbilitySystemBlueprintLibrary.h"
 #include "AbilitySystemComponent.h"
@@ -14,9 +15,10 @@
 #include "AstroCharacter.h"
 #include "AstroCustomDepthStencilConstants.h"
 #include "AstroGameplayTags.h"
+#include "AstroInteractableSubsystem.h"
+#include "AstroOneShotAudioSubsystem.h"
 #include "AstroTimeDilationSubsystem.h"
 #include "Components/StaticMeshComponent.h"
-#include "Engine/LocalPlayer.h"
 #include "FMODStudio/Classes/FMODBlueprintStatics.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Materials/MaterialInstanceDynamic.h"
@@ -37,14 +39,6 @@ namespace AstroBallVars
 		ECVF_Default);
 	
 
-	static bool bEnableSimulationDebugTrace = false;
-	static FAutoConsoleVariableRef CVarEnableSimulationDebugTrace(
-		TEXT("AstroBall.EnableSimulationDebugTrace"),
-		bEnableSimulationDebugTrace,
-		TEXT("When enabled, will show the debug trace for ball simulation."),
-		ECVF_Default);
-
-
 	static float BallDestroyDelay = 2.f;
 	static FAutoConsoleVariableRef CVarBallDestroyDelay(
 		TEXT("AstroBall.DestroyDelay"),
@@ -142,6 +136,23 @@ void AAstroBall::BeginPlay()
 	CollisionComponent->OnComponentHit.AddUniqueDynamic(this, &AAstroBall::OnBallHit);
 
 	UpdateBallMovementProperties();
+
+	// Registers the ball as an interactable. From now on, the ball pushes its interactable state whenever it changes.
+	if (UAstroInteractableSubsystem* InteractableSubsystem = SubsystemUtils::GetWorldSubsystem<UAstroInteractableSubsystem>(this))
+	{
+		constexpr bool bPushesState = true;
+		InteractableSubsystem->RegisterInteractable(this, bPushesState);
+		UpdateInteractableState();
+	}
+
+	// Indexes the ball for dash targeting. Pooled balls are removed from the index as soon as they're returned to the pool.
+	if (!bInPool)
+	{
+		if (UAstroBallPoolManager* BallPoolManager = SubsystemUtils::GetWorldSubsystem<UAstroBallPoolManager>(this))
+		{
+			BallPoolManager->RegisterActiveBall(this);
+		}
+	}
 }
 
 void AAstroBall::EndPlay(EEndPlayReason::Type EndPlayReason)
@@ -150,6 +161,16 @@ void AAstroBall::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	CollisionComponent->OnComponentHit.RemoveDynamic(this, &AAstroBall::OnBallHit);
 
+	if (UAstroInteractableSubsystem* InteractableSubsystem = SubsystemUtils::GetWorldSubsystem<UAstroInteractableSubsystem>(this))
+	{
+		InteractableSubsystem->UnregisterInteractable(this);
+	}
+
+	if (UAstroBallPoolManager* BallPoolManager = SubsystemUtils::GetWorldSubsystem<UAstroBallPoolManager>(this))
+	{
+		BallPoolManager->UnregisterActiveBall(this);
+	}
+
 	// Deflected balls may ignore time dilation. We're unregistering them here to avoid issues.
 	if (UAstroTimeDilationSubsystem* AstroTimeDilationSubsystem = SubsystemUtils::GetWorldSubsystem<UAstroTimeDilationSubsystem>(this))
 	{
@@ -269,6 +290,7 @@ void AAstroBall::SetBallPhysicsState(const EBallPhysicsState BallPhysicsState)
 	}
 
 	CurrentBallPhysicsState = BallPhysicsState;
+	UpdateInteractableState();
 
 	OnAstroBallPhysicsStateChanged.Broadcast(OldBallPhysicsState, CurrentBallPhysicsState);
 }
@@ -619,6 +641,7 @@ void AAstroBall::DropGrab(const bool bSilent/* = false*/)
 	// Dropping the ball counts as an interaction
 	const UWorld* World = GetWorld();
 	LastInteractionTimestamp = World ? World->GetTimeSeconds() : 0.f;
+	UpdateInteractableState();
 
 	// Plays the ball drop SFX
 	if (ensure(BallDropSFX) && !bSilent)
@@ -656,94 +679,11 @@ void AAstroBall::Die_Implementation()
 	SetLifeSpan(AstroBallVars::BallDestroyDelay);
 }
 
-void AAstroBall::SimulateTrajectory(const FVector& StartDirection, OUT TArray<FHitResult>& OutBounces, const float RadiusMultiplier)
-{
-	SimulateTrajectory(GetActorLocation(), StartDirection, OUT OutBounces, RadiusMultiplier);
-}
-
-void AAstroBall::SimulateTrajectory(const FVector& StartPosition, const FVector& StartDirection, OUT TArray<FHitResult>& OutBounces, const float RadiusMultiplier)
-{
-	if (StartDirection.IsNearlyZero())
-	{
-		return;
-	}
-
-	// Assumes ball radius is roughly half the size of any of its AABB axes
-	const FBox BallBounds = GetComponentsBoundingBox();
-	const float BallRadius = (BallBounds.GetSize().X / 2.f) * RadiusMultiplier;
-	FVector SimulatedBallPosition = FVector(StartPosition.X, StartPosition.Y, GetBallTravelHeight());
-	FVector SimulatedBallDirection = StartDirection;
-
-	OutBounces.Empty();
-	const int32 MaxBallBounces = BallMovementType == EBallMovementType::Ricochet ? MaxRicochetBounces : 1;
-	for (int32 SimCurrentBounce = 0; SimCurrentBounce < MaxBallBounces; SimCurrentBounce++)
-	{
-		// Simulates until a generic far position is reached
-		static constexpr float SimulationRange = 5000.f;
-		const FVector SimulationEndPosition = SimulatedBallPosition + (SimulatedBallDirection * SimulationRange);
-
-		// Ignores the local player. Deflections should never be able to target the player as the dash should place it behind the ball
-		TArray<AActor*> ActorsToIgnore{ this };
-		if (UWorld* World = GetWorld())
-		{
-			ULocalPlayer* LocalPlayer = World->GetFirstLocalPlayerFromController();
-			APawn* LocalPlayerPawn = LocalPlayer ? LocalPlayer->GetPlayerController(World)->GetPawn() : nullptr;
-			ActorsToIgnore.Add(LocalPlayerPawn);
-		}
-
-		// Prevents the case where the simulation trace would hit the same object as the previous iteration because the trace started too close from it.
-		// This follows a similar rationale as ignoring the local player.
-		if (OutBounces.Num() > 0)
-		{
-			if (OutBounces.Last().HasValidHitObjectHandle())
-			{
-				ActorsToIgnore.Add(OutBounces.Last().GetActor());
-			}
-		}
-
-		// Sets up trace parameters
-		const EDrawDebugTrace::Type DebugTraceType = AstroBallVars::bEnableSimulationDebugTrace ? EDrawDebugTrace::Type::ForOneFrame : EDrawDebugTrace::Type::None;
-		const float DebugDuration = 0.f;
-		constexpr bool bIgnoreSelf = true;
-		constexpr bool bTraceComplex = false;
-		const FLinearColor TraceColor = FLinearColor::Red;
-		const FLinearColor TraceHitColor = FLinearColor::Green;
-		const TArray<TEnumAsByte<EObjectTypeQuery>> TraceObjectTypes =
-		{
-			EObjectTypeQuery::ObjectTypeQuery1,		// WorldStatic (walls)
-			EObjectTypeQuery::ObjectTypeQuery3,		// Pawn (enemies)
-		};
-
-		// Performs trace to see if the ball will hit something
-		FHitResult& TraceResult = OutBounces.Emplace_GetRef();
-		bool bHitSomething = UKismetSystemLibrary::SphereTraceSingleForObjects(this, SimulatedBallPosition, SimulationEndPosition, BallRadius,
-			TraceObjectTypes, bTraceComplex, ActorsToIgnore, DebugTraceType,
-			OUT TraceResult, bIgnoreSelf, TraceColor, TraceHitColor, DebugDuration);
-
-		// If nothing is hit, we assume that the ball will go forward infinitely and stop the loop
-		if (!bHitSomething)
-		{
-			TraceResult.Location = SimulationEndPosition;
-			TraceResult.Distance = SimulationRange;
-			return;
-		}
-
-		// If a damageable object is hit, we assume that the ball will hit it and stop, so we stop the loop as well
-		if (AAstroBall::CanDamageActor(TraceResult.GetActor()))
-		{
-			return;
-		}
-
-		// Updates the ball's position with the simulation end position
-		SimulatedBallPosition = TraceResult.Location;
-		SimulatedBallDirection = SimulateDeflection(TraceResult, SimulatedBallDirection * DeflectSpeed);
-	}
-}
-
 void AAstroBall::Interact_Implementation(AAstroCharacter* InteractionInstigator)
 {
 	const UWorld* World = GetWorld();
 	LastInteractionTimestamp = World ? World->GetTimeSeconds() : 0.f;
+	UpdateInteractableState();
 
 	if (InteractionInstigator)
 	{
@@ -765,6 +705,16 @@ bool AAstroBall::IsInteractable_Implementation() const
 	return CurrentBallPhysicsState == EBallPhysicsState::Ragdoll && CurrentTime - InteractionCooldown >= LastInteractionTimestamp;
 }
 
+void AAstroBall::UpdateInteractableState()
+{
+	// NOTE: Mirrors IsInteractable. The cooldown is pushed as a timestamp, so we don't have to push the state again once it expires.
+	if (UAstroInteractableSubsystem* InteractableSubsystem = SubsystemUtils::GetWorldSubsystem<UAstroInteractableSubsystem>(this))
+	{
+		const bool bInteractable = CurrentBallPhysicsState == EBallPhysicsState::Ragdoll;
+		InteractableSubsystem->SetInteractableState(this, bInteractable, LastInteractionTimestamp + InteractionCooldown);
+	}
+}
+
 void AAstroBall::OnEnterInteractionRange_Implementation()
 {
 	if (ProjectileMesh)
@@ -791,7 +741,7 @@ FVector AAstroBall::ApplyTravelHeightFixupToPosition(const FVector& InPosition)
 	return { InPosition.X, InPosition.Y, AAstroBall::GetBallTravelHeight() };
 }
 
-FVector AAstroBall::SimulateDeflection(FHitResult& Hit, const FVector& CurrentVelocity)
+FVector AAstroBall::SimulateDeflection(const FHitResult& Hit, const FVector& CurrentVelocity) const
 {
 	FVector NewVelocity = CurrentVelocity;
 	if (ProjectileMovementComponent)
@@ -815,6 +765,13 @@ FVector AAstroBall::SimulateDeflection(FHitResult& Hit, const FVector& CurrentVe
 	return DeflectionDirection;
 }
 
+float AAstroBall::GetTrajectorySimulationRadius() const
+{
+	// Assumes ball radius is roughly half the size of any of its AABB axes
+	const FBox BallBounds = GetComponentsBoundingBox();
+	return BallBounds.GetSize().X / 2.f;
+}
+
 void AAstroBall::ActivateFromPool()
 {
 	// Enables: Rendering
@@ -827,15 +784,26 @@ void AAstroBall::ActivateFromPool()
 
 	// Resets the ball's dead state. We might use this to check if a ball can be pooled.
 	bDead = false;
+	bInPool = false;
 
 	OnSpawn_BP();
 
+	if (UAstroBallPoolManager* BallPoolManager = SubsystemUtils::GetWorldSubsystem<UAstroBallPoolManager>(this))
+	{
+		BallPoolManager->RegisterActiveBall(this);
+	}
+
 	// Broadcasts pool activation event
 	OnAstroBallActivated.Broadcast(this);
 }
 
 void AAstroBall::ReturnToPool()
 {
+	if (bInPool)
+	{
+		return;
+	}
+
 	// Disables: Collision, movement, rendering, etc
 	SetBallPhysicsState(EBallPhysicsState::Inactive);
 	SetActorHiddenInGame(true);
@@ -848,10 +816,16 @@ void AAstroBall::ReturnToPool()
 
 	// Resets the ball's state
 	bDead = true;
+	bInPool = true;
 	CurrentBounceCount = 0;
 	PreviousVelocity = FVector::ZeroVector;
 	DamageGameplayEffectSpecHandle.Clear();
 
+	if (UAstroBallPoolManager* BallPoolManager = SubsystemUtils::GetWorldSubsystem<UAstroBallPoolManager>(this))
+	{
+		BallPoolManager->UnregisterActiveBall(this);
+	}
+
 	// Broadcasts pool deactivation event
 	OnAstroBallDeactivated.Broadcast(this);
 }
@@ -927,8 +901,7 @@ void AAstroBall::OnActorHit(AActor* HitActor, const FHitResult& HitResult)
 
 		if (HitSFX)
 		{
-			constexpr bool bAutoPlay = true;
-			UFMODBlueprintStatics::PlayEventAtLocation(this, HitSFX, GetActorTransform(), bAutoPlay);
+			UAstroOneShotAudioSubsystem::PlayOneShotAtLocation(this, HitSFX, GetActorTransform());
 		}
 
 		Die();
@@ -951,10 +924,10 @@ void AAstroBall::OnActorHit(AActor* HitActor, const FHitResult& HitResult)
 			Die();
 		}
 
+		// NOTE: Ricochet chains may hit several walls within a few frames, so these go through the one-shot dispatcher
 		if (BallHitSFX)
 		{
-			constexpr bool bAutoPlay = true;
-			UFMODBlueprintStatics::PlayEventAtLocation(this, BallHitSFX, GetActorTransform(), bAutoPlay);
+			UAstroOneShotAudioSubsystem::PlayOneShotAtLocation(this, BallHitSFX, GetActorTransform());
 		}
 	}
 }
@@ -76,6 +76,10 @@ public:
 	virtual bool IsInteractable_Implementation() const override;
 	virtual void OnEnterInteractionRange_Implementation() override;
 	virtual void OnExitInteractionRange_Implementation() override;
+
+private:
+	/** Pushes the ball's interactable state to UAstroInteractableSubsystem. Should be called whenever IsInteractable may change. */
+	void UpdateInteractableState();
 #pragma endregion
 
 
@@ -114,19 +118,23 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void SetBallPhysicsState(const EBallPhysicsState BallPhysicsState);
 
-	/*
-	* Simulates the trajectory of the ball if it was following a given direction, and returns all bounces the ball would make if going at this direction.
-	*/
-	void SimulateTrajectory(const FVector& StartDirection, OUT TArray<FHitResult>& OutBounces, const float RadiusMultiplier = 1.f);
-	void SimulateTrajectory(const FVector& StartPosition, const FVector& StartDirection, OUT TArray<FHitResult>& OutBounces, const float RadiusMultiplier = 1.f);
-	
 	/*
 	* Simulates how the ball would bounce had it hit a certain object.
 	* NOTE: This is a rough copy of what's in UProjectileMovementComponent::ComputeBounceResult.
 	* 
 	* @returns deflection direction
 	*/
-	FVector SimulateDeflection(FHitResult& Hit, const FVector& CurrentVelocity);
+	FVector SimulateDeflection(const FHitResult& Hit, const FVector& CurrentVelocity) const;
+
+	/** Radius used by FAstroBallTrajectorySolver when sweeping the ball's trajectory. */
+	float GetTrajectorySimulationRadius() const;
+
+	/** How many bounces should be simulated for this ball, based on its movement type. */
+	FORCEINLINE int32 GetMaxSimulatedBounces() const { return BallMovementType == EBallMovementType::Ricochet ? MaxRicochetBounces : 1; }
+
+	FORCEINLINE float GetDeflectSpeed() const { return DeflectSpeed; }
+
+	FORCEINLINE UPrimitiveComponent* GetCollisionComponent() const { return CollisionComponent; }
 
 	/** Activates a ball that was spawned from the pool. */
 	void ActivateFromPool();
@@ -141,6 +149,7 @@ private:
 
 public:
 	FORCEINLINE bool IsDead() const { return bDead; }
+	FORCEINLINE bool IsInPool() const { return bInPool; }
 
 	/** Get the height at which all balls should travel */
 	static float GetBallTravelHeight();
@@ -262,6 +271,9 @@ private:
 
 	EBallPhysicsState CurrentBallPhysicsState = EBallPhysicsState::Inactive;
 
+	/** True while the ball sits in a pool. Guards against a ball being returned (and thus pooled) twice. */
+	uint8 bInPool : 1 = false;
+
 #pragma endregion
 
 };
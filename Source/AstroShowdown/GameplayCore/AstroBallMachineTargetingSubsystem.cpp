@@ -0,0 +1,275 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#include "AstroBallMachineTargetingSubsystem.h"
+#include "AbilityTask_BallMachineDynamicTargeting.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AstroBallMachineTargetingSubsystem)
+
+DECLARE_LOG_CATEGORY_EXTERN(LogAstroBallMachineTargeting, Log, All);
+DEFINE_LOG_CATEGORY(LogAstroBallMachineTargeting);
+
+namespace AstroBallMachineTargetingVars
+{
+	static float LineOfSightInterval = 0.15f;
+	static FAutoConsoleVariableRef CVarLineOfSightInterval(
+		TEXT("AstroBallMachineTargeting.LineOfSightInterval"),
+		LineOfSightInterval,
+		TEXT("How often (in seconds) the line of sight of each shooter is refreshed."),
+		ECVF_Default);
+
+	static int32 MaxLineOfSightQueriesPerFrame = 4;
+	static FAutoConsoleVariableRef CVarMaxLineOfSightQueriesPerFrame(
+		TEXT("AstroBallMachineTargeting.MaxLineOfSightQueriesPerFrame"),
+		MaxLineOfSightQueriesPerFrame,
+		TEXT("Maximum amount of line of sight traces per frame. Due queries over this budget are deferred to the next frames, oldest first."),
+		ECVF_Default);
+
+	static FAutoConsoleCommandWithWorld CVarDumpTargetingStats(
+		TEXT("AstroBallMachineTargeting.DumpStats"),
+		TEXT("Prints the current ball machine targeting stats."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UAstroBallMachineTargetingSubsystem* TargetingSubsystem = UAstroBallMachineTargetingSubsystem::Get(World))
+			{
+				TargetingSubsystem->DumpTargetingStats();
+			}
+		}));
+}
+
+void UAstroBallMachineTargetingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UWorld* World = GetWorld())
+	{
+		ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::OnActorSpawned));
+	}
+}
+
+void UAstroBallMachineTargetingSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+	ActorSpawnedHandle.Reset();
+
+	Shooters.Empty();
+	TargetCandidates.Empty();
+
+	Super::Deinitialize();
+}
+
+void UAstroBallMachineTargetingSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	// Gathers every shooter that is due for a query, and drops the ones that were destroyed without unregistering
+	const double CurrentTime = World->GetTimeSeconds();
+	DueShooters.Reset();
+	for (auto It = Shooters.CreateIterator(); It; ++It)
+	{
+		const FAstroShooterLineOfSight& ShooterLineOfSight = It.Value();
+		if (!ShooterLineOfSight.Shooter.IsValid())
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		if (ShooterLineOfSight.NextQueryTime <= CurrentTime && ShooterLineOfSight.Target.IsValid())
+		{
+			DueShooters.Emplace(ShooterLineOfSight.NextQueryTime, It.Key());
+		}
+	}
+
+	// Runs the oldest queries first, so that deferred queries are never starved
+	const int32 QueryBudget = FMath::Max(AstroBallMachineTargetingVars::MaxLineOfSightQueriesPerFrame, 1);
+	if (DueShooters.Num() > QueryBudget)
+	{
+		DueShooters.Sort([](const TPair<double, TObjectKey<AActor>>& A, const TPair<double, TObjectKey<AActor>>& B) { return A.Key < B.Key; });
+		TargetingStats.DeferredQueries += DueShooters.Num() - QueryBudget;
+	}
+
+	for (int32 DueShooterIndex = 0; DueShooterIndex < FMath::Min(DueShooters.Num(), QueryBudget); DueShooterIndex++)
+	{
+		if (FAstroShooterLineOfSight* ShooterLineOfSight = Shooters.Find(DueShooters[DueShooterIndex].Value))
+		{
+			RunLineOfSightQuery(*ShooterLineOfSight);
+
+			// NOTE: The interval is counted from when the query actually ran, so deferred queries naturally spread across frames
+			ShooterLineOfSight->NextQueryTime = CurrentTime + AstroBallMachineTargetingVars::LineOfSightInterval;
+		}
+	}
+}
+
+bool UAstroBallMachineTargetingSubsystem::IsTickable() const
+{
+	return !Shooters.IsEmpty();
+}
+
+TStatId UAstroBallMachineTargetingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAstroBallMachineTargetingSubsystem, STATGROUP_Tickables);
+}
+
+UAstroBallMachineTargetingSubsystem* UAstroBallMachineTargetingSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UAstroBallMachineTargetingSubsystem>() : nullptr;
+}
+
+void UAstroBallMachineTargetingSubsystem::RegisterShooter(AActor* Shooter)
+{
+	if (!Shooter)
+	{
+		return;
+	}
+
+	FAstroShooterLineOfSight& ShooterLineOfSight = Shooters.FindOrAdd(Shooter);
+	ShooterLineOfSight.Shooter = Shooter;
+	ShooterLineOfSight.RegistrationCount++;
+}
+
+void UAstroBallMachineTargetingSubsystem::UnregisterShooter(AActor* Shooter)
+{
+	FAstroShooterLineOfSight* ShooterLineOfSight = Shooter ? Shooters.Find(Shooter) : nullptr;
+	if (!ShooterLineOfSight)
+	{
+		return;
+	}
+
+	if (--ShooterLineOfSight->RegistrationCount <= 0)
+	{
+		Shooters.Remove(Shooter);
+	}
+}
+
+TOptional<float> UAstroBallMachineTargetingSubsystem::GetLineOfSightDistance(AActor* Shooter, AActor* Target)
+{
+	FAstroShooterLineOfSight* ShooterLineOfSight = Shooter ? Shooters.Find(Shooter) : nullptr;
+	if (!ensureMsgf(ShooterLineOfSight, TEXT("Shooters need to be registered before querying their line of sight.")))
+	{
+		return {};
+	}
+
+	// A new target invalidates the previous result
+	if (ShooterLineOfSight->Target.Get() != Target)
+	{
+		ShooterLineOfSight->Target = Target;
+		ShooterLineOfSight->bHasResult = false;
+	}
+
+	// NOTE: The first query of a new shooter or target runs right away, outside of the frame budget, so that the shooter is never left
+	// without a limiter. From then on, the result is refreshed by Tick.
+	if (!ShooterLineOfSight->bHasResult)
+	{
+		RunLineOfSightQuery(*ShooterLineOfSight);
+		if (!ShooterLineOfSight->bHasResult)
+		{
+			return {};
+		}
+
+		const UWorld* World = GetWorld();
+		ShooterLineOfSight->NextQueryTime = (World ? World->GetTimeSeconds() : 0.0) + AstroBallMachineTargetingVars::LineOfSightInterval;
+		return ShooterLineOfSight->LineOfSightDistance;
+	}
+
+	TargetingStats.CacheHits++;
+	return ShooterLineOfSight->LineOfSightDistance;
+}
+
+AActor* UAstroBallMachineTargetingSubsystem::FindTarget(TSubclassOf<AActor> TargetClass)
+{
+	UWorld* World = GetWorld();
+	if (!TargetClass || !World)
+	{
+		return nullptr;
+	}
+
+	// Gathers the candidates of a class only once. From then on, they're kept up to date by OnActorSpawned.
+	TArray<TWeakObjectPtr<AActor>>* Candidates = TargetCandidates.Find(TargetClass);
+	if (!Candidates)
+	{
+		Candidates = &TargetCandidates.Add(TargetClass);
+		for (TActorIterator<AActor> It(World, TargetClass); It; ++It)
+		{
+			Candidates->Add(*It);
+		}
+	}
+
+	// Drops destroyed candidates as they're found, so that the first live candidate is always at the front
+	while (!Candidates->IsEmpty())
+	{
+		AActor* Candidate = (*Candidates)[0].Get();
+		if (IsValid(Candidate))
+		{
+			return Candidate;
+		}
+		Candidates->RemoveAt(0, 1, EAllowShrinking::No);
+	}
+
+	return nullptr;
+}
+
+FAstroBallMachineTargetingStats UAstroBallMachineTargetingSubsystem::GetTargetingStats() const
+{
+	FAstroBallMachineTargetingStats Stats = TargetingStats;
+	Stats.RegisteredShooters = Shooters.Num();
+	return Stats;
+}
+
+void UAstroBallMachineTargetingSubsystem::DumpTargetingStats() const
+{
+	const FAstroBallMachineTargetingStats Stats = GetTargetingStats();
+	UE_LOG(LogAstroBallMachineTargeting, Display, TEXT("[%hs] Shooters=%d QueriesIssued=%d CacheHits=%d DeferredQueries=%d TargetClasses=%d"), __FUNCTION__,
+		Stats.RegisteredShooters, Stats.QueriesIssued, Stats.CacheHits, Stats.DeferredQueries, TargetCandidates.Num());
+}
+
+void UAstroBallMachineTargetingSubsystem::RunLineOfSightQuery(FAstroShooterLineOfSight& ShooterLineOfSight)
+{
+	AActor* Shooter = ShooterLineOfSight.Shooter.Get();
+	const AActor* Target = ShooterLineOfSight.Target.Get();
+	if (!Shooter || !Target)
+	{
+		return;
+	}
+
+	const FVector ShooterPosition = Shooter->GetActorLocation();
+	FVector TargetPosition = Target->GetActorLocation();
+	UAbilityTask_BallMachineDynamicTargeting::ClampTargetPositionWithLineOfSight(Shooter, ShooterPosition, OUT TargetPosition);
+
+	ShooterLineOfSight.LineOfSightDistance = (TargetPosition - ShooterPosition).Length();
+	ShooterLineOfSight.bHasResult = true;
+	TargetingStats.QueriesIssued++;
+}
+
+void UAstroBallMachineTargetingSubsystem::OnActorSpawned(AActor* SpawnedActor)
+{
+	if (!SpawnedActor)
+	{
+		return;
+	}
+
+	for (TPair<TSubclassOf<AActor>, TArray<TWeakObjectPtr<AActor>>>& Candidates : TargetCandidates)
+	{
+		if (SpawnedActor->IsA(Candidates.Key))
+		{
+			Candidates.Value.Add(SpawnedActor);
+		}
+	}
+}
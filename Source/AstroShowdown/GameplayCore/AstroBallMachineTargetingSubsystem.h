@@ -0,0 +1,113 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "UObject/ObjectKey.h"
+#include "AstroBallMachineTargetingSubsystem.generated.h"
+
+USTRUCT(BlueprintType)
+struct FAstroBallMachineTargetingStats
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly)
+	int32 RegisteredShooters = 0;
+
+	/** Line of sight traces that were actually performed. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 QueriesIssued = 0;
+
+	/** Line of sight requests that were answered with a cached result. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 CacheHits = 0;
+
+	/** Due line of sight queries that were pushed to a later frame, because the frame's trace budget ran out. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 DeferredQueries = 0;
+
+};
+
+/**
+* AstroBallMachineTargetingSubsystem owns line of sight and target resolution for every AI shooter (e.g., ABallMachine).
+* Shooters register while they're targeting, and their line of sight is refreshed once per interval, under a per-frame trace budget.
+* Target candidates are cached per class as actors spawn, so shooters never need to iterate all actors in the world.
+*/
+UCLASS()
+class ASTROSHOWDOWN_API UAstroBallMachineTargetingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+#pragma region UWorldSubsystem
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+#pragma endregion
+
+
+#pragma region FTickableGameObject
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+#pragma endregion
+
+
+#pragma region UAstroBallMachineTargetingSubsystem
+public:
+	static UAstroBallMachineTargetingSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Starts refreshing the line of sight between Shooter and its target. Every call should be matched by a call to UnregisterShooter. */
+	void RegisterShooter(AActor* Shooter);
+	void UnregisterShooter(AActor* Shooter);
+
+	/**
+	* @return Distance from Shooter to the closest obstacle between it and Target, as of the shooter's last line of sight query.
+	* The first query of a new shooter or target runs immediately, so an unset value is only returned if Shooter or Target is invalid.
+	*/
+	TOptional<float> GetLineOfSightDistance(AActor* Shooter, AActor* Target);
+
+	/** @return The first live actor of a given class. The candidates of each class are only gathered once, and then kept up to date as actors spawn. */
+	AActor* FindTarget(TSubclassOf<AActor> TargetClass);
+
+	UFUNCTION(BlueprintPure)
+	FAstroBallMachineTargetingStats GetTargetingStats() const;
+
+	void DumpTargetingStats() const;
+
+private:
+	struct FAstroShooterLineOfSight
+	{
+		TWeakObjectPtr<AActor> Shooter;
+		TWeakObjectPtr<AActor> Target;
+		double NextQueryTime = 0.0;
+		float LineOfSightDistance = 0.f;
+		int32 RegistrationCount = 0;
+		bool bHasResult = false;
+	};
+	TMap<TObjectKey<AActor>, FAstroShooterLineOfSight> Shooters;
+
+	void RunLineOfSightQuery(FAstroShooterLineOfSight& ShooterLineOfSight);
+	void OnActorSpawned(AActor* SpawnedActor);
+
+private:
+	/** Live actors of every class that was requested by FindTarget. */
+	TMap<TSubclassOf<AActor>, TArray<TWeakObjectPtr<AActor>>> TargetCandidates;
+
+	/** Scratch buffer with the shooters due for a query this frame. */
+	TArray<TPair<double, TObjectKey<AActor>>> DueShooters;
+
+	FAstroBallMachineTargetingStats TargetingStats;
+
+	FDelegateHandle ActorSpawnedHandle;
+#pragma endregion
+
+};
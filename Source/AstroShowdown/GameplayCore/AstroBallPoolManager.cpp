@@ -0,0 +1,317 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#include "AstroBallPoolManager.h"
+#include "AstroBall.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AstroBallPoolManager)
+
+DECLARE_LOG_CATEGORY_EXTERN(LogAstroBallPool, Log, All);
+DEFINE_LOG_CATEGORY(LogAstroBallPool);
+
+namespace AstroBallPoolVars
+{
+	static float PrewarmFrameBudgetMs = 1.f;
+	static FAutoConsoleVariableRef CVarPrewarmFrameBudgetMs(
+		TEXT("AstroBallPool.PrewarmFrameBudgetMs"),
+		PrewarmFrameBudgetMs,
+		TEXT("How long (in milliseconds) the ball pool may spend pre-warming balls each frame."),
+		ECVF_Default);
+
+	static int32 MaxPrewarmSpawnsPerFrame = 4;
+	static FAutoConsoleVariableRef CVarMaxPrewarmSpawnsPerFrame(
+		TEXT("AstroBallPool.MaxPrewarmSpawnsPerFrame"),
+		MaxPrewarmSpawnsPerFrame,
+		TEXT("Maximum amount of balls the ball pool may pre-warm each frame, regardless of the frame budget."),
+		ECVF_Default);
+
+	static FAutoConsoleCommandWithWorld CVarDumpPoolStats(
+		TEXT("AstroBallPool.DumpStats"),
+		TEXT("Prints the current stats of all ball pools."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UAstroBallPoolManager* BallPoolManager = UAstroBallPoolManager::Get(World))
+			{
+				BallPoolManager->DumpPoolStats();
+			}
+		}));
+}
+
+
+////////////////////////////////////////////////////////////////
+// UAstroBallPoolSettings
+////////////////////////////////////////////////////////////////
+
+const FAstroBallPoolBudget& UAstroBallPoolSettings::GetPoolBudget(TSubclassOf<AAstroBall> BallClass) const
+{
+	if (const FAstroBallPoolBudget* PoolBudget = PoolBudgets.Find(TSoftClassPtr<AAstroBall>(BallClass.Get())))
+	{
+		return *PoolBudget;
+	}
+
+	return DefaultPoolBudget;
+}
+
+
+////////////////////////////////////////////////////////////////
+// UAstroBallPoolManager
+////////////////////////////////////////////////////////////////
+
+void UAstroBallPoolManager::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Pre-warms every pool that was configured to be available right away
+	const UAstroBallPoolSettings* BallPoolSettings = GetDefault<UAstroBallPoolSettings>();
+	for (const TPair<TSoftClassPtr<AAstroBall>, FAstroBallPoolBudget>& PoolBudget : BallPoolSettings->PoolBudgets)
+	{
+		if (PoolBudget.Value.bPrewarmOnWorldBeginPlay)
+		{
+			// NOTE: Ball classes are small and will be loaded by the first spawner anyway, so there's no point in loading them asynchronously here
+			RequestPrewarm(PoolBudget.Key.LoadSynchronous());
+		}
+	}
+}
+
+void UAstroBallPoolManager::Deinitialize()
+{
+	// Removes the deactivation delegates from all balls
+	for (TWeakObjectPtr<AAstroBall> Ball : AllBalls)
+	{
+		if (Ball.IsValid())
+		{
+			Ball->OnAstroBallDeactivated.RemoveDynamic(this, &UAstroBallPoolManager::OnAstroBallDeactivated);
+		}
+	}
+	AllBalls.Empty();
+	ActiveBallIndex.Reset();
+	BallPools.Empty();
+	PendingPrewarmClasses.Empty();
+
+	Super::Deinitialize();
+}
+
+void UAstroBallPoolManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Spawns pending balls until either the frame budget or the spawn count budget runs out.
+	// NOTE: The spawn count is always allowed to go through at least once, so that pre-warm progresses even on slow frames.
+	const double PrewarmStartTime = FPlatformTime::Seconds();
+	const double PrewarmBudgetSeconds = AstroBallPoolVars::PrewarmFrameBudgetMs / 1000.0;
+	int32 SpawnedBallCount = 0;
+	while (!PendingPrewarmClasses.IsEmpty() && SpawnedBallCount < AstroBallPoolVars::MaxPrewarmSpawnsPerFrame)
+	{
+		if (SpawnedBallCount > 0 && FPlatformTime::Seconds() - PrewarmStartTime >= PrewarmBudgetSeconds)
+		{
+			break;
+		}
+
+		const TSubclassOf<AAstroBall> BallClass = PendingPrewarmClasses[0];
+		FAstroBallPool& Pool = FindOrAddPool(BallClass);
+		if (Pool.Stats.PendingPrewarm > 0)
+		{
+			if (AAstroBall* AstroBall = SpawnPooledBall(BallClass, Pool))
+			{
+				Pool.FreeBalls.Push(AstroBall);
+			}
+			Pool.Stats.PendingPrewarm--;
+			SpawnedBallCount++;
+		}
+
+		if (Pool.Stats.PendingPrewarm <= 0)
+		{
+			PendingPrewarmClasses.RemoveAt(0);
+		}
+	}
+}
+
+bool UAstroBallPoolManager::IsTickable() const
+{
+	return !PendingPrewarmClasses.IsEmpty();
+}
+
+TStatId UAstroBallPoolManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAstroBallPoolManager, STATGROUP_Tickables);
+}
+
+UAstroBallPoolManager* UAstroBallPoolManager::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UAstroBallPoolManager>() : nullptr;
+}
+
+AAstroBall* UAstroBallPoolManager::SpawnBall(TSubclassOf<AAstroBall> BallClass)
+{
+	AAstroBall* Ball = AcquireBall(BallClass);
+	if (Ball)
+	{
+		Ball->ActivateFromPool();
+	}
+	return Ball;
+}
+
+AAstroBall* UAstroBallPoolManager::AcquireBall(TSubclassOf<AAstroBall> BallClass)
+{
+	if (!ensure(BallClass))
+	{
+		return nullptr;
+	}
+
+	FAstroBallPool& Pool = FindOrAddPool(BallClass);
+
+	// Pops balls until a valid one is found. Balls may have been destroyed by something other than the pool (e.g., level streaming).
+	AAstroBall* Ball = nullptr;
+	while (!Ball && !Pool.FreeBalls.IsEmpty())
+	{
+		Ball = Pool.FreeBalls.Pop(EAllowShrinking::No);
+		if (!IsValid(Ball))
+		{
+			Ball = nullptr;
+			Pool.Stats.TotalBalls--;
+		}
+	}
+
+	// If the pool is empty, we have no choice but to spawn synchronously. We also schedule some extra balls, expecting the burst to go on.
+	if (!Ball)
+	{
+		const FAstroBallPoolBudget& PoolBudget = GetDefault<UAstroBallPoolSettings>()->GetPoolBudget(BallClass);
+		UE_LOG(LogAstroBallPool, Warning, TEXT("[%s] Pool of %s ran out of balls (%d active). Consider increasing its initial size."), ANSI_TO_TCHAR(__FUNCTION__), *GetNameSafe(BallClass), Pool.Stats.ActiveBalls);
+
+		Pool.Stats.Misses++;
+		Ball = SpawnPooledBall(BallClass, Pool);
+		SchedulePrewarm(BallClass, PoolBudget.MissGrowthCount);
+	}
+
+	if (Ball)
+	{
+		ensureMsgf(Ball->IsDead(), TEXT("Assumes balls pulled from the pool are always dead"));
+		Pool.Stats.ActiveBalls++;
+		Pool.Stats.PeakActiveBalls = FMath::Max(Pool.Stats.PeakActiveBalls, Pool.Stats.ActiveBalls);
+	}
+
+	return Ball;
+}
+
+void UAstroBallPoolManager::RequestPrewarm(TSubclassOf<AAstroBall> BallClass)
+{
+	if (!BallClass)
+	{
+		return;
+	}
+
+	const FAstroBallPool& Pool = FindOrAddPool(BallClass);
+	const FAstroBallPoolBudget& PoolBudget = GetDefault<UAstroBallPoolSettings>()->GetPoolBudget(BallClass);
+	const int32 MissingBallCount = PoolBudget.InitialSize - (Pool.Stats.TotalBalls + Pool.Stats.PendingPrewarm);
+	SchedulePrewarm(BallClass, MissingBallCount);
+}
+
+void UAstroBallPoolManager::SchedulePrewarm(TSubclassOf<AAstroBall> BallClass, const int32 BallCount)
+{
+	FAstroBallPool& Pool = FindOrAddPool(BallClass);
+	const FAstroBallPoolBudget& PoolBudget = GetDefault<UAstroBallPoolSettings>()->GetPoolBudget(BallClass);
+
+	// Never schedules more balls than the high-water mark allows
+	const int32 AvailableBallCount = PoolBudget.HighWaterMark - (Pool.Stats.TotalBalls + Pool.Stats.PendingPrewarm);
+	const int32 ScheduledBallCount = FMath::Min(BallCount, AvailableBallCount);
+	if (ScheduledBallCount <= 0)
+	{
+		return;
+	}
+
+	Pool.Stats.PendingPrewarm += ScheduledBallCount;
+	PendingPrewarmClasses.AddUnique(BallClass);
+}
+
+FAstroBallPoolStats UAstroBallPoolManager::GetPoolStats(TSubclassOf<AAstroBall> BallClass) const
+{
+	const FAstroBallPool* Pool = BallPools.Find(BallClass);
+	return Pool ? Pool->Stats : FAstroBallPoolStats();
+}
+
+FAstroBallPoolStats UAstroBallPoolManager::GetAllPoolsStats() const
+{
+	FAstroBallPoolStats AllPoolsStats;
+	for (const TPair<TSubclassOf<AAstroBall>, FAstroBallPool>& BallPool : BallPools)
+	{
+		const FAstroBallPoolStats& PoolStats = BallPool.Value.Stats;
+		AllPoolsStats.TotalBalls += PoolStats.TotalBalls;
+		AllPoolsStats.ActiveBalls += PoolStats.ActiveBalls;
+		AllPoolsStats.PeakActiveBalls += PoolStats.PeakActiveBalls;
+		AllPoolsStats.Misses += PoolStats.Misses;
+		AllPoolsStats.PendingPrewarm += PoolStats.PendingPrewarm;
+	}
+	return AllPoolsStats;
+}
+
+void UAstroBallPoolManager::DumpPoolStats() const
+{
+	for (const TPair<TSubclassOf<AAstroBall>, FAstroBallPool>& BallPool : BallPools)
+	{
+		const FAstroBallPoolStats& PoolStats = BallPool.Value.Stats;
+		UE_LOG(LogAstroBallPool, Display, TEXT("%s: Total=%d Free=%d Active=%d PeakActive=%d Misses=%d PendingPrewarm=%d"), *GetNameSafe(BallPool.Key),
+			PoolStats.TotalBalls, BallPool.Value.FreeBalls.Num(), PoolStats.ActiveBalls, PoolStats.PeakActiveBalls, PoolStats.Misses, PoolStats.PendingPrewarm);
+	}
+}
+
+FAstroBallPool& UAstroBallPoolManager::FindOrAddPool(TSubclassOf<AAstroBall> BallClass)
+{
+	FAstroBallPool& Pool = BallPools.FindOrAdd(BallClass);
+	if (Pool.FreeBalls.Max() == 0)
+	{
+		// Reserves the free list upfront, so that releasing balls never reallocates it
+		const FAstroBallPoolBudget& PoolBudget = GetDefault<UAstroBallPoolSettings>()->GetPoolBudget(BallClass);
+		Pool.FreeBalls.Reserve(PoolBudget.HighWaterMark);
+	}
+	return Pool;
+}
+
+AAstroBall* UAstroBallPoolManager::SpawnPooledBall(TSubclassOf<AAstroBall> BallClass, FAstroBallPool& Pool)
+{
+	UWorld* World = GetWorld();
+	AAstroBall* AstroBall = World ? World->SpawnActor<AAstroBall>(BallClass.Get()) : nullptr;
+	if (!AstroBall)
+	{
+		return nullptr;
+	}
+
+	// Deactivates the ball before listening to its deactivation, as freshly spawned balls are handled by the caller
+	AstroBall->ReturnToPool();
+	AstroBall->OnAstroBallDeactivated.AddDynamic(this, &UAstroBallPoolManager::OnAstroBallDeactivated);
+	AllBalls.Add(AstroBall);
+	Pool.Stats.TotalBalls++;
+
+	return AstroBall;
+}
+
+void UAstroBallPoolManager::OnAstroBallDeactivated(AAstroBall* InactiveBall)
+{
+	FAstroBallPool* Pool = InactiveBall ? BallPools.Find(InactiveBall->GetClass()) : nullptr;
+	if (!ensure(Pool))
+	{
+		return;
+	}
+
+	Pool->Stats.ActiveBalls = FMath::Max(Pool->Stats.ActiveBalls - 1, 0);
+
+	// Trims the pool if a burst pushed it over its high-water mark
+	const FAstroBallPoolBudget& PoolBudget = GetDefault<UAstroBallPoolSettings>()->GetPoolBudget(InactiveBall->GetClass());
+	if (Pool->Stats.TotalBalls > PoolBudget.HighWaterMark)
+	{
+		InactiveBall->OnAstroBallDeactivated.RemoveDynamic(this, &UAstroBallPoolManager::OnAstroBallDeactivated);
+		InactiveBall->Destroy();
+		Pool->Stats.TotalBalls--;
+		return;
+	}
+
+	Pool->FreeBalls.Push(InactiveBall);
+}
@@ -0,0 +1,184 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#pragma once
+
+#include "AstroBallSpatialIndex.h"
+#include "Engine/DeveloperSettings.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "AstroBallPoolManager.generated.h"
+
+class AAstroBall;
+
+USTRUCT(BlueprintType)
+struct FAstroBallPoolBudget
+{
+	GENERATED_BODY()
+
+public:
+	/** How many balls are spawned when the pool is pre-warmed. */
+	UPROPERTY(EditAnywhere, Meta = (UIMin = 0, UIMax = 200))
+	int32 InitialSize = 30;
+
+	/** Maximum amount of balls the pool may keep alive. Balls returned while the pool is above this mark are destroyed instead of pooled. */
+	UPROPERTY(EditAnywhere, Meta = (UIMin = 1, UIMax = 400))
+	int32 HighWaterMark = 60;
+
+	/** How many extra balls are scheduled for pre-warm whenever the pool runs out of balls. */
+	UPROPERTY(EditAnywhere, Meta = (UIMin = 0, UIMax = 50))
+	int32 MissGrowthCount = 5;
+
+	/** When enabled, the pool is pre-warmed as soon as the world begins play, instead of waiting for a spawner to request it. */
+	UPROPERTY(EditAnywhere)
+	uint8 bPrewarmOnWorldBeginPlay : 1 = false;
+
+};
+
+UCLASS(config = Game, defaultconfig, meta = (DisplayName = "AstroBallPoolSettings"))
+class UAstroBallPoolSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	/** Budget used by ball classes that don't have an entry in PoolBudgets. */
+	UPROPERTY(Config, EditAnywhere)
+	FAstroBallPoolBudget DefaultPoolBudget;
+
+	UPROPERTY(Config, EditAnywhere)
+	TMap<TSoftClassPtr<AAstroBall>, FAstroBallPoolBudget> PoolBudgets;
+
+public:
+	const FAstroBallPoolBudget& GetPoolBudget(TSubclassOf<AAstroBall> BallClass) const;
+
+};
+
+USTRUCT(BlueprintType)
+struct FAstroBallPoolStats
+{
+	GENERATED_BODY()
+
+public:
+	/** Balls owned by the pool, either active or pooled. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 TotalBalls = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 ActiveBalls = 0;
+
+	/** Highest amount of simultaneously active balls. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 PeakActiveBalls = 0;
+
+	/** How many times a ball was requested while the pool was empty, forcing a synchronous spawn. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 Misses = 0;
+
+	/** Balls that are still waiting to be spawned by the time-sliced pre-warm. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 PendingPrewarm = 0;
+
+};
+
+USTRUCT()
+struct FAstroBallPool
+{
+	GENERATED_BODY()
+
+public:
+	/** Inactive balls. This is used as a stack, so that acquiring/releasing balls is O(1). */
+	UPROPERTY()
+	TArray<TObjectPtr<AAstroBall>> FreeBalls;
+
+	FAstroBallPoolStats Stats;
+
+};
+
+/**
+* AstroBallPoolManager keeps a free list of inactive balls for each ball class, so that ball spawners never have to spawn actors mid-combat.
+* Pools are pre-warmed in time slices, either on world begin play or whenever a spawner requests it.
+*/
+UCLASS()
+class ASTROSHOWDOWN_API UAstroBallPoolManager : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+#pragma region UWorldSubsystem
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+#pragma endregion
+
+
+#pragma region FTickableGameObject
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+#pragma endregion
+
+
+#pragma region UAstroBallPoolManager
+public:
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject"))
+	static UAstroBallPoolManager* Get(const UObject* WorldContextObject);
+
+	/** Pulls a ball from the pool and activates it. */
+	UFUNCTION(BlueprintCallable)
+	AAstroBall* SpawnBall(TSubclassOf<AAstroBall> BallClass);
+
+	/** Pulls a ball from the pool without activating it. Callers are expected to call AAstroBall::ActivateFromPool once the ball is placed. */
+	AAstroBall* AcquireBall(TSubclassOf<AAstroBall> BallClass);
+
+	/** Schedules the pool of a given class to be filled up to its initial size. Spawns are spread across frames. */
+	UFUNCTION(BlueprintCallable)
+	void RequestPrewarm(TSubclassOf<AAstroBall> BallClass);
+
+	UFUNCTION(BlueprintPure)
+	FAstroBallPoolStats GetPoolStats(TSubclassOf<AAstroBall> BallClass) const;
+
+	/** Sums the stats of all pools. */
+	UFUNCTION(BlueprintPure)
+	FAstroBallPoolStats GetAllPoolsStats() const;
+
+	void DumpPoolStats() const;
+
+	/**
+	* Spatial index with every active ball in the world, pooled or not.
+	* NOTE: Balls register themselves on BeginPlay and pool activation, and unregister on EndPlay and pool deactivation.
+	*/
+	FAstroBallSpatialIndex& GetActiveBallIndex() { return ActiveBallIndex; }
+	void RegisterActiveBall(AAstroBall* Ball) { ActiveBallIndex.Add(Ball); }
+	void UnregisterActiveBall(AAstroBall* Ball) { ActiveBallIndex.Remove(Ball); }
+
+private:
+	FAstroBallPool& FindOrAddPool(TSubclassOf<AAstroBall> BallClass);
+	AAstroBall* SpawnPooledBall(TSubclassOf<AAstroBall> BallClass, FAstroBallPool& Pool);
+	void SchedulePrewarm(TSubclassOf<AAstroBall> BallClass, const int32 BallCount);
+
+private:
+	UFUNCTION()
+	void OnAstroBallDeactivated(AAstroBall* InactiveBall);
+
+private:
+	/** Stores a pool of balls for each class type. */
+	UPROPERTY()
+	TMap<TSubclassOf<AAstroBall>, FAstroBallPool> BallPools;
+
+	/** Keeps track of all balls, pooled or active. We need this to unregister the deactivation delegates from balls on world cleanup. */
+	UPROPERTY()
+	TArray<TWeakObjectPtr<AAstroBall>> AllBalls;
+
+	/** Classes that still have balls waiting to be pre-warmed, in request order. */
+	UPROPERTY()
+	TArray<TSubclassOf<AAstroBall>> PendingPrewarmClasses;
+
+	FAstroBallSpatialIndex ActiveBallIndex;
+#pragma endregion
+
+};
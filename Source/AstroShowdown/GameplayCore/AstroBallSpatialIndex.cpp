@@ -0,0 +1,178 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#include "AstroBallSpatialIndex.h"
+#include "AstroBall.h"
+#include "Components/PrimitiveComponent.h"
+
+namespace AstroBallSpatialIndexVars
+{
+	static float CellSize = 400.f;
+	static FAutoConsoleVariableRef CVarCellSize(
+		TEXT("AstroBallSpatialIndex.CellSize"),
+		CellSize,
+		TEXT("Size (in cm) of each cell of the active ball grid. Should be close to the radius of the most common queries."),
+		ECVF_Default);
+}
+
+void FAstroBallSpatialIndex::Add(AAstroBall* Ball)
+{
+	if (!Ball || EntryIndices.Contains(Ball))
+	{
+		return;
+	}
+
+	FEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Ball = Ball;
+	Entry.BallKey = Ball;
+	Entry.Cell = GetCell(Ball->GetActorLocation());
+
+	const int32 EntryIndex = Entries.Num() - 1;
+	EntryIndices.Add(Ball, EntryIndex);
+	AddToCell(Entry.Cell, EntryIndex);
+
+	// NOTE: Cells may have been refreshed already this frame, so the new ball has to pad queries right away
+	MaxBallRadius = FMath::Max(MaxBallRadius, GetBallRadius(Ball));
+}
+
+void FAstroBallSpatialIndex::Remove(AAstroBall* Ball)
+{
+	if (const int32* EntryIndex = Ball ? EntryIndices.Find(Ball) : nullptr)
+	{
+		RemoveAt(*EntryIndex);
+	}
+}
+
+void FAstroBallSpatialIndex::Reset()
+{
+	Entries.Reset();
+	EntryIndices.Reset();
+	Cells.Reset();
+	MaxBallRadius = 0.f;
+	LastRefreshFrame = 0;
+}
+
+void FAstroBallSpatialIndex::QueryBalls(const FVector& Location, const float Radius, OUT TArray<AAstroBall*>& OutBalls)
+{
+	RefreshCells();
+
+	const float PaddedRadius = Radius + MaxBallRadius;
+	const FIntPoint MinCell = GetCell(Location - FVector(PaddedRadius, PaddedRadius, 0.f));
+	const FIntPoint MaxCell = GetCell(Location + FVector(PaddedRadius, PaddedRadius, 0.f));
+	for (int32 CellX = MinCell.X; CellX <= MaxCell.X; CellX++)
+	{
+		for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; CellY++)
+		{
+			const TArray<int32>* CellEntries = Cells.Find(FIntPoint(CellX, CellY));
+			if (!CellEntries)
+			{
+				continue;
+			}
+
+			for (const int32 EntryIndex : *CellEntries)
+			{
+				if (AAstroBall* Ball = Entries[EntryIndex].Ball.Get())
+				{
+					OutBalls.Add(Ball);
+				}
+			}
+		}
+	}
+}
+
+void FAstroBallSpatialIndex::RefreshCells()
+{
+	if (LastRefreshFrame == GFrameCounter)
+	{
+		return;
+	}
+	LastRefreshFrame = GFrameCounter;
+
+	if (ActiveCellSize != AstroBallSpatialIndexVars::CellSize)
+	{
+		ActiveCellSize = AstroBallSpatialIndexVars::CellSize;
+		Cells.Reset();
+		for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); EntryIndex++)
+		{
+			AddToCell(Entries[EntryIndex].Cell, EntryIndex);
+		}
+	}
+
+	// Iterates backwards, as balls that were destroyed without being removed are swapped out of the list
+	MaxBallRadius = 0.f;
+	for (int32 EntryIndex = Entries.Num() - 1; EntryIndex >= 0; EntryIndex--)
+	{
+		FEntry& Entry = Entries[EntryIndex];
+		const AAstroBall* Ball = Entry.Ball.Get();
+		if (!Ball)
+		{
+			RemoveAt(EntryIndex);
+			continue;
+		}
+
+		MaxBallRadius = FMath::Max(MaxBallRadius, GetBallRadius(Ball));
+
+		const FIntPoint NewCell = GetCell(Ball->GetActorLocation());
+		if (NewCell != Entry.Cell)
+		{
+			RemoveFromCell(Entry.Cell, EntryIndex);
+			AddToCell(NewCell, EntryIndex);
+			Entry.Cell = NewCell;
+		}
+	}
+}
+
+FIntPoint FAstroBallSpatialIndex::GetCell(const FVector& Location) const
+{
+	const float CellSize = FMath::Max(ActiveCellSize > 0.f ? ActiveCellSize : AstroBallSpatialIndexVars::CellSize, 1.f);
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+float FAstroBallSpatialIndex::GetBallRadius(const AAstroBall* Ball)
+{
+	const UPrimitiveComponent* BallCollisionComponent = Ball ? Ball->GetCollisionComponent() : nullptr;
+	return BallCollisionComponent ? BallCollisionComponent->Bounds.SphereRadius : 0.f;
+}
+
+void FAstroBallSpatialIndex::AddToCell(const FIntPoint& Cell, const int32 EntryIndex)
+{
+	Cells.FindOrAdd(Cell).Add(EntryIndex);
+}
+
+void FAstroBallSpatialIndex::RemoveFromCell(const FIntPoint& Cell, const int32 EntryIndex)
+{
+	if (TArray<int32>* CellEntries = Cells.Find(Cell))
+	{
+		CellEntries->RemoveSingleSwap(EntryIndex, EAllowShrinking::No);
+		if (CellEntries->IsEmpty())
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void FAstroBallSpatialIndex::RemoveAt(const int32 EntryIndex)
+{
+	// NOTE: The removed entry is swapped with the last one, so the last entry's index has to be patched wherever it's referenced
+	const int32 LastEntryIndex = Entries.Num() - 1;
+	RemoveFromCell(Entries[EntryIndex].Cell, EntryIndex);
+	EntryIndices.Remove(Entries[EntryIndex].BallKey);
+
+	if (EntryIndex != LastEntryIndex)
+	{
+		FEntry& LastEntry = Entries[LastEntryIndex];
+		if (TArray<int32>* LastEntryCell = Cells.Find(LastEntry.Cell))
+		{
+			LastEntryCell->Remove(LastEntryIndex);
+			LastEntryCell->Add(EntryIndex);
+		}
+		EntryIndices.Add(LastEntry.BallKey, EntryIndex);
+	}
+
+	Entries.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+}
@@ -0,0 +1,67 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AAstroBall;
+
+/**
+* Uniform 2D (XY) grid with all active balls, so that nearby balls can be found without physics queries.
+* Balls move every frame, so their cells are refreshed lazily, at most once per frame, right before the first query.
+*/
+struct ASTROSHOWDOWN_API FAstroBallSpatialIndex
+{
+public:
+	void Add(AAstroBall* Ball);
+	void Remove(AAstroBall* Ball);
+	void Reset();
+
+	/**
+	* Appends every indexed ball whose collision may be within Radius of Location (in XY). Queries are padded by the radius of the biggest indexed ball.
+	* Callers are expected to do the exact distance checks.
+	*/
+	void QueryBalls(const FVector& Location, const float Radius, OUT TArray<AAstroBall*>& OutBalls);
+
+	int32 Num() const { return Entries.Num(); }
+
+private:
+	/** Moves balls to their current cells. */
+	void RefreshCells();
+
+	FIntPoint GetCell(const FVector& Location) const;
+	static float GetBallRadius(const AAstroBall* Ball);
+	void AddToCell(const FIntPoint& Cell, const int32 EntryIndex);
+	void RemoveFromCell(const FIntPoint& Cell, const int32 EntryIndex);
+	void RemoveAt(const int32 EntryIndex);
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<AAstroBall> Ball;
+		TObjectKey<AAstroBall> BallKey;
+		FIntPoint Cell = FIntPoint::ZeroValue;
+	};
+
+	/** Dense list of indexed balls. Cells refer to balls by their index in this list. */
+	TArray<FEntry> Entries;
+	TMap<TObjectKey<AAstroBall>, int32> EntryIndices;
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	/** Cell size the cells were built with. If the cvar changes, every ball is moved on the next refresh. */
+	float ActiveCellSize = 0.f;
+
+	/** Collision radius of the biggest indexed ball. Recalculated on every refresh, so it shrinks back once big balls are removed. */
+	float MaxBallRadius = 0.f;
+
+	uint64 LastRefreshFrame = 0;
+
+};
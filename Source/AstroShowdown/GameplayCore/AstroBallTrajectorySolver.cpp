@@ -0,0 +1,139 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#include "AstroBallTrajectorySolver.h"
+#include "AstroBall.h"
+#include "AstroPerfCounters.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+namespace AstroBallTrajectorySolverVars
+{
+	static bool bEnableSimulationDebugTrace = false;
+	static FAutoConsoleVariableRef CVarEnableSimulationDebugTrace(
+		TEXT("AstroBall.EnableSimulationDebugTrace"),
+		bEnableSimulationDebugTrace,
+		TEXT("When enabled, will show the debug trace for ball simulation."),
+		ECVF_Default);
+}
+
+namespace AstroBallTrajectorySolverStatics
+{
+	// Simulates until a generic far position is reached
+	static constexpr float SimulationRange = 5000.f;
+}
+
+FAstroBallTrajectorySolver::FAstroBallTrajectorySolver()
+	: TrajectoryQueryParams(SCENE_QUERY_STAT(AstroBallTrajectory), /*bTraceComplex*/ false)
+{
+}
+
+const FCollisionObjectQueryParams& FAstroBallTrajectorySolver::GetTrajectoryObjectQueryParams()
+{
+	static const FCollisionObjectQueryParams TrajectoryObjectQueryParams = []()
+	{
+		FCollisionObjectQueryParams ObjectQueryParams;
+		ObjectQueryParams.AddObjectTypesToQuery(ECC_WorldStatic);		// Walls
+		ObjectQueryParams.AddObjectTypesToQuery(ECC_Pawn);				// Enemies
+		return ObjectQueryParams;
+	}();
+	return TrajectoryObjectQueryParams;
+}
+
+const APawn* FAstroBallTrajectorySolver::GetLocalPlayerPawn(const UWorld* World)
+{
+	if (!CachedLocalPlayerPawn.IsValid() && World)
+	{
+		const ULocalPlayer* LocalPlayer = World->GetFirstLocalPlayerFromController();
+		const APlayerController* LocalPlayerController = LocalPlayer ? LocalPlayer->GetPlayerController(World) : nullptr;
+		CachedLocalPlayerPawn = LocalPlayerController ? LocalPlayerController->GetPawn() : nullptr;
+	}
+
+	return CachedLocalPlayerPawn.Get();
+}
+
+void FAstroBallTrajectorySolver::Solve(const AAstroBall* Ball, const FVector& StartDirection, OUT TArray<FHitResult>& OutBounces, const float RadiusMultiplier)
+{
+	if (Ball)
+	{
+		Solve(Ball, Ball->GetActorLocation(), StartDirection, OUT OutBounces, RadiusMultiplier);
+	}
+}
+
+void FAstroBallTrajectorySolver::Solve(const AAstroBall* Ball, const FVector& StartPosition, const FVector& StartDirection, OUT TArray<FHitResult>& OutBounces, const float RadiusMultiplier)
+{
+	OutBounces.Reset();
+
+	UWorld* World = Ball ? Ball->GetWorld() : nullptr;
+	if (!World || StartDirection.IsNearlyZero())
+	{
+		return;
+	}
+
+	const FCollisionShape BallShape = FCollisionShape::MakeSphere(Ball->GetTrajectorySimulationRadius() * RadiusMultiplier);
+	const FCollisionObjectQueryParams& ObjectQueryParams = GetTrajectoryObjectQueryParams();
+	FVector SimulatedBallPosition = AAstroBall::ApplyTravelHeightFixupToPosition(StartPosition);
+	FVector SimulatedBallDirection = StartDirection;
+
+	const APawn* LocalPlayerPawn = GetLocalPlayerPawn(World);
+
+	const int32 MaxBallBounces = Ball->GetMaxSimulatedBounces();
+	OutBounces.Reserve(MaxBallBounces);
+	for (int32 SimCurrentBounce = 0; SimCurrentBounce < MaxBallBounces; SimCurrentBounce++)
+	{
+		// Ignores the ball itself and the local player. Deflections should never be able to target the player as the dash should place it behind the ball.
+		// NOTE: IgnoreActors uses an inline allocator, so rebuilding it every bounce won't allocate.
+		TrajectoryQueryParams.ClearIgnoredActors();
+		TrajectoryQueryParams.AddIgnoredActor(Ball);
+		TrajectoryQueryParams.AddIgnoredActor(LocalPlayerPawn);
+
+		// Prevents the case where the simulation trace would hit the same object as the previous iteration because the trace started too close from it.
+		// This follows a similar rationale as ignoring the local player.
+		if (OutBounces.Num() > 0 && OutBounces.Last().HasValidHitObjectHandle())
+		{
+			TrajectoryQueryParams.AddIgnoredActor(OutBounces.Last().GetActor());
+		}
+
+		const FVector SimulationEndPosition = SimulatedBallPosition + (SimulatedBallDirection * AstroBallTrajectorySolverStatics::SimulationRange);
+
+		// Performs trace to see if the ball will hit something
+		FHitResult& TraceResult = OutBounces.Emplace_GetRef();
+		AstroPerfCounters::AddTraceCalls();
+		const bool bHitSomething = World->SweepSingleByObjectType(OUT TraceResult, SimulatedBallPosition, SimulationEndPosition, FQuat::Identity,
+			ObjectQueryParams, BallShape, TrajectoryQueryParams);
+
+#if ENABLE_DRAW_DEBUG
+		if (AstroBallTrajectorySolverVars::bEnableSimulationDebugTrace)
+		{
+			const FVector DebugTraceEnd = bHitSomething ? TraceResult.Location : SimulationEndPosition;
+			DrawDebugLine(World, SimulatedBallPosition, DebugTraceEnd, FColor::Red);
+			DrawDebugSphere(World, DebugTraceEnd, BallShape.GetSphereRadius(), 12, bHitSomething ? FColor::Green : FColor::Red);
+		}
+#endif
+
+		// If nothing is hit, we assume that the ball will go forward infinitely and stop the loop
+		if (!bHitSomething)
+		{
+			TraceResult.Location = SimulationEndPosition;
+			TraceResult.Distance = AstroBallTrajectorySolverStatics::SimulationRange;
+			return;
+		}
+
+		// If a damageable object is hit, we assume that the ball will hit it and stop, so we stop the loop as well
+		if (AAstroBall::CanDamageActor(TraceResult.GetActor()))
+		{
+			return;
+		}
+
+		// Updates the ball's position with the simulation end position
+		SimulatedBallPosition = TraceResult.Location;
+		SimulatedBallDirection = Ball->SimulateDeflection(TraceResult, SimulatedBallDirection * Ball->GetDeflectSpeed());
+	}
+}
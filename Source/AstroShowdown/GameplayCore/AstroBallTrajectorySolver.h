@@ -0,0 +1,47 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#pragma once
+
+#include "CollisionQueryParams.h"
+#include "Engine/HitResult.h"
+
+class AAstroBall;
+class APawn;
+
+/**
+* Simulates ball trajectories with native world sweeps.
+*
+* Aim consumers (throw aim, dash aim, etc) are expected to own one solver each and keep it alive between frames,
+* so that query params, the ignored actors list and the bounce buffers are reused instead of being rebuilt on every bounce.
+*/
+struct ASTROSHOWDOWN_API FAstroBallTrajectorySolver
+{
+public:
+	FAstroBallTrajectorySolver();
+
+	/**
+	* Simulates the trajectory of the ball if it was following a given direction, and writes all bounces the ball would make into OutBounces.
+	* NOTE: OutBounces is reset instead of emptied, so buffers that are kept around by the caller won't be reallocated every frame.
+	*/
+	void Solve(const AAstroBall* Ball, const FVector& StartDirection, OUT TArray<FHitResult>& OutBounces, const float RadiusMultiplier = 1.f);
+	void Solve(const AAstroBall* Ball, const FVector& StartPosition, const FVector& StartDirection, OUT TArray<FHitResult>& OutBounces, const float RadiusMultiplier = 1.f);
+
+private:
+	/** Returns the local player's pawn, which is cached until it becomes invalid. */
+	const APawn* GetLocalPlayerPawn(const UWorld* World);
+
+	/** Object types the simulated ball may hit. This is shared by every solver, as it never changes. */
+	static const FCollisionObjectQueryParams& GetTrajectoryObjectQueryParams();
+
+private:
+	FCollisionQueryParams TrajectoryQueryParams;
+
+	TWeakObjectPtr<const APawn> CachedLocalPlayerPawn = nullptr;
+
+};
@@ -11,6 +11,7 @@
 #include "AstroCampaignSaveGame.h"
 #include "AstroRoomData.h"
 #include "AstroSectionData.h"
+#include "Engine/AssetManager.h"
 #include "Engine/GameInstance.h"
 #include "Engine/World.h"
 #include "Kismet/GameplayStatics.h"
@@ -18,9 +19,16 @@
 DECLARE_LOG_CATEGORY_EXTERN(LogAstroCampaignData, Log, All);
 DEFINE_LOG_CATEGORY(LogAstroCampaignData);
 
+namespace AstroCampaignDataStatics
+{
+	static const FPrimaryAssetType RoomDataAssetType = TEXT("AstroRoomData");
+}
+
 void UAstroCampaignDataSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
+
+	BuildCampaignIndices();
 }
 
 UAstroCampaignDataSubsystem* UAstroCampaignDataSubsystem::Get(UObject* WorldContextObject)
@@ -35,71 +43,156 @@ UAstroCampaignDataSubsystem* UAstroCampaignDataSubsystem::Get(UObject* WorldCont
 
 UAstroRoomData* UAstroCampaignDataSubsystem::GetRoomDataById(const FGuid& InRoomId) const
 {
-	const UAstroCampaignData* CampaignData = UAstroCampaignDataSubsystem::GetCampaignData(this);
-	if (!ensureMsgf(CampaignData, TEXT("Invalid CampaignData")))
+	const FAstroCampaignRoomEntry* RoomEntry = FindRoomEntryById(InRoomId);
+	return RoomEntry ? RoomEntry->Room.Get() : nullptr;
+}
+
+UAstroRoomData* UAstroCampaignDataSubsystem::GetRoomDataByWorld(const FSoftWorldReference& InRoomWorld) const
+{
+	const FAstroCampaignRoomEntry* RoomEntry = FindRoomEntryByWorld(InRoomWorld);
+	return RoomEntry ? RoomEntry->Room.Get() : nullptr;
+}
+
+UAstroSectionData* UAstroCampaignDataSubsystem::GetSectionDataByRoomId(const FGuid& InRoomId) const
+{
+	const FAstroCampaignRoomEntry* RoomEntry = FindRoomEntryById(InRoomId);
+	return RoomEntry ? RoomEntry->Section.Get() : nullptr;
+}
+
+const FAstroCampaignRoomEntry* UAstroCampaignDataSubsystem::FindRoomEntryByWorld(const FSoftWorldReference& InRoomWorld) const
+{
+	EnsureCampaignIndices();
+
+	const int32* RoomIndex = RoomIndicesByWorld.Find(InRoomWorld.WorldAsset.ToSoftObjectPath());
+	return RoomIndex ? &CampaignRoomEntries[*RoomIndex] : nullptr;
+}
+
+const FAstroCampaignRoomEntry* UAstroCampaignDataSubsystem::FindRoomEntryById(const FGuid& InRoomId) const
+{
+	EnsureCampaignIndices();
+
+	const int32* RoomIndex = RoomIndicesById.Find(InRoomId);
+	return RoomIndex ? &CampaignRoomEntries[*RoomIndex] : nullptr;
+}
+
+const FAstroCampaignRoomEntry* UAstroCampaignDataSubsystem::GetRoomEntryByCampaignIndex(const int32 CampaignIndex) const
+{
+	EnsureCampaignIndices();
+
+	return CampaignRoomEntries.IsValidIndex(CampaignIndex) ? &CampaignRoomEntries[CampaignIndex] : nullptr;
+}
+
+TArray<FGuid> UAstroCampaignDataSubsystem::GetCampaignRoomIds() const
+{
+	EnsureCampaignIndices();
+
+	TArray<FGuid> CampaignRoomIds;
+	CampaignRoomIds.Reserve(CampaignRoomEntries.Num());
+	for (const FAstroCampaignRoomEntry& RoomEntry : CampaignRoomEntries)
 	{
-		return nullptr;
+		CampaignRoomIds.Add(RoomEntry.Room->RoomId);
 	}
+	return CampaignRoomIds;
+}
 
-	for (UAstroSectionData* SectionData : CampaignData->Sections)
+void UAstroCampaignDataSubsystem::EnsureCampaignIndices() const
+{
+	if (IndexedCampaignData.Get() != UAstroCampaignDataSubsystem::GetCampaignData(this))
 	{
-		for (int32 RoomIndex = 0; RoomIndex < SectionData->Rooms.Num(); RoomIndex++)
-		{
-			UAstroRoomData* RoomData = SectionData->Rooms[RoomIndex];
-			if (const bool IsSameRoom = RoomData->RoomId == InRoomId)
-			{
-				return RoomData;
-			}
-		}
+		BuildCampaignIndices();
 	}
-
-	return nullptr;
 }
 
-UAstroRoomData* UAstroCampaignDataSubsystem::GetRoomDataByWorld(const FSoftWorldReference& InRoomWorld) const
+void UAstroCampaignDataSubsystem::BuildCampaignIndices() const
 {
+	CampaignRoomEntries.Reset();
+	RoomIndicesById.Reset();
+	RoomIndicesByWorld.Reset();
+
 	const UAstroCampaignData* CampaignData = UAstroCampaignDataSubsystem::GetCampaignData(this);
+	IndexedCampaignData = CampaignData;
 	if (!ensureMsgf(CampaignData, TEXT("Invalid CampaignData")))
 	{
-		return nullptr;
+		return;
 	}
 
-	for (UAstroSectionData* SectionData : CampaignData->Sections)
+	for (int32 SectionIndex = 0; SectionIndex < CampaignData->Sections.Num(); SectionIndex++)
 	{
-		for (int32 RoomIndex = 0; RoomIndex < SectionData->Rooms.Num(); RoomIndex++)
+		UAstroSectionData* SectionData = CampaignData->Sections[SectionIndex];
+		if (!SectionData)
 		{
-			UAstroRoomData* RoomData = SectionData->Rooms[RoomIndex];
-			if (const bool bHasSameRoomWorld = RoomData->RoomLevel.WorldAsset == InRoomWorld.WorldAsset)
+			continue;
+		}
+
+		for (UAstroRoomData* RoomData : SectionData->Rooms)
+		{
+			if (!RoomData)
 			{
-				return RoomData;
+				continue;
 			}
+
+			FAstroCampaignRoomEntry& RoomEntry = CampaignRoomEntries.AddDefaulted_GetRef();
+			RoomEntry.Room = RoomData;
+			RoomEntry.Section = SectionData;
+			RoomEntry.SectionIndex = SectionIndex;
+			RoomEntry.CampaignIndex = CampaignRoomEntries.Num() - 1;
+
+			// NOTE: If there are duplicates, the first room wins, which matches the old linear lookups
+			RoomIndicesById.FindOrAdd(RoomData->RoomId, RoomEntry.CampaignIndex);
+			RoomIndicesByWorld.FindOrAdd(RoomData->RoomLevel.WorldAsset.ToSoftObjectPath(), RoomEntry.CampaignIndex);
 		}
 	}
 
-	return nullptr;
+	UE_LOG(LogAstroCampaignData, Log, TEXT("Indexed %d rooms from %s"), CampaignRoomEntries.Num(), *GetNameSafe(CampaignData));
+
+#if !UE_BUILD_SHIPPING
+	ValidateCampaignData(CampaignData);
+#endif
 }
 
-UAstroSectionData* UAstroCampaignDataSubsystem::GetSectionDataByRoomId(const FGuid& InRoomId) const
+void UAstroCampaignDataSubsystem::ValidateCampaignData(const UAstroCampaignData* CampaignData) const
 {
-	const UAstroCampaignData* CampaignData = UAstroCampaignDataSubsystem::GetCampaignData(this);
-	if (!ensureMsgf(CampaignData, TEXT("Invalid CampaignData")))
-	{
-		return nullptr;
-	}
-
-	for (UAstroSectionData* SectionData : CampaignData->Sections)
+	// Duplicate IDs and worlds are only reported here, as the maps already store the first room for each key
+	TSet<FGuid> VisitedRoomIds;
+	TSet<FSoftObjectPath> VisitedRoomWorlds;
+	TSet<FPrimaryAssetId> CampaignRoomAssetIds;
+	for (const FAstroCampaignRoomEntry& RoomEntry : CampaignRoomEntries)
 	{
-		for (int32 RoomIndex = 0; RoomIndex < SectionData->Rooms.Num(); RoomIndex++)
+		const UAstroRoomData* RoomData = RoomEntry.Room;
+		if (!RoomData->RoomId.IsValid())
+		{
+			UE_LOG(LogAstroCampaignData, Error, TEXT("Room %s (section %s) has an invalid RoomId"), *GetNameSafe(RoomData), *GetNameSafe(RoomEntry.Section));
+		}
+		else
 		{
-			UAstroRoomData* RoomData = SectionData->Rooms[RoomIndex];
-			if (const bool IsSameRoom = RoomData->RoomId == InRoomId)
+			bool bIsDuplicateId = false;
+			VisitedRoomIds.Add(RoomData->RoomId, &bIsDuplicateId);
+			if (bIsDuplicateId)
 			{
-				return SectionData;
+				UE_LOG(LogAstroCampaignData, Error, TEXT("Room %s (section %s) has a duplicate RoomId %s"), *GetNameSafe(RoomData), *GetNameSafe(RoomEntry.Section), *RoomData->RoomId.ToString());
 			}
 		}
+
+		bool bIsDuplicateWorld = false;
+		VisitedRoomWorlds.Add(RoomData->RoomLevel.WorldAsset.ToSoftObjectPath(), &bIsDuplicateWorld);
+		if (bIsDuplicateWorld)
+		{
+			UE_LOG(LogAstroCampaignData, Error, TEXT("Room %s (section %s) uses a world that is already used by another room: %s"), *GetNameSafe(RoomData), *GetNameSafe(RoomEntry.Section), *RoomData->RoomLevel.WorldAsset.ToString());
+		}
+
+		CampaignRoomAssetIds.Add(RoomData->GetPrimaryAssetId());
 	}
 
-	return nullptr;
+	// Rooms that exist as assets, but aren't part of any section, can't be reached or unlocked
+	TArray<FPrimaryAssetId> RoomAssetIds;
+	UAssetManager::Get().GetPrimaryAssetIdList(AstroCampaignDataStatics::RoomDataAssetType, OUT RoomAssetIds);
+	for (const FPrimaryAssetId& RoomAssetId : RoomAssetIds)
+	{
+		if (!CampaignRoomAssetIds.Contains(RoomAssetId))
+		{
+			UE_LOG(LogAstroCampaignData, Warning, TEXT("Room %s is not part of any section in %s"), *RoomAssetId.ToString(), *GetNameSafe(CampaignData));
+		}
+	}
 }
 
 const UAstroCampaignData* UAstroCampaignDataSubsystem::GetCampaignData(const UObject* WorldContextObject)
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/SoftObjectPath.h"
 #include "AstroCampaignDataSubsystem.generated.h"
 
 struct FSoftWorldReference;
@@ -17,6 +18,27 @@ class UAstroCampaignSaveGame;
 class UAstroRoomData;
 class UAstroSectionData;
 
+/** Position of a room in the campaign. Rooms are indexed in campaign order, which is also the navigation order. */
+USTRUCT()
+struct FAstroCampaignRoomEntry
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(Transient)
+	TObjectPtr<UAstroRoomData> Room = nullptr;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UAstroSectionData> Section = nullptr;
+
+	/** Index of Section in UAstroCampaignData::Sections. */
+	int32 SectionIndex = INDEX_NONE;
+
+	/** Index of this entry in the campaign room list. */
+	int32 CampaignIndex = INDEX_NONE;
+
+};
+
 UCLASS()
 class UAstroCampaignDataSubsystem : public UGameInstanceSubsystem
 {
@@ -38,6 +60,41 @@ public:
 	UAstroRoomData* GetRoomDataById(const FGuid& InRoomId) const;
 	UAstroSectionData* GetSectionDataByRoomId(const FGuid& InRoomId) const;
 
+	const FAstroCampaignRoomEntry* FindRoomEntryByWorld(const FSoftWorldReference& InRoomWorld) const;
+	const FAstroCampaignRoomEntry* FindRoomEntryById(const FGuid& InRoomId) const;
+
+	/** @return The room entry at a given position of the campaign, or nullptr if out of bounds. */
+	const FAstroCampaignRoomEntry* GetRoomEntryByCampaignIndex(const int32 CampaignIndex) const;
+
+	/** @return The ID of every room, in campaign order. */
+	TArray<FGuid> GetCampaignRoomIds() const;
+
+private:
+	/**
+	* Builds the lookup maps for the current campaign data. Campaign data is immutable at runtime, so this only needs to run once,
+	* unless the campaign data asset is swapped (e.g., reloaded in the editor).
+	*/
+	void BuildCampaignIndices() const;
+	/** Rebuilds the lookup maps if they were built for a different campaign data. */
+	void EnsureCampaignIndices() const;
+	/** Reports duplicate room IDs, rooms shared by multiple sections, and room assets that aren't part of the campaign. */
+	void ValidateCampaignData(const UAstroCampaignData* CampaignData) const;
+
+private:
+	/** Campaign data the lookup maps were built from. */
+	UPROPERTY(Transient)
+	mutable TWeakObjectPtr<const UAstroCampaignData> IndexedCampaignData = nullptr;
+
+	/** All rooms in campaign order. */
+	UPROPERTY(Transient)
+	mutable TArray<FAstroCampaignRoomEntry> CampaignRoomEntries;
+
+	/** Maps room IDs to their index in CampaignRoomEntries. */
+	mutable TMap<FGuid, int32> RoomIndicesById;
+
+	/** Maps room world paths to their index in CampaignRoomEntries. */
+	mutable TMap<FSoftObjectPath, int32> RoomIndicesByWorld;
+
 public:
 	/** Static wrapper to get the campaign data. */
 	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject"))
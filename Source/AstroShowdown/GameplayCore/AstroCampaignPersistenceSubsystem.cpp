@@ -40,9 +40,26 @@ void UAstroCampaignPersistenceSubsystem::Initialize(FSubsystemCollectionBase& Co
 {
 	Super::Initialize(Collection);
 
+	Collection.InitializeDependency(UAstroCampaignDataSubsystem::StaticClass());
+
 	LoadCampaignSaveGame();
 }
 
+void UAstroCampaignPersistenceSubsystem::Deinitialize()
+{
+	Super::Deinitialize();
+
+	// Discards any load that is still in flight
+	LoadRequestSerial++;
+
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(DirtySaveGameTimerHandle);
+	}
+
+	OnPersistenceReadyStatic.Clear();
+}
+
 UAstroCampaignPersistenceSubsystem* UAstroCampaignPersistenceSubsystem::Get(UObject* WorldContextObject)
 {
 	if (UWorld* World = WorldContextObject->GetWorld())
@@ -62,12 +79,12 @@ void UAstroCampaignPersistenceSubsystem::SaveCampaignUnlockedRoom(const FGuid& R
 	}
 
 	check(CachedCampaignSaveGame);
-	if (CachedCampaignSaveGame->UnlockedRooms.Contains(RoomId))
+	if (!CachedCampaignSaveGame->AddRoomProgress(RoomId, EAstroRoomProgress::Unlocked))
 	{
 		return;
 	}
 
-	CachedCampaignSaveGame->UnlockedRooms.AddUnique(RoomId);
+	UpdateDerivedDataForUnlockedRoom(RoomId);
 	DirtyCampaignSaveGame();
 }
 
@@ -80,12 +97,11 @@ void UAstroCampaignPersistenceSubsystem::SaveCampaignVisitedRoom(const FGuid& Ro
 	}
 
 	check(CachedCampaignSaveGame);
-	if (CachedCampaignSaveGame->VisitedRooms.Contains(RoomId))
+	if (!CachedCampaignSaveGame->AddRoomProgress(RoomId, EAstroRoomProgress::Visited))
 	{
 		return;
 	}
 
-	CachedCampaignSaveGame->VisitedRooms.AddUnique(RoomId);
 	DirtyCampaignSaveGame();
 }
 
@@ -98,6 +114,10 @@ void UAstroCampaignPersistenceSubsystem::SaveCampaignLastVisitedRoom(const FGuid
 	}
 
 	CachedCampaignSaveGame->LastVisitedRoomId = RoomId;
+	if (const UAstroCampaignDataSubsystem* CampaignDataSubsystem = UAstroCampaignDataSubsystem::Get(this))
+	{
+		CampaignSaveGameDerivedData.LastVisitedRoomData = CampaignDataSubsystem->GetRoomDataById(RoomId);
+	}
 	DirtyCampaignSaveGame();
 }
 
@@ -110,76 +130,198 @@ void UAstroCampaignPersistenceSubsystem::SaveCampaignCompletedRoom(const FGuid&
 	}
 
 	check(CachedCampaignSaveGame);
-	if (CachedCampaignSaveGame->CompletedRooms.Contains(RoomId))
+	if (!CachedCampaignSaveGame->AddRoomProgress(RoomId, EAstroRoomProgress::Completed))
 	{
 		return;
 	}
 
-	CachedCampaignSaveGame->CompletedRooms.AddUnique(RoomId);
 	DirtyCampaignSaveGame();
 }
 
 void UAstroCampaignPersistenceSubsystem::SaveDisplayedHint(const uint8 Hint)
 {
 	check(CachedCampaignSaveGame);
-	CachedCampaignSaveGame->DisplayedHints.AddUnique(Hint);
+	if (WasHintDisplayed(Hint))
+	{
+		return;
+	}
+
+	CachedCampaignSaveGame->DisplayedHints.Add(Hint);
+
+	TBitArray<>& DisplayedHints = CampaignSaveGameDerivedData.DisplayedHints;
+	if (Hint >= DisplayedHints.Num())
+	{
+		DisplayedHints.Add(false, Hint + 1 - DisplayedHints.Num());
+	}
+	DisplayedHints[Hint] = true;
 }
 
 void UAstroCampaignPersistenceSubsystem::LoadCampaignSaveGame()
 {
-	if (CachedCampaignSaveGame)
+	if (bIsPersistenceReady)
+	{
+		UE_LOG(LogAstroCampaignPersistence, Warning, TEXT("[%hs] Campaign save game already exists."), __FUNCTION__);
+		return;
+	}
+
+	// Saves made while the save game is loading go to an empty save game, which is merged into the loaded one later on
+	if (!CachedCampaignSaveGame)
+	{
+		CachedCampaignSaveGame = Cast<UAstroCampaignSaveGame>(UGameplayStatics::CreateSaveGameObject(UAstroCampaignSaveGame::StaticClass()));
+	}
+
+	// NOTE: If the slot doesn't exist, the load delegate receives a null save game.
+	LoadStartTime = FPlatformTime::Seconds();
+	const int32 RequestSerial = ++LoadRequestSerial;
+	UGameplayStatics::AsyncLoadGameFromSlot(AstroCampaignPersistenceStatics::CampaignSaveGameSlotName, AstroCampaignPersistenceStatics::CampaignSaveGameSlotIndex,
+		FAsyncLoadGameFromSlotDelegate::CreateUObject(this, &UAstroCampaignPersistenceSubsystem::OnCampaignSaveGameLoaded, RequestSerial));
+}
+
+void UAstroCampaignPersistenceSubsystem::OnCampaignSaveGameLoaded(const FString& SlotName, const int32 UserIndex, USaveGame* LoadedSaveGame, const int32 RequestSerial)
+{
+	// The save game was reset while this load was in flight
+	if (RequestSerial != LoadRequestSerial || bIsPersistenceReady)
 	{
-		UE_LOG(LogAstroCampaignPersistence, Warning, TEXT("[%s] Campaign save game already exists."), __FUNCTION__);
 		return;
 	}
 
-	USaveGame* CampaignSaveGame = nullptr;
-	if (UGameplayStatics::DoesSaveGameExist(AstroCampaignPersistenceStatics::CampaignSaveGameSlotName, AstroCampaignPersistenceStatics::CampaignSaveGameSlotIndex))
+	PersistenceStats.LoadMs = static_cast<float>((FPlatformTime::Seconds() - LoadStartTime) * 1000.0);
+	UE_LOG(LogAstroCampaignPersistence, Log, TEXT("[%hs] Campaign save game loaded in %.2fms."), __FUNCTION__, PersistenceStats.LoadMs);
+
+	if (UAstroCampaignSaveGame* LoadedCampaignSaveGame = Cast<UAstroCampaignSaveGame>(LoadedSaveGame))
 	{
-		CampaignSaveGame = UGameplayStatics::LoadGameFromSlot(AstroCampaignPersistenceStatics::CampaignSaveGameSlotName, AstroCampaignPersistenceStatics::CampaignSaveGameSlotIndex);
+		MergeCampaignSaveGame(CachedCampaignSaveGame, LoadedCampaignSaveGame);
+		CachedCampaignSaveGame = LoadedCampaignSaveGame;
 	}
 	else
 	{
-		CampaignSaveGame = UGameplayStatics::CreateSaveGameObject(UAstroCampaignSaveGame::StaticClass());
-		UGameplayStatics::SaveGameToSlot(CampaignSaveGame, AstroCampaignPersistenceStatics::CampaignSaveGameSlotName, AstroCampaignPersistenceStatics::CampaignSaveGameSlotIndex);
+		// First run: the empty save game becomes the campaign save game, and is written in the background
+		UE_LOG(LogAstroCampaignPersistence, Log, TEXT("[%hs] No campaign save game found. Creating a new one."), __FUNCTION__);
+		bSaveWhenPersistenceReady = true;
 	}
 
-	CachedCampaignSaveGame = Cast<UAstroCampaignSaveGame>(CampaignSaveGame);
 	checkf(CachedCampaignSaveGame, TEXT("Invalid campaign save game. Something went awfully wrong."));
 	RecalculateCampaignSaveGameDerivedData();
+	SetPersistenceReady();
+
+	if (bSaveWhenPersistenceReady)
+	{
+		bSaveWhenPersistenceReady = false;
+		DirtyCampaignSaveGame();
+	}
 }
 
-void UAstroCampaignPersistenceSubsystem::ResetCampaignSaveGame()
+void UAstroCampaignPersistenceSubsystem::MergeCampaignSaveGame(const UAstroCampaignSaveGame* SourceCampaignSaveGame, UAstroCampaignSaveGame* TargetCampaignSaveGame) const
 {
-	// Deletes the existing save game and nulls its reference
-	UGameplayStatics::DeleteGameInSlot(AstroCampaignPersistenceStatics::CampaignSaveGameSlotName, AstroCampaignPersistenceStatics::CampaignSaveGameSlotIndex);
-	CachedCampaignSaveGame = nullptr;
+	if (!SourceCampaignSaveGame || !TargetCampaignSaveGame)
+	{
+		return;
+	}
 
-	// Reloads the save game right after
-	LoadCampaignSaveGame();
+	for (const EAstroRoomProgress Progress : { EAstroRoomProgress::Unlocked, EAstroRoomProgress::Visited, EAstroRoomProgress::Completed })
+	{
+		for (const FGuid& RoomId : SourceCampaignSaveGame->GetRoomsWithProgress(Progress))
+		{
+			TargetCampaignSaveGame->AddRoomProgress(RoomId, Progress);
+		}
+	}
+
+	for (const uint8 Hint : SourceCampaignSaveGame->DisplayedHints)
+	{
+		TargetCampaignSaveGame->DisplayedHints.AddUnique(Hint);
+	}
+
+	if (SourceCampaignSaveGame->LastVisitedRoomId.IsValid())
+	{
+		TargetCampaignSaveGame->LastVisitedRoomId = SourceCampaignSaveGame->LastVisitedRoomId;
+	}
 }
 
-void UAstroCampaignPersistenceSubsystem::SaveCampaignSaveGame()
+void UAstroCampaignPersistenceSubsystem::SetPersistenceReady()
+{
+	if (bIsPersistenceReady)
+	{
+		return;
+	}
+
+	bIsPersistenceReady = true;
+	OnPersistenceReadyStatic.Broadcast();
+	OnPersistenceReady.Broadcast();
+}
+
+void UAstroCampaignPersistenceSubsystem::CallOrRegister_OnPersistenceReady(FOnAstroCampaignPersistenceReady::FDelegate&& Delegate)
+{
+	if (IsPersistenceReady())
+	{
+		Delegate.Execute();
+	}
+	else
+	{
+		OnPersistenceReadyStatic.Add(MoveTemp(Delegate));
+	}
+}
+
+void UAstroCampaignPersistenceSubsystem::ResetCampaignSaveGame()
 {
-	// Saves the campaign's save game to the default slot
-	UGameplayStatics::AsyncSaveGameToSlot(CachedCampaignSaveGame, AstroCampaignPersistenceStatics::CampaignSaveGameSlotName, AstroCampaignPersistenceStatics::CampaignSaveGameSlotIndex);
+	// Overwrites the existing save game with an empty one, instead of synchronously deleting it.
+	// NOTE: This also discards any load that is still in flight.
+	LoadRequestSerial++;
+	CachedCampaignSaveGame = Cast<UAstroCampaignSaveGame>(UGameplayStatics::CreateSaveGameObject(UAstroCampaignSaveGame::StaticClass()));
+	checkf(CachedCampaignSaveGame, TEXT("Invalid campaign save game. Something went awfully wrong."));
 
-	// Recalculates all data that's derived from the SaveGame data
 	RecalculateCampaignSaveGameDerivedData();
+	SetPersistenceReady();
+	DirtyCampaignSaveGame();
+}
 
+void UAstroCampaignPersistenceSubsystem::SaveCampaignSaveGame()
+{
 	// Clears dirty save timer, if there's any active
 	if (UWorld* World = GetWorld())
 	{
 		World->GetTimerManager().ClearTimer(DirtySaveGameTimerHandle);
 		DirtySaveGameTimerHandle.Invalidate();
 	}
+
+	// Writing now would overwrite the save game that is still being loaded
+	if (!bIsPersistenceReady)
+	{
+		bSaveWhenPersistenceReady = true;
+		return;
+	}
+
+	// Saves the campaign's save game to the default slot.
+	// NOTE: The save game is serialized on the game thread, but written to disk on a background thread.
+	const double SaveStartTime = FPlatformTime::Seconds();
+	{
+		DECLARE_SCOPE_CYCLE_COUNTER(TEXT("Serialize Campaign Save Game"), STAT_AstroCampaignSaveGameSerialize, STATGROUP_Game);
+		UGameplayStatics::AsyncSaveGameToSlot(CachedCampaignSaveGame, AstroCampaignPersistenceStatics::CampaignSaveGameSlotName, AstroCampaignPersistenceStatics::CampaignSaveGameSlotIndex,
+			FAsyncSaveGameToSlotDelegate::CreateUObject(this, &UAstroCampaignPersistenceSubsystem::OnCampaignSaveGameWritten, SaveStartTime));
+	}
+	PersistenceStats.LastSerializeMs = static_cast<float>((FPlatformTime::Seconds() - SaveStartTime) * 1000.0);
+}
+
+void UAstroCampaignPersistenceSubsystem::OnCampaignSaveGameWritten(const FString& SlotName, const int32 UserIndex, bool bSuccess, const double SaveStartTime)
+{
+	PersistenceStats.LastWriteMs = static_cast<float>((FPlatformTime::Seconds() - SaveStartTime) * 1000.0);
+
+	if (bSuccess)
+	{
+		PersistenceStats.SaveCount++;
+		UE_LOG(LogAstroCampaignPersistence, Verbose, TEXT("[%hs] Campaign save game written (Serialize=%.2fms Write=%.2fms)."), __FUNCTION__, PersistenceStats.LastSerializeMs, PersistenceStats.LastWriteMs);
+	}
+	else
+	{
+		PersistenceStats.FailedSaveCount++;
+		UE_LOG(LogAstroCampaignPersistence, Warning, TEXT("[%hs] Failed to write campaign save game."), __FUNCTION__);
+	}
 }
 
 void UAstroCampaignPersistenceSubsystem::DirtyCampaignSaveGame()
 {
-	UWorld* World = GetWorld();
-	if (!World)
+	if (!bIsPersistenceReady)
 	{
+		bSaveWhenPersistenceReady = true;
 		return;
 	}
 
@@ -188,6 +330,14 @@ void UAstroCampaignPersistenceSubsystem::DirtyCampaignSaveGame()
 		return;
 	}
 
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		// There's no world to defer the save with, but the save is async anyway
+		SaveCampaignSaveGame();
+		return;
+	}
+
 	DirtySaveGameTimerHandle = World->GetTimerManager().SetTimerForNextTick(this, &UAstroCampaignPersistenceSubsystem::SaveCampaignSaveGame);
 }
 
@@ -199,20 +349,36 @@ void UAstroCampaignPersistenceSubsystem::RecalculateCampaignSaveGameDerivedData(
 		return;
 	}
 
+	// Upgrades old save games, and lays out the room progress bitsets in campaign order
+	CachedCampaignSaveGame->SyncRoomTable(CampaignDataSubsystem->GetCampaignRoomIds());
+
 	// Resets campaign derived data
 	CampaignSaveGameDerivedData = FAstroCampaignSaveGameDerivedData();
 
 	// Derives unlocked sections from the save game data
-	for (const FGuid& RoomId : CachedCampaignSaveGame->UnlockedRooms)
+	for (const FGuid& RoomId : CachedCampaignSaveGame->GetRoomsWithProgress(EAstroRoomProgress::Unlocked))
 	{
-		if (UAstroSectionData* UnlockedSection = CampaignDataSubsystem->GetSectionDataByRoomId(RoomId))
-		{
-			CampaignSaveGameDerivedData.UnlockedSectionsData.AddUnique(UnlockedSection);
-		}
+		UpdateDerivedDataForUnlockedRoom(RoomId);
 	}
 
 	// Finds last visited room data
 	CampaignSaveGameDerivedData.LastVisitedRoomData = CampaignDataSubsystem->GetRoomDataById(CachedCampaignSaveGame->LastVisitedRoomId);
+
+	// Derives the displayed hints bitset
+	CampaignSaveGameDerivedData.DisplayedHints.Init(false, MAX_uint8 + 1);
+	for (const uint8 Hint : CachedCampaignSaveGame->DisplayedHints)
+	{
+		CampaignSaveGameDerivedData.DisplayedHints[Hint] = true;
+	}
+}
+
+void UAstroCampaignPersistenceSubsystem::UpdateDerivedDataForUnlockedRoom(const FGuid& RoomId)
+{
+	const UAstroCampaignDataSubsystem* CampaignDataSubsystem = UAstroCampaignDataSubsystem::Get(this);
+	if (UAstroSectionData* UnlockedSection = CampaignDataSubsystem ? CampaignDataSubsystem->GetSectionDataByRoomId(RoomId) : nullptr)
+	{
+		CampaignSaveGameDerivedData.UnlockedSectionsData.AddUnique(UnlockedSection);
+	}
 }
 
 bool UAstroCampaignPersistenceSubsystem::IsCampaignSaveGameValid() const
@@ -223,8 +389,8 @@ bool UAstroCampaignPersistenceSubsystem::IsCampaignSaveGameValid() const
 	}
 
 	return CachedCampaignSaveGame->LastVisitedRoomId.IsValid()
-		|| !CachedCampaignSaveGame->UnlockedRooms.IsEmpty()
-		|| !CachedCampaignSaveGame->CompletedRooms.IsEmpty();
+		|| CachedCampaignSaveGame->HasAnyRoomProgress(EAstroRoomProgress::Unlocked)
+		|| CachedCampaignSaveGame->HasAnyRoomProgress(EAstroRoomProgress::Completed);
 }
 
 bool UAstroCampaignPersistenceSubsystem::IsRoomUnlocked(const UAstroRoomData* InRoomData) const
@@ -238,7 +404,7 @@ bool UAstroCampaignPersistenceSubsystem::IsRoomUnlocked(const UAstroRoomData* In
 		return false;
 	}
 
-	return (InRoomData && CachedCampaignSaveGame && CachedCampaignSaveGame->UnlockedRooms.Contains(InRoomData->RoomId));
+	return (InRoomData && CachedCampaignSaveGame && CachedCampaignSaveGame->HasRoomProgress(InRoomData->RoomId, EAstroRoomProgress::Unlocked));
 }
 
 bool UAstroCampaignPersistenceSubsystem::IsRoomCompleted(const UAstroRoomData* InRoomData) const
@@ -252,7 +418,7 @@ bool UAstroCampaignPersistenceSubsystem::IsRoomCompleted(const UAstroRoomData* I
 		return false;
 	}
 
-	return (InRoomData && CachedCampaignSaveGame && CachedCampaignSaveGame->CompletedRooms.Contains(InRoomData->RoomId));
+	return (InRoomData && CachedCampaignSaveGame && CachedCampaignSaveGame->HasRoomProgress(InRoomData->RoomId, EAstroRoomProgress::Completed));
 }
 
 bool UAstroCampaignPersistenceSubsystem::WasRoomVisited(const UAstroRoomData* InRoomData) const
@@ -266,7 +432,7 @@ bool UAstroCampaignPersistenceSubsystem::WasRoomVisited(const UAstroRoomData* In
 		return false;
 	}
 
-	return (InRoomData && CachedCampaignSaveGame && CachedCampaignSaveGame->VisitedRooms.Contains(InRoomData->RoomId));
+	return (InRoomData && CachedCampaignSaveGame && CachedCampaignSaveGame->HasRoomProgress(InRoomData->RoomId, EAstroRoomProgress::Visited));
 }
 
 bool UAstroCampaignPersistenceSubsystem::IsSectionUnlocked(UAstroSectionData* InSectionData) const
@@ -290,7 +456,8 @@ int32 UAstroCampaignPersistenceSubsystem::NumSectionsUnlocked() const
 
 bool UAstroCampaignPersistenceSubsystem::WasHintDisplayed(const uint8 Hint) const
 {
-	return CachedCampaignSaveGame && CachedCampaignSaveGame->DisplayedHints.Contains(Hint);
+	const TBitArray<>& DisplayedHints = CampaignSaveGameDerivedData.DisplayedHints;
+	return DisplayedHints.IsValidIndex(Hint) && DisplayedHints[Hint];
 }
 
 UAstroRoomData* UAstroCampaignPersistenceSubsystem::GetLastVisitedRoomData()
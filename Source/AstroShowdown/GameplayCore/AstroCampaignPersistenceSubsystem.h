@@ -15,15 +15,52 @@
 struct FSoftWorldReference;
 class UAstroCampaignSaveGame;
 class UAstroSectionData;
+class USaveGame;
 
+USTRUCT(BlueprintType)
+struct FAstroCampaignPersistenceStats
+{
+	GENERATED_BODY()
+
+public:
+	/** Time between requesting the save game load and receiving it. */
+	UPROPERTY(BlueprintReadOnly)
+	float LoadMs = 0.f;
+
+	/** Time spent on the game thread serializing the last save. */
+	UPROPERTY(BlueprintReadOnly)
+	float LastSerializeMs = 0.f;
+
+	/** Time between the last save request and its write finishing on the background thread. */
+	UPROPERTY(BlueprintReadOnly)
+	float LastWriteMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 SaveCount = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 FailedSaveCount = 0;
+
+};
+
+DECLARE_MULTICAST_DELEGATE(FOnAstroCampaignPersistenceReady);
+
+/**
+* AstroCampaignPersistenceSubsystem owns the campaign save game.
+* The save game is loaded and written asynchronously, so callers that depend on persisted data should wait for OnPersistenceReady.
+*/
 UCLASS()
 class UAstroCampaignPersistenceSubsystem : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
 
+public:
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE(FAstroCampaignPersistenceGenericEvent);
+
 #pragma region GameInstanceSubsystem
 public:
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
 
 public:
 	/** Static wrapper for getting this subsystem. */
@@ -32,7 +69,10 @@ public:
 #pragma endregion
 
 private:
-	/** Cached AstroCampaignSaveGame object. Avoids having to load it every time we want to manipulate the campaign's persistence. */
+	/**
+	* Cached AstroCampaignSaveGame object. Avoids having to load it every time we want to manipulate the campaign's persistence.
+	* NOTE: While the save game is loading, this holds an empty save game that is merged into the loaded one, so that early saves are never lost.
+	*/
 	UPROPERTY(Transient)
 	mutable TObjectPtr<UAstroCampaignSaveGame> CachedCampaignSaveGame = nullptr;
 
@@ -41,6 +81,9 @@ private:
 	{
 		TWeakObjectPtr<UAstroRoomData> LastVisitedRoomData = nullptr;
 		TArray<TWeakObjectPtr<UAstroSectionData>> UnlockedSectionsData;
+
+		/** DisplayedHints as a bitset indexed by hint, so that hint checks don't search the save game. */
+		TBitArray<> DisplayedHints;
 	}
 	CampaignSaveGameDerivedData;
 
@@ -48,6 +91,33 @@ private:
 	/** Defers saving the game for a single frame, to account for multiple data changes in a single frame. */
 	FTimerHandle DirtySaveGameTimerHandle;
 
+	/** Set when the save game was changed while loading, so that it's saved as soon as the load finishes. */
+	uint8 bSaveWhenPersistenceReady : 1 = false;
+
+	uint8 bIsPersistenceReady : 1 = false;
+
+	/** Incremented whenever the save game is reset, so that stale async loads are discarded. */
+	int32 LoadRequestSerial = 0;
+
+	double LoadStartTime = 0.0;
+
+	FAstroCampaignPersistenceStats PersistenceStats;
+
+public:
+	/** Called once the campaign save game is loaded. Persistence queries return default values until then. */
+	UPROPERTY(BlueprintAssignable)
+	FAstroCampaignPersistenceGenericEvent OnPersistenceReady;
+	FOnAstroCampaignPersistenceReady OnPersistenceReadyStatic;
+
+	/** Calls the delegate right away if the campaign save game is already loaded, or registers it to be called once it is. */
+	void CallOrRegister_OnPersistenceReady(FOnAstroCampaignPersistenceReady::FDelegate&& Delegate);
+
+	UFUNCTION(BlueprintPure)
+	bool IsPersistenceReady() const { return bIsPersistenceReady; }
+
+	UFUNCTION(BlueprintPure)
+	FAstroCampaignPersistenceStats GetPersistenceStats() const { return PersistenceStats; }
+
 public:
 	void SaveCampaignUnlockedRoom(const FGuid& RoomId);
 	void SaveCampaignVisitedRoom(const FGuid& RoomId);
@@ -60,10 +130,15 @@ public:
 
 private:
 	void LoadCampaignSaveGame();
+	void OnCampaignSaveGameLoaded(const FString& SlotName, const int32 UserIndex, USaveGame* LoadedSaveGame, const int32 RequestSerial);
+	void MergeCampaignSaveGame(const UAstroCampaignSaveGame* SourceCampaignSaveGame, UAstroCampaignSaveGame* TargetCampaignSaveGame) const;
+	void SetPersistenceReady();
 	UFUNCTION()
 	void SaveCampaignSaveGame();
+	void OnCampaignSaveGameWritten(const FString& SlotName, const int32 UserIndex, bool bSuccess, const double SaveStartTime);
 	void DirtyCampaignSaveGame();
 	void RecalculateCampaignSaveGameDerivedData();
+	void UpdateDerivedDataForUnlockedRoom(const FGuid& RoomId);
 
 public:
 	/** @return true if the current campaign save game exists and has relevant data. */
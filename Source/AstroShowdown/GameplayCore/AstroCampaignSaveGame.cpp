@@ -8,6 +8,237 @@
 
 #include "AstroCampaignSaveGame.h"
 
+bool FAstroRoomProgressBits::Get(const int32 Index) const
+{
+	const int32 WordIndex = Index / 32;
+	return Index >= 0 && Words.IsValidIndex(WordIndex) && (Words[WordIndex] & (1u << (Index % 32))) != 0;
+}
+
+bool FAstroRoomProgressBits::Set(const int32 Index)
+{
+	if (!ensure(Index >= 0) || Get(Index))
+	{
+		return false;
+	}
+
+	const int32 WordIndex = Index / 32;
+	if (WordIndex >= Words.Num())
+	{
+		Words.SetNumZeroed(WordIndex + 1);
+	}
+	Words[WordIndex] |= 1u << (Index % 32);
+	return true;
+}
+
+bool FAstroRoomProgressBits::IsEmpty() const
+{
+	for (const uint32 Word : Words)
+	{
+		if (Word != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 UAstroCampaignSaveGame::UAstroCampaignSaveGame()
 {
 }
+
+void UAstroCampaignSaveGame::SyncRoomTable(const TArray<FGuid>& CampaignRoomIds)
+{
+	UpgradeToLatestVersion();
+
+	// NOTE: Duplicate campaign room IDs are reported by UAstroCampaignDataSubsystem. Only their first occurrence gets a bit, and invalid IDs never get one.
+	TArray<FGuid> UniqueCampaignRoomIds;
+	TSet<FGuid> NewRoomIdSet;
+	UniqueCampaignRoomIds.Reserve(CampaignRoomIds.Num());
+	NewRoomIdSet.Reserve(CampaignRoomIds.Num());
+	for (const FGuid& CampaignRoomId : CampaignRoomIds)
+	{
+		bool bIsAlreadyInTable = false;
+		NewRoomIdSet.Add(CampaignRoomId, &bIsAlreadyInTable);
+		if (!bIsAlreadyInTable && CampaignRoomId.IsValid())
+		{
+			UniqueCampaignRoomIds.Add(CampaignRoomId);
+		}
+	}
+
+	// Most of the time, the campaign didn't change since the last save, so there's nothing to remap
+	if (RoomIds.Num() >= UniqueCampaignRoomIds.Num() && FMemory::Memcmp(RoomIds.GetData(), UniqueCampaignRoomIds.GetData(), UniqueCampaignRoomIds.Num() * sizeof(FGuid)) == 0)
+	{
+		return;
+	}
+
+	constexpr EAstroRoomProgress AllRoomProgress[] = { EAstroRoomProgress::Unlocked, EAstroRoomProgress::Visited, EAstroRoomProgress::Completed };
+	TArray<FGuid> RoomsWithProgress[UE_ARRAY_COUNT(AllRoomProgress)];
+	TSet<FGuid> AnyRoomWithProgress;
+	for (int32 ProgressIndex = 0; ProgressIndex < UE_ARRAY_COUNT(AllRoomProgress); ProgressIndex++)
+	{
+		RoomsWithProgress[ProgressIndex] = GetRoomsWithProgress(AllRoomProgress[ProgressIndex]);
+		AnyRoomWithProgress.Append(RoomsWithProgress[ProgressIndex]);
+	}
+
+	// Campaign rooms come first, in campaign order. Orphaned rooms are only kept if they have progress.
+	TArray<FGuid> OldRoomIds = MoveTemp(RoomIds);
+	RoomIds = MoveTemp(UniqueCampaignRoomIds);
+	RoomIndices.Reset();
+
+	for (const FGuid& OldRoomId : OldRoomIds)
+	{
+		if (OldRoomId.IsValid() && AnyRoomWithProgress.Contains(OldRoomId) && !NewRoomIdSet.Contains(OldRoomId))
+		{
+			NewRoomIdSet.Add(OldRoomId);
+			RoomIds.Add(OldRoomId);
+		}
+	}
+
+	for (int32 ProgressIndex = 0; ProgressIndex < UE_ARRAY_COUNT(AllRoomProgress); ProgressIndex++)
+	{
+		GetRoomProgressBits(AllRoomProgress[ProgressIndex]).Words.Reset();
+		for (const FGuid& RoomId : RoomsWithProgress[ProgressIndex])
+		{
+			AddRoomProgress(RoomId, AllRoomProgress[ProgressIndex]);
+		}
+	}
+}
+
+bool UAstroCampaignSaveGame::HasRoomProgress(const FGuid& RoomId, const EAstroRoomProgress Progress) const
+{
+	if (!RoomId.IsValid())
+	{
+		return false;
+	}
+
+	if (Version < static_cast<int32>(EAstroCampaignSaveGameVersion::RoomProgressBitsets))
+	{
+		// NOTE: Only happens if the save game is queried before it's synced, which the persistence subsystem never does
+		const TArray<FGuid>& LegacyRooms = Progress == EAstroRoomProgress::Unlocked ? UnlockedRooms_DEPRECATED
+			: Progress == EAstroRoomProgress::Visited ? VisitedRooms_DEPRECATED
+			: CompletedRooms_DEPRECATED;
+		return LegacyRooms.Contains(RoomId);
+	}
+
+	const int32 RoomIndex = FindRoomIndex(RoomId);
+	return RoomIndex != INDEX_NONE && GetRoomProgressBits(Progress).Get(RoomIndex);
+}
+
+bool UAstroCampaignSaveGame::AddRoomProgress(const FGuid& RoomId, const EAstroRoomProgress Progress)
+{
+	UpgradeToLatestVersion();
+
+	if (!RoomId.IsValid())
+	{
+		return false;
+	}
+
+	int32 RoomIndex = FindRoomIndex(RoomId);
+	if (RoomIndex == INDEX_NONE)
+	{
+		// Rooms that weren't in the table when it was synced are appended, and find their campaign position on the next sync
+		RoomIndex = RoomIds.Add(RoomId);
+		RoomIndices.Add(RoomId, RoomIndex);
+	}
+
+	return GetRoomProgressBits(Progress).Set(RoomIndex);
+}
+
+bool UAstroCampaignSaveGame::HasAnyRoomProgress(const EAstroRoomProgress Progress) const
+{
+	if (Version < static_cast<int32>(EAstroCampaignSaveGameVersion::RoomProgressBitsets))
+	{
+		return !GetRoomsWithProgress(Progress).IsEmpty();
+	}
+
+	return !GetRoomProgressBits(Progress).IsEmpty();
+}
+
+TArray<FGuid> UAstroCampaignSaveGame::GetRoomsWithProgress(const EAstroRoomProgress Progress) const
+{
+	if (Version < static_cast<int32>(EAstroCampaignSaveGameVersion::RoomProgressBitsets))
+	{
+		return Progress == EAstroRoomProgress::Unlocked ? UnlockedRooms_DEPRECATED
+			: Progress == EAstroRoomProgress::Visited ? VisitedRooms_DEPRECATED
+			: CompletedRooms_DEPRECATED;
+	}
+
+	TArray<FGuid> Rooms;
+	const FAstroRoomProgressBits& ProgressBits = GetRoomProgressBits(Progress);
+	for (int32 RoomIndex = 0; RoomIndex < RoomIds.Num(); RoomIndex++)
+	{
+		if (ProgressBits.Get(RoomIndex))
+		{
+			Rooms.Add(RoomIds[RoomIndex]);
+		}
+	}
+	return Rooms;
+}
+
+void UAstroCampaignSaveGame::UpgradeToLatestVersion()
+{
+	if (Version >= static_cast<int32>(EAstroCampaignSaveGameVersion::Latest))
+	{
+		return;
+	}
+
+	if (Version < static_cast<int32>(EAstroCampaignSaveGameVersion::RoomProgressBitsets))
+	{
+		// NOTE: The version is bumped first, so that AddRoomProgress writes to the bitsets instead of upgrading again
+		Version = static_cast<int32>(EAstroCampaignSaveGameVersion::RoomProgressBitsets);
+
+		for (const FGuid& RoomId : UnlockedRooms_DEPRECATED)
+		{
+			AddRoomProgress(RoomId, EAstroRoomProgress::Unlocked);
+		}
+		for (const FGuid& RoomId : VisitedRooms_DEPRECATED)
+		{
+			AddRoomProgress(RoomId, EAstroRoomProgress::Visited);
+		}
+		for (const FGuid& RoomId : CompletedRooms_DEPRECATED)
+		{
+			AddRoomProgress(RoomId, EAstroRoomProgress::Completed);
+		}
+
+		UnlockedRooms_DEPRECATED.Empty();
+		VisitedRooms_DEPRECATED.Empty();
+		CompletedRooms_DEPRECATED.Empty();
+	}
+
+	Version = static_cast<int32>(EAstroCampaignSaveGameVersion::Latest);
+}
+
+const FAstroRoomProgressBits& UAstroCampaignSaveGame::GetRoomProgressBits(const EAstroRoomProgress Progress) const
+{
+	switch (Progress)
+	{
+	case EAstroRoomProgress::Unlocked:
+		return UnlockedRoomBits;
+	case EAstroRoomProgress::Visited:
+		return VisitedRoomBits;
+	case EAstroRoomProgress::Completed:
+	default:
+		return CompletedRoomBits;
+	}
+}
+
+FAstroRoomProgressBits& UAstroCampaignSaveGame::GetRoomProgressBits(const EAstroRoomProgress Progress)
+{
+	return const_cast<FAstroRoomProgressBits&>(static_cast<const UAstroCampaignSaveGame*>(this)->GetRoomProgressBits(Progress));
+}
+
+int32 UAstroCampaignSaveGame::FindRoomIndex(const FGuid& RoomId) const
+{
+	// The index map isn't serialized, so it's rebuilt lazily after loading or syncing the room table
+	if (RoomIndices.IsEmpty() && !RoomIds.IsEmpty())
+	{
+		RoomIndices.Reset();
+		for (int32 RoomIndex = 0; RoomIndex < RoomIds.Num(); RoomIndex++)
+		{
+			RoomIndices.FindOrAdd(RoomIds[RoomIndex], RoomIndex);
+		}
+	}
+
+	const int32* RoomIndex = RoomIndices.Find(RoomId);
+	return RoomIndex ? *RoomIndex : INDEX_NONE;
+}
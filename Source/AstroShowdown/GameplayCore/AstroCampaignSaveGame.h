@@ -11,28 +11,124 @@
 #include "GameFramework/SaveGame.h"
 #include "AstroCampaignSaveGame.generated.h"
 
+UENUM()
+enum class EAstroCampaignSaveGameVersion : int32
+{
+	/** Room progress stored as arrays of room GUIDs. */
+	RoomGuidArrays = 0,
+	/** Room progress stored as bitsets, indexed by the save game's room table. */
+	RoomProgressBitsets,
+
+	// -----<new versions must be added above this line>-----
+	VersionPlusOne,
+	Latest = VersionPlusOne - 1
+};
+
+UENUM()
+enum class EAstroRoomProgress : uint8
+{
+	Unlocked,
+	Visited,
+	Completed,
+};
+
+/** Dense bitset, serialized as 32-bit words. */
+USTRUCT()
+struct FAstroRoomProgressBits
+{
+	GENERATED_BODY()
+
+public:
+	bool Get(const int32 Index) const;
+	/** @return false if the bit was already set. */
+	bool Set(const int32 Index);
+	bool IsEmpty() const;
+
+	UPROPERTY()
+	TArray<uint32> Words;
+
+};
+
 UCLASS()
 class UAstroCampaignSaveGame : public USaveGame
 {
 	GENERATED_BODY()
 
+	/** Build and inspect legacy save games, which can't be created through the public API anymore. */
+	friend class FAstroCampaignSaveGameUpgradeTest;
+	friend class FAstroCampaignSaveGameLegacyLoadTest;
+
 public:
 	UAstroCampaignSaveGame();
 
+public:
+	/**
+	* Upgrades the save game to the latest version, and remaps its room table so that campaign rooms come first, in campaign order.
+	* Rooms with progress that aren't part of the campaign anymore are kept at the end of the table, so their progress is never lost.
+	*/
+	void SyncRoomTable(const TArray<FGuid>& CampaignRoomIds);
+
+	bool HasRoomProgress(const FGuid& RoomId, const EAstroRoomProgress Progress) const;
+
+	/** @return false if the room already had this progress, or if RoomId is invalid. */
+	bool AddRoomProgress(const FGuid& RoomId, const EAstroRoomProgress Progress);
+
+	bool HasAnyRoomProgress(const EAstroRoomProgress Progress) const;
+
+	/** @return Every room with a given progress, in room table order. */
+	TArray<FGuid> GetRoomsWithProgress(const EAstroRoomProgress Progress) const;
+
+	int32 GetVersion() const { return Version; }
+
+private:
+	/** Moves room progress from the GUID arrays of old save games into the bitsets. */
+	void UpgradeToLatestVersion();
+
+	const FAstroRoomProgressBits& GetRoomProgressBits(const EAstroRoomProgress Progress) const;
+	FAstroRoomProgressBits& GetRoomProgressBits(const EAstroRoomProgress Progress);
+
+	/** @return Index of a room in RoomIds, or INDEX_NONE if it's not in the room table. */
+	int32 FindRoomIndex(const FGuid& RoomId) const;
+
 public:
 	UPROPERTY()
-	TArray<FGuid> UnlockedRooms;
+	FGuid LastVisitedRoomId;
 
 	UPROPERTY()
-	TArray<FGuid> VisitedRooms;
+	TArray<uint8> DisplayedHints;
 
+private:
+	/**
+	* Version this save game was written with. Save games written before versioning existed load as RoomGuidArrays.
+	* NOTE: Defaults to the oldest version, as this is also what old save games load with. New save games are upgraded on their first sync or change.
+	*/
 	UPROPERTY()
-	TArray<FGuid> CompletedRooms;
+	int32 Version = static_cast<int32>(EAstroCampaignSaveGameVersion::RoomGuidArrays);
 
+	/** Room table. A room's bit in the progress bitsets is its index in this table. */
 	UPROPERTY()
-	FGuid LastVisitedRoomId;
+	TArray<FGuid> RoomIds;
 
 	UPROPERTY()
-	TArray<uint8> DisplayedHints;
+	FAstroRoomProgressBits UnlockedRoomBits;
+
+	UPROPERTY()
+	FAstroRoomProgressBits VisitedRoomBits;
+
+	UPROPERTY()
+	FAstroRoomProgressBits CompletedRoomBits;
+
+	/** Maps RoomIds to their index. Not serialized, as it's derived from RoomIds. */
+	mutable TMap<FGuid, int32> RoomIndices;
+
+	// NOTE: Room progress of RoomGuidArrays save games. These are still loaded, but never saved.
+	UPROPERTY()
+	TArray<FGuid> UnlockedRooms_DEPRECATED;
+
+	UPROPERTY()
+	TArray<FGuid> VisitedRooms_DEPRECATED;
+
+	UPROPERTY()
+	TArray<FGuid> CompletedRooms_DEPRECATED;
 
 };
@@ -9,7 +9,9 @@
 #include "AstroDashAimComponent.h"
 #include "AbilitySystemInterface.h"
 #include "AstroBall.h"
+#include "AstroBallPoolManager.h"
 #include "AstroController.h"
+#include "AstroPerfCounters.h"
 #include "AstroTimeDilationSubsystem.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/DecalComponent.h"
@@ -48,6 +50,27 @@ namespace AstroCVars
 		bEnableAimDebugTrace,
 		TEXT("When enabled, will show a debug trace for the aim cursor."),
 		ECVF_Default);
+
+	static bool bUseBallSpatialIndex = true;
+	static FAutoConsoleVariableRef CVarUseBallSpatialIndex(
+		TEXT("AstroDashAim.UseBallSpatialIndex"),
+		bUseBallSpatialIndex,
+		TEXT("When enabled, dash targets are found through the spatial index of active balls instead of a sphere trace."),
+		ECVF_Default);
+
+	static float TrajectoryRevalidationDistance = 10.f;
+	static FAutoConsoleVariableRef CVarTrajectoryRevalidationDistance(
+		TEXT("AstroDashAim.TrajectoryRevalidationDistance"),
+		TrajectoryRevalidationDistance,
+		TEXT("How much (in cm) the dash start or target has to move before the dash trajectory is traced again."),
+		ECVF_Default);
+
+	static int32 TrajectoryRevalidationMaxFrames = 10;
+	static FAutoConsoleVariableRef CVarTrajectoryRevalidationMaxFrames(
+		TEXT("AstroDashAim.TrajectoryRevalidationMaxFrames"),
+		TrajectoryRevalidationMaxFrames,
+		TEXT("Maximum amount of frames a dash trajectory validation is reused, so that moving obstacles are eventually picked up."),
+		ECVF_Default);
 }
 
 namespace AstroStatics
@@ -89,6 +112,9 @@ void UAstroDashAimComponent::ActivateAim()
 	}
 	ensure(CachedOwnerCharacterRadius > 0.f && CachedOwnerCharacterHalfHeight > 0.f);
 
+	DashSurfaceFlagsCache.Reset();
+	LastDashTrajectoryValidation.Reset();
+
 	CreateDashAimDecalCursor();
 	CreateDeflectAimDecalCursor();
 }
@@ -128,7 +154,7 @@ void UAstroDashAimComponent::UpdateAim()
 	{
 		if (AAstroBall* CurrentTargetBall = Cast<AAstroBall>(CurrentDashTarget))
 		{
-			TArray<FHitResult> BallHits;
+			TArray<FHitResult>& BallHits = SimulatedDeflectionHits;
 			SimulateBallTrajectory(DashTargetWorldPosition, CurrentTargetBall, /*OUT*/ BallHits);
 
 			const FHitResult& DeflectionTarget = BallHits.IsEmpty() ? FHitResult::FHitResult() : BallHits[0];
@@ -185,6 +211,11 @@ AActor* UAstroDashAimComponent::FindDashTarget(const FVector& DashTargetWorldPos
 		return nullptr;
 	}
 
+	if (AstroCVars::bUseBallSpatialIndex)
+	{
+		return FindDashTargetInBallIndex(DashTargetWorldPosition);
+	}
+
 	// Sets up trace debug parameters
 	const EDrawDebugTrace::Type DebugTraceType = AstroCVars::bEnableAimDebugTrace ? EDrawDebugTrace::Type::ForOneFrame : EDrawDebugTrace::Type::None;
 	constexpr float DebugDuration = 0.f;
@@ -194,6 +225,7 @@ AActor* UAstroDashAimComponent::FindDashTarget(const FVector& DashTargetWorldPos
 	constexpr bool bIgnoreSelf = true;
 	const TArray<AActor*> ActorsToIgnore { };
 	TArray<FHitResult> OutCandidateTargets;
+	AstroPerfCounters::AddTraceCalls();
 	UKismetSystemLibrary::SphereTraceMulti(GetOwner(), DashTargetWorldPosition, DashTargetWorldPosition, DashAimRadius, DashTargetChannel, bTraceComplex, ActorsToIgnore,
 		DebugTraceType, OUT OutCandidateTargets, bIgnoreSelf, FLinearColor::Red, FLinearColor::Green, DebugDuration);
 
@@ -220,10 +252,62 @@ AActor* UAstroDashAimComponent::FindDashTarget(const FVector& DashTargetWorldPos
 	return Target;
 }
 
+AActor* UAstroDashAimComponent::FindDashTargetInBallIndex(const FVector& DashTargetWorldPosition)
+{
+	UAstroBallPoolManager* BallPoolManager = UAstroBallPoolManager::Get(this);
+	if (!BallPoolManager)
+	{
+		return nullptr;
+	}
+
+	// NOTE: The sphere trace also hits balls that are only partially inside the aim radius. The index pads its queries by the biggest ball's radius to match that.
+	CandidateDashTargets.Reset();
+	BallPoolManager->GetActiveBallIndex().QueryBalls(DashTargetWorldPosition, DashAimRadius, OUT CandidateDashTargets);
+
+	// Finds the nearest target that would've been hit by the sphere trace
+	const ECollisionChannel DashTargetCollisionChannel = UEngineTypes::ConvertToCollisionChannel(DashTargetChannel);
+	AActor* Target = nullptr;
+	float NearestTargetDistance = 999999.f;
+	for (AAstroBall* CandidateTargetActor : CandidateDashTargets)
+	{
+		const UPrimitiveComponent* CandidateCollisionComponent = CandidateTargetActor->GetCollisionComponent();
+		if (!CandidateCollisionComponent || !CandidateCollisionComponent->IsQueryCollisionEnabled() || CandidateCollisionComponent->GetCollisionResponseToChannel(DashTargetCollisionChannel) == ECR_Ignore)
+		{
+			continue;
+		}
+
+		const float TargetDistance = FVector::Distance(DashTargetWorldPosition, CandidateTargetActor->GetActorLocation());
+		if (TargetDistance <= DashAimRadius + CandidateCollisionComponent->Bounds.SphereRadius && TargetDistance < NearestTargetDistance)
+		{
+			Target = CandidateTargetActor;
+			NearestTargetDistance = TargetDistance;
+		}
+	}
+
+	return Target;
+}
+
 namespace AstroStatics
 {
 	static const FName FloorCollisionProfileName = "CustomProfile_LevelFloor";
 	static const FName DashBlockTagName = "BlockDash";
+
+	static constexpr uint8 DashSurfaceFloorFlag = 1 << 0;
+	static constexpr uint8 DashSurfaceBlockFlag = 1 << 1;
+}
+
+uint8 UAstroDashAimComponent::GetDashSurfaceFlags(const UPrimitiveComponent* Component)
+{
+	if (const uint8* CachedFlags = DashSurfaceFlagsCache.Find(Component))
+	{
+		return *CachedFlags;
+	}
+
+	uint8 Flags = 0;
+	Flags |= Component->GetCollisionProfileName() == AstroStatics::FloorCollisionProfileName ? AstroStatics::DashSurfaceFloorFlag : 0;
+	Flags |= Component->ComponentHasTag(AstroStatics::DashBlockTagName) ? AstroStatics::DashSurfaceBlockFlag : 0;
+	DashSurfaceFlagsCache.Add(Component, Flags);
+	return Flags;
 }
 
 bool UAstroDashAimComponent::ValidateDashTargetLocation(OUT FVector& DashTargetWorldPosition)
@@ -234,7 +318,7 @@ bool UAstroDashAimComponent::ValidateDashTargetLocation(OUT FVector& DashTargetW
 	}
 
 	constexpr bool bTraceComplex = false;
-	const TArray<TEnumAsByte<EObjectTypeQuery>> TraceObjectTypes =
+	static const TArray<TEnumAsByte<EObjectTypeQuery>> TraceObjectTypes =
 	{
 		EObjectTypeQuery::ObjectTypeQuery1,		// WorldStatic (walls, floors)
 		EObjectTypeQuery::ObjectTypeQuery8,		// CustomObject_InvisibleRift
@@ -250,12 +334,18 @@ bool UAstroDashAimComponent::ValidateDashTargetLocation(OUT FVector& DashTargetW
 	for (const FHitResult& CursorTraceHit : CursorTraceHits)
 	{
 		const UPrimitiveComponent* HitComponent = CursorTraceHit.GetComponent();
-		if (CursorTraceHit.bBlockingHit && HitComponent && HitComponent->ComponentHasTag(AstroStatics::DashBlockTagName))
+		if (!CursorTraceHit.bBlockingHit || !HitComponent)
+		{
+			continue;
+		}
+
+		const uint8 HitSurfaceFlags = GetDashSurfaceFlags(HitComponent);
+		if (HitSurfaceFlags & AstroStatics::DashSurfaceBlockFlag)
 		{
 			return false;
 		}
 
-		if (CursorTraceHit.bBlockingHit && HitComponent && HitComponent->GetCollisionProfileName() == AstroStatics::FloorCollisionProfileName)
+		if (HitSurfaceFlags & AstroStatics::DashSurfaceFloorFlag)
 		{
 			DashTargetWorldPosition = CursorTraceHit.Location;
 			return true;
@@ -272,6 +362,32 @@ bool UAstroDashAimComponent::ValidateDashTrajectory(const FVector& DashStartPosi
 		return false;
 	}
 
+	// Reuses the last validation while the dash barely moved, since the capsule trace is the most expensive part of aiming
+	AActor* DashTargetActor = CurrentAimResult.IsSet() ? CurrentAimResult->DashTargetActor : nullptr;
+	if (LastDashTrajectoryValidation.IsSet())
+	{
+		const float RevalidationDistanceSquared = FMath::Square(AstroCVars::TrajectoryRevalidationDistance);
+		const bool bMovedStart = FVector::DistSquared(LastDashTrajectoryValidation->DashStartPosition, DashStartPosition) > RevalidationDistanceSquared;
+		const bool bMovedTarget = FVector::DistSquared(LastDashTrajectoryValidation->DashTargetPosition, DashTargetPosition) > RevalidationDistanceSquared;
+		const bool bChangedTarget = LastDashTrajectoryValidation->DashTargetActor.Get() != DashTargetActor;
+		const bool bIsStale = GFrameCounter - LastDashTrajectoryValidation->ValidationFrame > static_cast<uint64>(FMath::Max(AstroCVars::TrajectoryRevalidationMaxFrames, 0));
+		if (!bMovedStart && !bMovedTarget && !bChangedTarget && !bIsStale && !AstroCVars::bEnableAimDebugTrace)
+		{
+			return LastDashTrajectoryValidation->bIsValid;
+		}
+	}
+
+	FDashTrajectoryValidation& DashTrajectoryValidation = LastDashTrajectoryValidation.Emplace();
+	DashTrajectoryValidation.DashStartPosition = DashStartPosition;
+	DashTrajectoryValidation.DashTargetPosition = DashTargetPosition;
+	DashTrajectoryValidation.DashTargetActor = DashTargetActor;
+	DashTrajectoryValidation.ValidationFrame = GFrameCounter;
+	DashTrajectoryValidation.bIsValid = TraceDashTrajectory(DashStartPosition, DashTargetPosition);
+	return DashTrajectoryValidation.bIsValid;
+}
+
+bool UAstroDashAimComponent::TraceDashTrajectory(const FVector& DashStartPosition, const FVector& DashTargetPosition)
+{
 	// Sets up trace parameters
 	const EDrawDebugTrace::Type DebugTraceType = AstroCVars::bEnableAimDebugTrace ? EDrawDebugTrace::Type::ForOneFrame : EDrawDebugTrace::Type::None;
 	const float DebugDuration = 0.f;
@@ -283,6 +399,7 @@ bool UAstroDashAimComponent::ValidateDashTrajectory(const FVector& DashStartPosi
 
 	// Performs trace to check if the dash would hit anything
 	FHitResult TraceResult;
+	AstroPerfCounters::AddTraceCalls();
 	bool bHitSomething = UKismetSystemLibrary::CapsuleTraceSingleByProfile(this, DashStartPosition, DashTargetPosition,
 		CachedOwnerCharacterRadius, CachedOwnerCharacterHalfHeight, AstroStatics::DashingPawnCollisionProfileName, bTraceComplex, ActorsToIgnore,
 		DebugTraceType, OUT TraceResult, bTraceComplex, TraceColor, TraceHitColor, DebugDuration);
@@ -297,7 +414,7 @@ void UAstroDashAimComponent::SimulateBallTrajectory(const FVector& DashTargetWor
 
 	FVector DeflectionDirection;
 	AstroUtils::Private::CalculateDeflectionDirection(DashTargetWorldPosition, Ball, DeflectionDirection);
-	Ball->SimulateTrajectory(DeflectionDirection, Hits, BallRadiusMultiplier);
+	TrajectorySolver.Solve(Ball, DeflectionDirection, OUT Hits, BallRadiusMultiplier);
 }
 
 bool UAstroDashAimComponent::ShouldAimAssistDeflection(const FVector& DashTargetWorldPosition)
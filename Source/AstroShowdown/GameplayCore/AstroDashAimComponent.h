@@ -8,14 +8,18 @@
 
 #pragma once
 
+#include "AstroBallTrajectorySolver.h"
 #include "Components/ActorComponent.h"
 #include "Engine/HitResult.h"
+#include "UObject/ObjectKey.h"
 #include "AstroDashAimComponent.generated.h"
 
+class AAstroBall;
 class AAstroController;
 class UNiagaraComponent;
 class UNiagaraSystem;
 class UMaterialInterface;
+class UPrimitiveComponent;
 
 USTRUCT(BlueprintType)
 struct FAstroDashAimResult
@@ -73,6 +77,9 @@ private:
 	AActor* FindDashTarget(const FVector& DashTargetWorldPosition);
 	bool ValidateDashTargetLocation(OUT FVector& DashTargetWorldPosition);
 	bool ValidateDashTrajectory(const FVector& DashStartPosition, const FVector& DashTargetPosition);
+	bool TraceDashTrajectory(const FVector& DashStartPosition, const FVector& DashTargetPosition);
+	uint8 GetDashSurfaceFlags(const UPrimitiveComponent* Component);
+	AActor* FindDashTargetInBallIndex(const FVector& DashTargetWorldPosition);
 	void SimulateBallTrajectory(const FVector& DashTargetWorldPosition, class AAstroBall* Ball, OUT TArray<FHitResult>& Hits);
 	bool ShouldAimAssistDeflection(const FVector& DashTargetWorldPosition);
 
@@ -147,4 +154,30 @@ private:
 	float CachedOwnerCharacterRadius = 0.f;
 	float CachedOwnerCharacterHalfHeight = 0.f;
 
+	/** Owned per component, so that trajectory queries and bounce buffers are reused every aim frame. */
+	FAstroBallTrajectorySolver TrajectorySolver;
+
+	/** Scratch buffer for the simulated deflection, which is only copied into CurrentAimResult when the target changes. */
+	TArray<FHitResult> SimulatedDeflectionHits;
+
+	/** Scratch buffer for the dash target candidates. */
+	TArray<AAstroBall*> CandidateDashTargets;
+
+	/**
+	* Collision profile and tag checks of every surface hit by the cursor during the current aim, packed as flags.
+	* NOTE: This is reset whenever the aim is activated, so that surfaces changed between aims are picked up.
+	*/
+	TMap<TObjectKey<UPrimitiveComponent>, uint8> DashSurfaceFlagsCache;
+
+	/** Last dash trajectory validation. The capsule trace only runs again once the dash moves far enough, or the target changes. */
+	struct FDashTrajectoryValidation
+	{
+		FVector DashStartPosition = FVector::ZeroVector;
+		FVector DashTargetPosition = FVector::ZeroVector;
+		TWeakObjectPtr<AActor> DashTargetActor = nullptr;
+		uint64 ValidationFrame = 0;
+		bool bIsValid = false;
+	};
+	TOptional<FDashTrajectoryValidation> LastDashTrajectoryValidation;
+
 };
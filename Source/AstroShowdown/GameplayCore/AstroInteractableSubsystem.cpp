@@ -0,0 +1,300 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#include "AstroInteractableSubsystem.h"
+#include "AstroInteractableInterface.h"
+#include "Engine/Engine.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AstroInteractableSubsystem)
+
+namespace AstroInteractableVars
+{
+	static float CellSize = 500.f;
+	static FAutoConsoleVariableRef CVarCellSize(
+		TEXT("AstroInteractable.CellSize"),
+		CellSize,
+		TEXT("Size (in cm) of each cell of the interactable grid. Should be close to the interaction radius."),
+		ECVF_Default);
+}
+
+void UAstroInteractableSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UWorld* World = GetWorld())
+	{
+		ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::OnActorSpawned));
+	}
+
+	LevelAddedToWorldHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ThisClass::OnLevelAddedToWorld);
+}
+
+void UAstroInteractableSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+	ActorSpawnedHandle.Reset();
+
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedToWorldHandle);
+	LevelAddedToWorldHandle.Reset();
+
+	Entries.Reset();
+	EntryIndices.Reset();
+	Cells.Reset();
+
+	Super::Deinitialize();
+}
+
+void UAstroInteractableSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Picks up interactables that were placed in the persistent level. Spawned and streamed ones are picked up by their own handlers.
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+	{
+		RegisterPolledInteractable(*It);
+	}
+}
+
+UAstroInteractableSubsystem* UAstroInteractableSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UAstroInteractableSubsystem>() : nullptr;
+}
+
+void UAstroInteractableSubsystem::RegisterInteractable(AActor* Interactable, const bool bPushesState)
+{
+	if (!Interactable)
+	{
+		return;
+	}
+
+	if (const int32* ExistingEntryIndex = EntryIndices.Find(Interactable))
+	{
+		// NOTE: Registration order between the interactable and the spawn handler isn't guaranteed, so a polled entry may be upgraded later
+		Entries[*ExistingEntryIndex].bPushesState |= bPushesState;
+		return;
+	}
+
+	FAstroInteractableEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Interactable = Interactable;
+	Entry.InteractableKey = Interactable;
+	Entry.Location = Interactable->GetActorLocation();
+	Entry.Cell = GetCell(Entry.Location);
+	Entry.bPushesState = bPushesState;
+	Entry.bMovable = Interactable->IsRootComponentMovable();
+
+	const int32 EntryIndex = Entries.Num() - 1;
+	EntryIndices.Add(Interactable, EntryIndex);
+	AddToCell(Entry.Cell, EntryIndex);
+}
+
+void UAstroInteractableSubsystem::UnregisterInteractable(AActor* Interactable)
+{
+	if (const int32* EntryIndex = Interactable ? EntryIndices.Find(Interactable) : nullptr)
+	{
+		RemoveAt(*EntryIndex);
+	}
+}
+
+void UAstroInteractableSubsystem::SetInteractableState(AActor* Interactable, const bool bInteractable, const double InteractableFromTime/* = 0.0*/)
+{
+	const int32* EntryIndex = Interactable ? EntryIndices.Find(Interactable) : nullptr;
+	if (!EntryIndex)
+	{
+		return;
+	}
+
+	FAstroInteractableEntry& Entry = Entries[*EntryIndex];
+	ensureMsgf(Entry.bPushesState, TEXT("Only interactables that registered with bPushesState should push their state."));
+	Entry.bInteractable = bInteractable;
+	Entry.InteractableFromTime = InteractableFromTime;
+}
+
+AActor* UAstroInteractableSubsystem::FindClosestInteractable(const FVector& Origin, const float Radius)
+{
+	const UWorld* World = GetWorld();
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	RefreshEntries();
+
+	const double CurrentTime = World->GetTimeSeconds();
+	const float RadiusSqr = FMath::Square(Radius);
+	AActor* ClosestInteractable = nullptr;
+	float ClosestDistanceSqr = TNumericLimits<float>::Max();
+
+	const FIntPoint MinCell = GetCell(Origin - FVector(Radius, Radius, 0.f));
+	const FIntPoint MaxCell = GetCell(Origin + FVector(Radius, Radius, 0.f));
+	for (int32 CellX = MinCell.X; CellX <= MaxCell.X; CellX++)
+	{
+		for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; CellY++)
+		{
+			const TArray<int32>* CellEntries = Cells.Find(FIntPoint(CellX, CellY));
+			if (!CellEntries)
+			{
+				continue;
+			}
+
+			for (const int32 EntryIndex : *CellEntries)
+			{
+				const FAstroInteractableEntry& Entry = Entries[EntryIndex];
+				const float DistanceSqr = FVector::DistSquared(Origin, Entry.Location);
+				if (DistanceSqr > RadiusSqr || DistanceSqr >= ClosestDistanceSqr)
+				{
+					continue;
+				}
+
+				// NOTE: The distance checks come first, so that polled interactables are only queried when they're actually in range
+				if (IsEntryInteractable(Entry, CurrentTime))
+				{
+					ClosestInteractable = Entry.Interactable.Get();
+					ClosestDistanceSqr = DistanceSqr;
+				}
+			}
+		}
+	}
+
+	return ClosestInteractable;
+}
+
+void UAstroInteractableSubsystem::RefreshEntries()
+{
+	if (LastRefreshFrame == GFrameCounter)
+	{
+		return;
+	}
+	LastRefreshFrame = GFrameCounter;
+
+	if (ActiveCellSize != AstroInteractableVars::CellSize)
+	{
+		ActiveCellSize = AstroInteractableVars::CellSize;
+		Cells.Reset();
+		for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); EntryIndex++)
+		{
+			FAstroInteractableEntry& Entry = Entries[EntryIndex];
+			Entry.Cell = GetCell(Entry.Location);
+			AddToCell(Entry.Cell, EntryIndex);
+		}
+	}
+
+	// Iterates backwards, as interactables that were destroyed without unregistering are swapped out of the list
+	for (int32 EntryIndex = Entries.Num() - 1; EntryIndex >= 0; EntryIndex--)
+	{
+		FAstroInteractableEntry& Entry = Entries[EntryIndex];
+		const AActor* Interactable = Entry.Interactable.Get();
+		if (!Interactable)
+		{
+			RemoveAt(EntryIndex);
+			continue;
+		}
+
+		if (!Entry.bMovable)
+		{
+			continue;
+		}
+
+		Entry.Location = Interactable->GetActorLocation();
+		const FIntPoint NewCell = GetCell(Entry.Location);
+		if (NewCell != Entry.Cell)
+		{
+			RemoveFromCell(Entry.Cell, EntryIndex);
+			AddToCell(NewCell, EntryIndex);
+			Entry.Cell = NewCell;
+		}
+	}
+}
+
+bool UAstroInteractableSubsystem::IsEntryInteractable(const FAstroInteractableEntry& Entry, const double CurrentTime) const
+{
+	if (Entry.bPushesState)
+	{
+		return Entry.bInteractable && CurrentTime >= Entry.InteractableFromTime;
+	}
+
+	AActor* Interactable = Entry.Interactable.Get();
+	return Interactable && IAstroInteractableInterface::Execute_IsInteractable(Interactable);
+}
+
+FIntPoint UAstroInteractableSubsystem::GetCell(const FVector& Location) const
+{
+	const float CellSize = FMath::Max(ActiveCellSize > 0.f ? ActiveCellSize : AstroInteractableVars::CellSize, 1.f);
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void UAstroInteractableSubsystem::AddToCell(const FIntPoint& Cell, const int32 EntryIndex)
+{
+	Cells.FindOrAdd(Cell).Add(EntryIndex);
+}
+
+void UAstroInteractableSubsystem::RemoveFromCell(const FIntPoint& Cell, const int32 EntryIndex)
+{
+	if (TArray<int32>* CellEntries = Cells.Find(Cell))
+	{
+		CellEntries->RemoveSingleSwap(EntryIndex, EAllowShrinking::No);
+		if (CellEntries->IsEmpty())
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void UAstroInteractableSubsystem::RemoveAt(const int32 EntryIndex)
+{
+	// NOTE: The removed entry is swapped with the last one, so the last entry's index has to be patched wherever it's referenced
+	const int32 LastEntryIndex = Entries.Num() - 1;
+	RemoveFromCell(Entries[EntryIndex].Cell, EntryIndex);
+	EntryIndices.Remove(Entries[EntryIndex].InteractableKey);
+
+	if (EntryIndex != LastEntryIndex)
+	{
+		FAstroInteractableEntry& LastEntry = Entries[LastEntryIndex];
+		if (TArray<int32>* LastEntryCell = Cells.Find(LastEntry.Cell))
+		{
+			LastEntryCell->Remove(LastEntryIndex);
+			LastEntryCell->Add(EntryIndex);
+		}
+		EntryIndices.Add(LastEntry.InteractableKey, EntryIndex);
+	}
+
+	Entries.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+}
+
+void UAstroInteractableSubsystem::RegisterPolledInteractable(AActor* Actor)
+{
+	if (Actor && Actor->GetClass()->ImplementsInterface(UAstroInteractableInterface::StaticClass()))
+	{
+		constexpr bool bPushesState = false;
+		RegisterInteractable(Actor, bPushesState);
+	}
+}
+
+void UAstroInteractableSubsystem::OnActorSpawned(AActor* SpawnedActor)
+{
+	RegisterPolledInteractable(SpawnedActor);
+}
+
+void UAstroInteractableSubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (!Level || World != GetWorld())
+	{
+		return;
+	}
+
+	for (AActor* LevelActor : Level->Actors)
+	{
+		RegisterPolledInteractable(LevelActor);
+	}
+}
@@ -0,0 +1,103 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "AstroInteractableSubsystem.generated.h"
+
+struct FAstroInteractableEntry
+{
+	TWeakObjectPtr<AActor> Interactable;
+	TObjectKey<AActor> InteractableKey;
+	FVector Location = FVector::ZeroVector;
+	FIntPoint Cell = FIntPoint::ZeroValue;
+	double InteractableFromTime = 0.0;
+	uint8 bInteractable : 1 = false;
+	uint8 bPushesState : 1 = false;
+	/** Only movable interactables have their location refreshed. Static ones stay in the cell they were registered in. */
+	uint8 bMovable : 1 = false;
+};
+
+/**
+* AstroInteractableSubsystem is a registry with every interactable (i.e., actors implementing IAstroInteractableInterface) in the world.
+* Interactables are binned in a uniform 2D (XY) grid, so that UAstroInteractionComponent can find its focus without physics queries.
+*
+* Native interactables register themselves and push their interactable state whenever it changes. Interactables that don't
+* (e.g., Blueprint-only ones) are registered automatically when they begin play, and have their state polled only while they're in range.
+*/
+UCLASS()
+class ASTROSHOWDOWN_API UAstroInteractableSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+#pragma region UWorldSubsystem
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+#pragma endregion
+
+
+#pragma region UAstroInteractableSubsystem
+public:
+	static UAstroInteractableSubsystem* Get(const UObject* WorldContextObject);
+
+	/**
+	* Adds an interactable to the registry. Registering twice is a no-op, except that it may upgrade a polled interactable to a pushed one.
+	*
+	* @param bPushesState When true, the interactable promises to call SetInteractableState whenever its state changes, and
+	* IsInteractable will never be called on it by the registry.
+	*/
+	void RegisterInteractable(AActor* Interactable, const bool bPushesState);
+	void UnregisterInteractable(AActor* Interactable);
+
+	/**
+	* Updates the cached state of an interactable that pushes its own state.
+	*
+	* @param InteractableFromTime World time (dilated) from which the interactable becomes interactable. Useful for cooldowns,
+	* as the interactable doesn't need to push its state again once the cooldown expires.
+	*/
+	UFUNCTION(BlueprintCallable)
+	void SetInteractableState(AActor* Interactable, const bool bInteractable, const double InteractableFromTime = 0.0);
+
+	/** @return The closest interactable within Radius of Origin that is currently interactable, if any. */
+	AActor* FindClosestInteractable(const FVector& Origin, const float Radius);
+
+private:
+	/** Moves movable interactables to their current cells, and drops the ones that were destroyed without unregistering. */
+	void RefreshEntries();
+
+	bool IsEntryInteractable(const FAstroInteractableEntry& Entry, const double CurrentTime) const;
+
+	FIntPoint GetCell(const FVector& Location) const;
+	void AddToCell(const FIntPoint& Cell, const int32 EntryIndex);
+	void RemoveFromCell(const FIntPoint& Cell, const int32 EntryIndex);
+	void RemoveAt(const int32 EntryIndex);
+
+	/** Registers interactables that don't register themselves, so that they can still be polled. */
+	void RegisterPolledInteractable(AActor* Actor);
+	void OnActorSpawned(AActor* SpawnedActor);
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+
+private:
+	/** Dense list of registered interactables. Cells refer to interactables by their index in this list. */
+	TArray<FAstroInteractableEntry> Entries;
+	TMap<TObjectKey<AActor>, int32> EntryIndices;
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	/** Cell size the cells were built with. If the cvar changes, every interactable is moved on the next refresh. */
+	float ActiveCellSize = 0.f;
+	uint64 LastRefreshFrame = 0;
+
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle LevelAddedToWorldHandle;
+#pragma endregion
+
+};
@@ -11,10 +11,10 @@
 #include "AstroGameplayTags.h"
 #include "AstroIndicatorTypes.h"
 #include "AstroInteractableInterface.h"
+#include "AstroInteractableSubsystem.h"
 #include "Engine/World.h"
 #include "GameFramework/Actor.h"
 #include "GameFramework/GameplayMessageSubsystem.h"
-#include "Kismet/KismetSystemLibrary.h"
 
 
 DECLARE_LOG_CATEGORY_EXTERN(LogAstroInteract, Log, All);
@@ -52,38 +52,6 @@ void UAstroInteractionComponent::TickComponent(float DeltaTime, ELevelTick TickT
 	}
 }
 
-namespace AstroInteractionComponentUtils
-{
-	static AActor* FindClosestInteractableOverlapResult(const TArray<FOverlapResult>& OverlapResults, const FVector& Origin)
-	{
-		AActor* ClosestInteractableActor = nullptr;
-		float ClosestDistanceSqr = TNumericLimits<float>::Max();
-		
-		for (const FOverlapResult& OverlapResult : OverlapResults)
-		{
-			AActor* OverlappingActor = OverlapResult.GetActor();
-			const UClass* OverlappingActorClass = OverlappingActor ? OverlappingActor->GetClass() : nullptr;
-			if (OverlappingActor && OverlappingActorClass && OverlappingActorClass->ImplementsInterface(UAstroInteractableInterface::StaticClass()))
-			{
-				if (!IAstroInteractableInterface::Execute_IsInteractable(OverlappingActor))
-				{
-					continue;
-				}
-
-				const FVector InteractablePosition = OverlappingActor->GetActorLocation();
-				const float DistSqr = FVector::DistSquared(Origin, InteractablePosition);
-				if (DistSqr < ClosestDistanceSqr)
-				{
-					ClosestInteractableActor = OverlappingActor;
-					ClosestDistanceSqr = DistSqr;
-				}
-			}
-		}
-
-		return ClosestInteractableActor;
-	}
-}
-
 void UAstroInteractionComponent::Interact(AAstroCharacter* Instigator)
 {
 	if (!Instigator)
@@ -114,10 +82,8 @@ void UAstroInteractionComponent::Interact(AAstroCharacter* Instigator)
 
 void UAstroInteractionComponent::FindInteractionFocus()
 {
-	ensureMsgf(InteractionTargetChannel != ECollisionChannel::ECC_MAX, TEXT("You forgot to configure InteractionTargetChannel"));
-
-	UWorld* World = GetWorld();
-	if (!World)
+	UAstroInteractableSubsystem* InteractableSubsystem = UAstroInteractableSubsystem::Get(this);
+	if (!InteractableSubsystem)
 	{
 		SetInteractionFocus(nullptr);
 		return;
@@ -130,21 +96,11 @@ void UAstroInteractionComponent::FindInteractionFocus()
 		return;
 	}
 
-	// Finds all overlapping interactables
-	TArray<FOverlapResult> OverlapResults;
-	{
-		const FVector OverlapPosition = ComponentOwner->GetActorLocation();
-		const FQuat OverlapRotation = FQuat::Identity;
-		const FCollisionShape OverlapShape = FCollisionShape::MakeSphere(InteractionRadius);
-		World->OverlapMultiByChannel(OUT OverlapResults, OverlapPosition, OverlapRotation, InteractionTargetChannel, OverlapShape);
-	}
-
-	// Finds the closest overlapping interactable, and then sets it as the current InteractionFocus
-	{
-		const FVector InteractionOrigin = ComponentOwner->GetActorLocation();
-		TScriptInterface<IAstroInteractableInterface> NewInteractionFocus = AstroInteractionComponentUtils::FindClosestInteractableOverlapResult(OverlapResults, InteractionOrigin);
-		SetInteractionFocus(NewInteractionFocus);
-	}
+	// Finds the closest registered interactable, and then sets it as the current InteractionFocus
+	// NOTE: This is a grid lookup against cached interactable states, so it doesn't issue any physics queries
+	const FVector InteractionOrigin = ComponentOwner->GetActorLocation();
+	TScriptInterface<IAstroInteractableInterface> NewInteractionFocus = InteractableSubsystem->FindClosestInteractable(InteractionOrigin, InteractionRadius);
+	SetInteractionFocus(NewInteractionFocus);
 }
 
 void UAstroInteractionComponent::SetInteractionFocus(TScriptInterface<IAstroInteractableInterface> NewInteractionFocus)
@@ -169,8 +125,10 @@ void UAstroInteractionComponent::SetInteractionFocus(TScriptInterface<IAstroInte
 
 void UAstroInteractionComponent::RegisterInteractionIndicator()
 {
-	if (CurrentInteractionFocus.GetObject() && !IndicatorWidgetClass.GetAssetName().IsEmpty())
+	if (CurrentInteractionFocus.GetObject() && !IndicatorWidgetClass.GetAssetName().IsEmpty() && !bInteractionIndicatorRegistered)
 	{
+		bInteractionIndicatorRegistered = true;
+
 		FAstroIndicatorRegisterRequestMessage RegisterRequestMessage;
 		RegisterRequestMessage.IndicatorSettings.Owner = CastChecked<AActor>(CurrentInteractionFocus.GetObject());
 		RegisterRequestMessage.IndicatorSettings.IndicatorWidgetClassOverride = IndicatorWidgetClass;
@@ -184,8 +142,10 @@ void UAstroInteractionComponent::RegisterInteractionIndicator()
 
 void UAstroInteractionComponent::UnregisterInteractionIndicator()
 {
-	if (CurrentInteractionFocus.GetObject() && !IndicatorWidgetClass.GetAssetName().IsEmpty())
+	if (CurrentInteractionFocus.GetObject() && bInteractionIndicatorRegistered)
 	{
+		bInteractionIndicatorRegistered = false;
+
 		FAstroIndicatorUnregisterRequestMessage UnregisterRequestMessage;
 		UnregisterRequestMessage.Owner = CastChecked<AActor>(CurrentInteractionFocus.GetObject());
 		UGameplayMessageSubsystem::Get(this).BroadcastMessage(AstroGameplayTags::Gameplay_Message_Indicator_Unregister, UnregisterRequestMessage);
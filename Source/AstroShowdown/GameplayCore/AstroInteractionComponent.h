@@ -38,9 +38,6 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Settings")
 	float InteractionInterval = 0.12f;
 
-	UPROPERTY(EditDefaultsOnly, Category = "Settings")
-	TEnumAsByte<ECollisionChannel> InteractionTargetChannel = ECollisionChannel::ECC_MAX;
-
 	UPROPERTY(EditDefaultsOnly, Category = "Settings|UI")
 	TSoftClassPtr<UAstroIndicatorWidget> IndicatorWidgetClass = nullptr;
 
@@ -50,6 +47,9 @@ public:
 private:
 	float InteractionIntervalCounter = 0.f;
 
+	/** True while an indicator is registered for CurrentInteractionFocus. Ensures indicator messages are only sent when it actually changes. */
+	uint8 bInteractionIndicatorRegistered : 1 = false;
+
 private:
 	UPROPERTY(Transient)
 	TScriptInterface<IAstroInteractableInterface> CurrentInteractionFocus = nullptr;
@@ -14,6 +14,16 @@
 #include "Engine/World.h"
 #include "TimerManager.h"
 
+namespace AstroLooseWallPropVars
+{
+	static bool bStepDeathAnimationOnCPU = false;
+	static FAutoConsoleVariableRef CVarStepDeathAnimationOnCPU(
+		TEXT("AstroLooseWallProp.StepDeathAnimationOnCPU"),
+		bStepDeathAnimationOnCPU,
+		TEXT("When enabled, loose wall death animations are stepped frame by frame on the game thread, instead of being played by the VAT material."),
+		ECVF_Default);
+}
+
 AAstroLooseWallProp::AAstroLooseWallProp(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer.SetDefaultSubobjectClass("PropStaticMeshComponent", UInstancedStaticMeshComponent::StaticClass()))	// Spawns an ISM instead of a regular StaticMesh
 {
@@ -66,32 +76,59 @@ void AAstroLooseWallProp::PlayIdleAnimation()
 
 	// Applies the frame data to all instances in the loose wall ISM
 	// NOTE: Animates using VAT, with the ML_BoneAnimation file. This only works because of InstancedStaticMesh > Details > Instances > Advanced > Custom Data Floats.
-	const int32 InstanceCount = CachedInstancedStaticMeshComponent->GetInstanceCount();
 	const float AnimationOffset = FMath::FRandRange(0.f, 1.f);
-	for (int32 InstanceIndex = 0; InstanceIndex < InstanceCount; InstanceIndex++)
-	{
-		CachedInstancedStaticMeshComponent->SetCustomDataValue(InstanceIndex, 0 /*CustomDataIndex*/, IdleAnimationFrameData.TimeOffset + AnimationOffset);
-		CachedInstancedStaticMeshComponent->SetCustomDataValue(InstanceIndex, 1 /*CustomDataIndex*/, IdleAnimationFrameData.PlayRate);
-		CachedInstancedStaticMeshComponent->SetCustomDataValue(InstanceIndex, 2 /*CustomDataIndex*/, IdleAnimationFrameData.StartFrame);
-		CachedInstancedStaticMeshComponent->SetCustomDataValue(InstanceIndex, 3 /*CustomDataIndex*/, IdleAnimationFrameData.EndFrame);
-	}
+	const float IdleAnimationCustomData[] = { IdleAnimationFrameData.TimeOffset + AnimationOffset, IdleAnimationFrameData.PlayRate, IdleAnimationFrameData.StartFrame, IdleAnimationFrameData.EndFrame };
+	SetAllInstancesCustomData(IdleAnimationCustomData);
 }
 
 void AAstroLooseWallProp::PlayDeathAnimation()
 {
-	// Updates the animation start timestamp, if it's not been initialized yet
 	const UWorld* World = GetWorld();
-	if (DeathAnimationStartTimestamp <= 0.f)
+	if (!CachedInstancedStaticMeshComponent || !World || !AnimToTextureData || GetDeathAnimationDuration() <= 0.f)
 	{
-		DeathAnimationStartTimestamp = World ? World->GetTimeSeconds() : 0.f;
+		Destroy();
+		return;
 	}
 
+	DeathAnimationStartTimestamp = World->GetTimeSeconds();
+
+	if (AstroLooseWallPropVars::bStepDeathAnimationOnCPU)
+	{
+		StepDeathAnimation();
+		return;
+	}
+
+	// Gets the autoplay data for the death animation
+	// NOTE: The VAT material plays from the (dilated) world time, so offsetting it by the start timestamp makes the animation start at its first frame
+	FAnimToTextureAutoPlayData DeathAnimationAutoPlayData;
+	const int32 DeathAnimationIndex = GetAnimationSequenceIndex(true /*bIsHitAnimation*/);
+	const bool bSuccess = UAnimToTextureInstancePlaybackLibrary::GetAutoPlayDataFromDataAsset(AnimToTextureData, DeathAnimationIndex, OUT DeathAnimationAutoPlayData, -DeathAnimationStartTimestamp /*TimeOffset*/);
+	if (!bSuccess)
+	{
+		Destroy();
+		return;
+	}
+
+	// Applies the autoplay data to all instances in the loose wall ISM, once. From then on, the material animates them on its own.
+	const float DeathAnimationCustomData[] = { DeathAnimationAutoPlayData.TimeOffset, DeathAnimationAutoPlayData.PlayRate, DeathAnimationAutoPlayData.StartFrame, DeathAnimationAutoPlayData.EndFrame };
+	SetAllInstancesCustomData(DeathAnimationCustomData);
+
+	// Self-destroys once the animation ends
+	// NOTE: AutoPlay loops, so we're destroying the wall half a frame early, to avoid showing the first frame again
+	const float HalfFrameDuration = AnimToTextureData->SampleRate > 0.f ? 0.5f / AnimToTextureData->SampleRate : 0.f;
+	const float DeathAnimationRemainingTime = FMath::Max(GetDeathAnimationDuration() - HalfFrameDuration, KINDA_SMALL_NUMBER);
+	World->GetTimerManager().SetTimer(DeathAnimationTimerHandle, this, &AAstroLooseWallProp::OnDeathAnimationFinished, DeathAnimationRemainingTime);
+}
+
+void AAstroLooseWallProp::StepDeathAnimation()
+{
 	// Self-destroys if the animation has ended OR there's any invalid object
+	const UWorld* World = GetWorld();
 	const float AnimationElapsedTime = GetDeathAnimationElapsedTime();
 	const float AnimationLength = GetDeathAnimationDuration();
 	if (AnimationElapsedTime >= AnimationLength || !CachedInstancedStaticMeshComponent || !World)
 	{
-		Destroy();
+		OnDeathAnimationFinished();
 		return;
 	}
 
@@ -101,26 +138,46 @@ void AAstroLooseWallProp::PlayDeathAnimation()
 	const bool bSuccess = UAnimToTextureInstancePlaybackLibrary::GetFrameDataFromDataAsset(AnimToTextureData, DeathAnimationIndex, AnimationElapsedTime, OUT DeathAnimationFrameData);
 	if (!bSuccess)
 	{
-		Destroy();
+		OnDeathAnimationFinished();
 		return;
 	}
 
-	// Applies the frame data to all instances in the loose wall ISM
-	// NOTE (1): Animates using VAT, with the ML_BoneAnimation file. This only works because of InstancedStaticMesh > Details > Instances > Advanced > Custom Data Floats.
-	// NOTE (2): AutoPlay is enabled for this VAT, but we're want to play this frame-by-frame, which is not allowed. We're working around this limitation by setting TimeOffset
+	// Applies the frame data to all instances in the loose wall ISM, but only if the frame actually changed
+	// NOTE: AutoPlay is enabled for this VAT, but we're want to play this frame-by-frame, which is not allowed. We're working around this limitation by setting TimeOffset
 	// and PlayRate to 0, so we can avoid AutoPlay and display only the frame that we want to.
-	const int32 InstanceCount = CachedInstancedStaticMeshComponent->GetInstanceCount();
-	for (int32 InstanceIndex = 0; InstanceIndex < InstanceCount; InstanceIndex++)
+	if (DeathAnimationFrameData.Frame != LastSteppedDeathAnimationFrame)
 	{
-		CachedInstancedStaticMeshComponent->SetCustomDataValue(InstanceIndex, 0 /*CustomDataIndex*/, 0.f /*VAT.TimeOffset*/);
-		CachedInstancedStaticMeshComponent->SetCustomDataValue(InstanceIndex, 1 /*CustomDataIndex*/, 0.f /*VAT.PlayRate*/);
-		CachedInstancedStaticMeshComponent->SetCustomDataValue(InstanceIndex, 2 /*CustomDataIndex*/, DeathAnimationFrameData.Frame /*VAT.StartFrame*/);
-		CachedInstancedStaticMeshComponent->SetCustomDataValue(InstanceIndex, 3 /*CustomDataIndex*/, DeathAnimationFrameData.Frame /*VAT.EndFrame*/);
+		const float DeathAnimationCustomData[] = { 0.f /*VAT.TimeOffset*/, 0.f /*VAT.PlayRate*/, DeathAnimationFrameData.Frame /*VAT.StartFrame*/, DeathAnimationFrameData.Frame /*VAT.EndFrame*/ };
+		SetAllInstancesCustomData(DeathAnimationCustomData);
+		LastSteppedDeathAnimationFrame = DeathAnimationFrameData.Frame;
 	}
 
 	// Schedules the next frame
 	const float FrameRate = 1.0f / AnimToTextureData->SampleRate;
-	World->GetTimerManager().SetTimer(DeathAnimationTimerHandle, this, &AAstroLooseWallProp::PlayDeathAnimation, FrameRate);
+	World->GetTimerManager().SetTimer(DeathAnimationTimerHandle, this, &AAstroLooseWallProp::StepDeathAnimation, FrameRate);
+}
+
+void AAstroLooseWallProp::OnDeathAnimationFinished()
+{
+	Destroy();
+}
+
+void AAstroLooseWallProp::SetAllInstancesCustomData(const TArrayView<const float> CustomData)
+{
+	if (!CachedInstancedStaticMeshComponent)
+	{
+		return;
+	}
+
+	// NOTE: Writes every instance without dirtying the render state, and then dirties it once for the whole batch
+	constexpr bool bMarkRenderStateDirty = false;
+	const int32 InstanceCount = CachedInstancedStaticMeshComponent->GetInstanceCount();
+	for (int32 InstanceIndex = 0; InstanceIndex < InstanceCount; InstanceIndex++)
+	{
+		CachedInstancedStaticMeshComponent->SetCustomData(InstanceIndex, CustomData, bMarkRenderStateDirty);
+	}
+
+	CachedInstancedStaticMeshComponent->MarkRenderStateDirty();
 }
 
 void AAstroLooseWallProp::StopDeathAnimation()
@@ -45,12 +45,27 @@ private:
 	FTimerHandle DeathAnimationTimerHandle;
 	float DeathAnimationStartTimestamp = -1.f;
 
+	/** Last frame written by StepDeathAnimation. Frames are only written when they change. */
+	float LastSteppedDeathAnimationFrame = -1.f;
+
 private:
 	void PlayIdleAnimation();
 
+	/**
+	* Starts the death animation. By default, writes the start timestamp once, and lets the VAT material compute the current frame from time.
+	* The wall is then destroyed by a single timer once the animation ends.
+	*/
 	void PlayDeathAnimation();
 	void StopDeathAnimation();
 
+	/** CPU-driven fallback for the death animation, which writes the current frame once per animation frame. */
+	void StepDeathAnimation();
+
+	void OnDeathAnimationFinished();
+
+	/** Writes the same VAT custom data to every instance, and then marks the render state dirty once. */
+	void SetAllInstancesCustomData(const TArrayView<const float> CustomData);
+
 private:
 	/** @return Length in seconds of the death animation. */
 	float GetDeathAnimationDuration() const;
@@ -0,0 +1,231 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#include "AstroOneShotAudioSubsystem.h"
+#include "AstroContextEffectsSubsystem.h"
+#include "AstroTimeDilationSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "FMODStudio/Classes/FMODEvent.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AstroOneShotAudioSubsystem)
+
+DECLARE_LOG_CATEGORY_EXTERN(LogAstroOneShotAudio, Log, All);
+DEFINE_LOG_CATEGORY(LogAstroOneShotAudio);
+
+namespace AstroOneShotAudioVars
+{
+	static float CoalesceWindow = 0.08f;
+	static FAutoConsoleVariableRef CVarCoalesceWindow(
+		TEXT("AstroOneShotAudio.CoalesceWindow"),
+		CoalesceWindow,
+		TEXT("Identical one-shots requested within this many (dilated) seconds and AstroOneShotAudio.CoalesceRadius of each other are played only once."),
+		ECVF_Default);
+
+	static float CoalesceRadius = 200.f;
+	static FAutoConsoleVariableRef CVarCoalesceRadius(
+		TEXT("AstroOneShotAudio.CoalesceRadius"),
+		CoalesceRadius,
+		TEXT("Distance (in cm) under which identical one-shots requested within AstroOneShotAudio.CoalesceWindow are played only once."),
+		ECVF_Default);
+
+	static float MinPlayInterval = 0.02f;
+	static FAutoConsoleVariableRef CVarMinPlayInterval(
+		TEXT("AstroOneShotAudio.MinPlayInterval"),
+		MinPlayInterval,
+		TEXT("Minimum (dilated) seconds between two plays of the same one-shot event, wherever they are."),
+		ECVF_Default);
+
+	static int32 MaxInstancesPerEvent = 4;
+	static FAutoConsoleVariableRef CVarMaxInstancesPerEvent(
+		TEXT("AstroOneShotAudio.MaxInstancesPerEvent"),
+		MaxInstancesPerEvent,
+		TEXT("Maximum amount of live instances of the same one-shot event. Once reached, the oldest instance is stopped to make room for the new one."),
+		ECVF_Default);
+
+	static float TimeDilationPitchScale = 0.5f;
+	static FAutoConsoleVariableRef CVarTimeDilationPitchScale(
+		TEXT("AstroOneShotAudio.TimeDilationPitchScale"),
+		TimeDilationPitchScale,
+		TEXT("How much of the global time dilation is applied to the pitch of new one-shots. 0 ignores time dilation, 1 matches it."),
+		ECVF_Default);
+
+	static float MinTimeDilationPitch = 0.5f;
+	static FAutoConsoleVariableRef CVarMinTimeDilationPitch(
+		TEXT("AstroOneShotAudio.MinTimeDilationPitch"),
+		MinTimeDilationPitch,
+		TEXT("Lowest pitch time dilation may apply to a one-shot."),
+		ECVF_Default);
+
+	static FAutoConsoleCommandWithWorld CVarDumpOneShotAudioStats(
+		TEXT("AstroOneShotAudio.DumpStats"),
+		TEXT("Prints the one-shot audio counters, for FMOD events and context effect sounds."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UAstroOneShotAudioSubsystem* OneShotAudioSubsystem = UAstroOneShotAudioSubsystem::Get(World))
+			{
+				OneShotAudioSubsystem->DumpOneShotAudioStats();
+			}
+		}));
+}
+
+void UAstroOneShotAudioSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Context effect sounds are spammed by the same hit chains as FMOD one-shots, so they share their budget
+	if (UAstroContextEffectsSubsystem* ContextEffectsSubsystem = Cast<UAstroContextEffectsSubsystem>(Collection.InitializeDependency(UAstroContextEffectsSubsystem::StaticClass())))
+	{
+		ContextEffectsSubsystem->ShouldSpawnSoundDelegate.BindUObject(this, &ThisClass::ShouldSpawnContextEffectSound);
+	}
+}
+
+void UAstroOneShotAudioSubsystem::Deinitialize()
+{
+	if (UAstroContextEffectsSubsystem* ContextEffectsSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UAstroContextEffectsSubsystem>() : nullptr)
+	{
+		if (ContextEffectsSubsystem->ShouldSpawnSoundDelegate.IsBoundToObject(this))
+		{
+			ContextEffectsSubsystem->ShouldSpawnSoundDelegate.Unbind();
+		}
+	}
+
+	EventStates.Empty();
+	ContextEffectSoundStates.Empty();
+
+	Super::Deinitialize();
+}
+
+UAstroOneShotAudioSubsystem* UAstroOneShotAudioSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UAstroOneShotAudioSubsystem>() : nullptr;
+}
+
+bool UAstroOneShotAudioSubsystem::PlayOneShot(UFMODEvent* Event, const FTransform& Transform)
+{
+	const UWorld* World = GetWorld();
+	if (!Event || !World)
+	{
+		return false;
+	}
+
+	// NOTE: Uses dilated time, so that bullet time, which slows down the balls, doesn't let more hits through
+	const double CurrentTime = World->GetTimeSeconds();
+	const FVector Location = Transform.GetLocation();
+
+	FAstroOneShotEventState& EventState = EventStates.FindOrAdd(Event);
+	if (!CheckOneShotBudget(EventState, Location, CurrentTime, OneShotAudioStats))
+	{
+		return false;
+	}
+
+	EventState.Instances.RemoveAll([](const FFMODEventInstance& EventInstance) { return !UFMODBlueprintStatics::EventInstanceIsValid(EventInstance); });
+	if (EventState.Instances.Num() >= FMath::Max(AstroOneShotAudioVars::MaxInstancesPerEvent, 1))
+	{
+		UFMODBlueprintStatics::EventInstanceStop(EventState.Instances[0]);
+		EventState.Instances.RemoveAt(0, 1, EAllowShrinking::No);
+		OneShotAudioStats.Stolen++;
+	}
+
+	constexpr bool bAutoPlay = false;
+	const FFMODEventInstance EventInstance = UFMODBlueprintStatics::PlayEventAtLocation(this, Event, Transform, bAutoPlay);
+	if (!EventInstance.Instance)
+	{
+		// NOTE: The world isn't audible (e.g., dedicated server), so there's nothing to track
+		return false;
+	}
+
+	const float TimeDilationPitch = GetTimeDilationPitch();
+	if (TimeDilationPitch != 1.f)
+	{
+		UFMODBlueprintStatics::EventInstanceSetPitch(EventInstance, TimeDilationPitch);
+	}
+
+	// Releasing right after playing matches PlayEventAtLocation's auto-play, so the instance is destroyed once it stops
+	UFMODBlueprintStatics::EventInstancePlay(EventInstance);
+	UFMODBlueprintStatics::EventInstanceRelease(EventInstance);
+
+	EventState.Instances.Add(EventInstance);
+	RecordOneShotPlay(EventState, Location, CurrentTime, OneShotAudioStats);
+	return true;
+}
+
+bool UAstroOneShotAudioSubsystem::PlayOneShotAtLocation(const UObject* WorldContextObject, UFMODEvent* Event, const FTransform& Transform)
+{
+	UAstroOneShotAudioSubsystem* OneShotAudioSubsystem = Get(WorldContextObject);
+	return OneShotAudioSubsystem ? OneShotAudioSubsystem->PlayOneShot(Event, Transform) : false;
+}
+
+void UAstroOneShotAudioSubsystem::DumpOneShotAudioStats() const
+{
+	UE_LOG(LogAstroOneShotAudio, Display, TEXT("[%hs] FMOD events: Requested=%d Played=%d Coalesced=%d RateLimited=%d Stolen=%d Events=%d"), __FUNCTION__,
+		OneShotAudioStats.Requested, OneShotAudioStats.Played, OneShotAudioStats.Coalesced, OneShotAudioStats.RateLimited, OneShotAudioStats.Stolen, EventStates.Num());
+	UE_LOG(LogAstroOneShotAudio, Display, TEXT("[%hs] Context effect sounds: Requested=%d Played=%d Coalesced=%d RateLimited=%d Sounds=%d"), __FUNCTION__,
+		ContextEffectSoundStats.Requested, ContextEffectSoundStats.Played, ContextEffectSoundStats.Coalesced, ContextEffectSoundStats.RateLimited, ContextEffectSoundStates.Num());
+}
+
+bool UAstroOneShotAudioSubsystem::CheckOneShotBudget(FAstroOneShotEventState& EventState, const FVector& Location, const double CurrentTime, FAstroOneShotAudioStats& Stats)
+{
+	Stats.Requested++;
+
+	// Only the most recent plays may still be within the window
+	EventState.RecentPlays.RemoveAll([CurrentTime](const FAstroOneShotPlay& OneShotPlay) { return CurrentTime - OneShotPlay.StartTime > AstroOneShotAudioVars::CoalesceWindow; });
+
+	const float CoalesceRadiusSqr = FMath::Square(AstroOneShotAudioVars::CoalesceRadius);
+	for (const FAstroOneShotPlay& OneShotPlay : EventState.RecentPlays)
+	{
+		if (FVector::DistSquared(Location, OneShotPlay.Location) <= CoalesceRadiusSqr)
+		{
+			Stats.Coalesced++;
+			return false;
+		}
+	}
+
+	if (CurrentTime - EventState.LastPlayTime < AstroOneShotAudioVars::MinPlayInterval)
+	{
+		Stats.RateLimited++;
+		return false;
+	}
+
+	return true;
+}
+
+void UAstroOneShotAudioSubsystem::RecordOneShotPlay(FAstroOneShotEventState& EventState, const FVector& Location, const double CurrentTime, FAstroOneShotAudioStats& Stats)
+{
+	EventState.RecentPlays.Add({ Location, CurrentTime });
+	EventState.LastPlayTime = CurrentTime;
+	Stats.Played++;
+}
+
+bool UAstroOneShotAudioSubsystem::ShouldSpawnContextEffectSound(const USoundBase* Sound, const FVector& Location)
+{
+	const UWorld* World = GetWorld();
+	if (!Sound || !World)
+	{
+		return true;
+	}
+
+	const double CurrentTime = World->GetTimeSeconds();
+	FAstroOneShotEventState& SoundState = ContextEffectSoundStates.FindOrAdd(Sound);
+	if (!CheckOneShotBudget(SoundState, Location, CurrentTime, ContextEffectSoundStats))
+	{
+		return false;
+	}
+
+	// NOTE: Recorded before the sound is spawned, as the context effects subsystem spawns it right after this
+	RecordOneShotPlay(SoundState, Location, CurrentTime, ContextEffectSoundStats);
+	return true;
+}
+
+float UAstroOneShotAudioSubsystem::GetTimeDilationPitch()
+{
+	const float GlobalTimeDilation = UAstroTimeDilationSubsystem::GetGlobalTimeDilation(this);
+	const float Pitch = FMath::Lerp(1.f, GlobalTimeDilation, FMath::Clamp(AstroOneShotAudioVars::TimeDilationPitchScale, 0.f, 1.f));
+	return FMath::Max(Pitch, FMath::Min(AstroOneShotAudioVars::MinTimeDilationPitch, 1.f));
+}
@@ -0,0 +1,125 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#pragma once
+
+#include "FMODStudio/Classes/FMODBlueprintStatics.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "AstroOneShotAudioSubsystem.generated.h"
+
+class UFMODEvent;
+class USoundBase;
+
+USTRUCT(BlueprintType)
+struct FAstroOneShotAudioStats
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly)
+	int32 Requested = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Played = 0;
+
+	/** Requests dropped because an identical event had just been played close to them. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 Coalesced = 0;
+
+	/** Requests dropped because their event was played anywhere less than the minimum interval ago. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 RateLimited = 0;
+
+	/** Playing instances that were stopped to make room for a new one, because their event was at its instance cap. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 Stolen = 0;
+
+};
+
+/**
+* AstroOneShotAudioSubsystem dispatches fire-and-forget FMOD events (e.g., ball hits), so that dense hit chains don't spike CPU and voices.
+* Identical requests that land close to each other are coalesced, each event is rate limited and capped to a number of live instances
+* (stealing the oldest one), and all windows are measured in dilated time, so bullet time doesn't let more events through.
+* Context effect sounds (UAstroContextEffectsSubsystem) go through the same coalescing and rate limiting, but they aren't capped.
+*/
+UCLASS()
+class ASTROSHOWDOWN_API UAstroOneShotAudioSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+#pragma region UWorldSubsystem
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+#pragma endregion
+
+
+#pragma region UAstroOneShotAudioSubsystem
+public:
+	static UAstroOneShotAudioSubsystem* Get(const UObject* WorldContextObject);
+
+	/**
+	* Plays a one-shot event at a given location, unless it's coalesced with or rate limited by a previous request of the same event.
+	* @return true if the event was actually played.
+	*/
+	bool PlayOneShot(UFMODEvent* Event, const FTransform& Transform);
+
+	/** Blueprint-friendly version of PlayOneShot. */
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject"))
+	static bool PlayOneShotAtLocation(const UObject* WorldContextObject, UFMODEvent* Event, const FTransform& Transform);
+
+	UFUNCTION(BlueprintPure)
+	FAstroOneShotAudioStats GetOneShotAudioStats() const { return OneShotAudioStats; }
+
+	/** Counters of the context effect sounds. These are never stolen, as they aren't capped. */
+	UFUNCTION(BlueprintPure)
+	FAstroOneShotAudioStats GetContextEffectSoundStats() const { return ContextEffectSoundStats; }
+
+	void DumpOneShotAudioStats() const;
+
+private:
+	struct FAstroOneShotPlay
+	{
+		FVector Location = FVector::ZeroVector;
+		double StartTime = 0.0;
+	};
+
+	struct FAstroOneShotEventState
+	{
+		/** Plays that may still coalesce new requests, oldest first. */
+		TArray<FAstroOneShotPlay> RecentPlays;
+		double LastPlayTime = -UE_DOUBLE_BIG_NUMBER;
+
+		/** FMOD instances that may still be playing, oldest first. Context effect sounds don't track their instances. */
+		TArray<FFMODEventInstance> Instances;
+	};
+
+	/**
+	* Counts a request, and checks it against the coalescing and rate limiting of its event. Shared by FMOD events and context effect sounds.
+	* @return true if the one-shot may be played. It should then be recorded with RecordOneShotPlay once it's played.
+	*/
+	static bool CheckOneShotBudget(FAstroOneShotEventState& EventState, const FVector& Location, const double CurrentTime, FAstroOneShotAudioStats& Stats);
+
+	static void RecordOneShotPlay(FAstroOneShotEventState& EventState, const FVector& Location, const double CurrentTime, FAstroOneShotAudioStats& Stats);
+
+	/** Bound to UAstroContextEffectsSubsystem::ShouldSpawnSoundDelegate. */
+	bool ShouldSpawnContextEffectSound(const USoundBase* Sound, const FVector& Location);
+
+	/** Pitch applied to new instances, so that one-shots slow down along with the game during bullet time. */
+	float GetTimeDilationPitch();
+
+private:
+	TMap<TObjectKey<UFMODEvent>, FAstroOneShotEventState> EventStates;
+	TMap<TObjectKey<USoundBase>, FAstroOneShotEventState> ContextEffectSoundStates;
+
+	FAstroOneShotAudioStats OneShotAudioStats;
+	FAstroOneShotAudioStats ContextEffectSoundStats;
+#pragma endregion
+
+};
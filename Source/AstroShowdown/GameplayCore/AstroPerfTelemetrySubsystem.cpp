@@ -0,0 +1,337 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#include "AstroPerfTelemetrySubsystem.h"
+#include "AstroBallPoolManager.h"
+#include "AstroIndicatorWidgetManagerComponent.h"
+#include "AstroPerfCounters.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/GameplayMessageSubsystem.h"
+#include "GameFramework/GameStateBase.h"
+#include "HAL/FileManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "RenderCore.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogAstroPerfTelemetry, Log, All);
+DEFINE_LOG_CATEGORY(LogAstroPerfTelemetry);
+
+namespace AstroPerfTelemetryVars
+{
+	static float HitchThresholdMs = 50.f;
+	static FAutoConsoleVariableRef CVarHitchThresholdMs(
+		TEXT("AstroPerf.HitchThresholdMs"),
+		HitchThresholdMs,
+		TEXT("Frames that take longer than this (in milliseconds) are counted as hitches."),
+		ECVF_Default);
+
+	static int32 FrameHistorySize = 600;
+	static FAutoConsoleVariableRef CVarFrameHistorySize(
+		TEXT("AstroPerf.FrameHistorySize"),
+		FrameHistorySize,
+		TEXT("How many frames are kept in the telemetry history. Percentiles are computed over these frames."),
+		ECVF_Default);
+
+	static FAutoConsoleCommandWithWorldAndArgs CVarStartCsvCapture(
+		TEXT("AstroPerf.StartCsvCapture"),
+		TEXT("Starts streaming frame telemetry to a CSV file in the profiling directory. Usage: AstroPerf.StartCsvCapture [CaptureName]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UAstroPerfTelemetrySubsystem* PerfTelemetrySubsystem = UAstroPerfTelemetrySubsystem::Get(World))
+			{
+				PerfTelemetrySubsystem->StartCsvCapture(Args.IsEmpty() ? FString() : Args[0]);
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorld CVarStopCsvCapture(
+		TEXT("AstroPerf.StopCsvCapture"),
+		TEXT("Stops the current telemetry CSV capture."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UAstroPerfTelemetrySubsystem* PerfTelemetrySubsystem = UAstroPerfTelemetrySubsystem::Get(World))
+			{
+				PerfTelemetrySubsystem->StopCsvCapture();
+			}
+		}));
+}
+
+namespace AstroPerfTelemetryStatics
+{
+	static const TCHAR* CsvCaptureCommandLineParam = TEXT("AstroPerfCsv");
+	static const TCHAR* CsvHeader = TEXT("TimeSeconds,FrameMs,GameThreadMs,RenderThreadMs,ActiveBalls,PoolMisses,Indicators,MessageBroadcasts,TraceCalls\n");
+}
+
+void UAstroPerfTelemetrySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Allows soak runs to capture telemetry without a console, e.g., "-AstroPerfCsv" or "-AstroPerfCsv=NightlySoak"
+	FString CaptureName;
+	const TCHAR* CommandLine = FCommandLine::Get();
+	if (FParse::Value(CommandLine, *FString::Printf(TEXT("%s="), AstroPerfTelemetryStatics::CsvCaptureCommandLineParam), CaptureName))
+	{
+		StartCsvCapture(CaptureName);
+	}
+	else if (FParse::Param(CommandLine, AstroPerfTelemetryStatics::CsvCaptureCommandLineParam))
+	{
+		StartCsvCapture(FString());
+	}
+}
+
+void UAstroPerfTelemetrySubsystem::Deinitialize()
+{
+	StopCsvCapture();
+
+	Super::Deinitialize();
+}
+
+void UAstroPerfTelemetrySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	RecordFrame();
+}
+
+bool UAstroPerfTelemetrySubsystem::IsTickable() const
+{
+	return TelemetryRequestCount > 0 || IsCsvCaptureRunning();
+}
+
+TStatId UAstroPerfTelemetrySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAstroPerfTelemetrySubsystem, STATGROUP_Tickables);
+}
+
+UAstroPerfTelemetrySubsystem* UAstroPerfTelemetrySubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	return World ? World->GetSubsystem<UAstroPerfTelemetrySubsystem>() : nullptr;
+}
+
+void UAstroPerfTelemetrySubsystem::RequestTelemetry()
+{
+	if (TelemetryRequestCount++ == 0 && !IsCsvCaptureRunning())
+	{
+		ResetHistory();
+	}
+}
+
+void UAstroPerfTelemetrySubsystem::ReleaseTelemetry()
+{
+	ensureMsgf(TelemetryRequestCount > 0, TEXT("ReleaseTelemetry called without a matching RequestTelemetry."));
+	TelemetryRequestCount = FMath::Max(TelemetryRequestCount - 1, 0);
+}
+
+void UAstroPerfTelemetrySubsystem::StartCsvCapture(const FString& CaptureName)
+{
+	StopCsvCapture();
+
+	const FString CaptureFileName = FString::Printf(TEXT("%s_%s.csv"), CaptureName.IsEmpty() ? TEXT("AstroPerf") : *CaptureName, *FDateTime::Now().ToString());
+	const FString CaptureFilePath = FPaths::Combine(FPaths::ProfilingDir(), TEXT("AstroPerf"), CaptureFileName);
+	CsvWriter = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*CaptureFilePath));
+	if (!CsvWriter)
+	{
+		UE_LOG(LogAstroPerfTelemetry, Error, TEXT("[%hs] Failed to create telemetry capture file (%s)."), __FUNCTION__, *CaptureFilePath);
+		return;
+	}
+
+	// Build info comes first, so that captures from different builds can be told apart
+	const FString CsvPreamble = FString::Printf(TEXT("# Build=%s Engine=%s Config=%s Platform=%s\n%s"),
+		FApp::GetBuildVersion(), *FEngineVersion::Current().ToString(), LexToString(FApp::GetBuildConfiguration()), ANSI_TO_TCHAR(FPlatformProperties::PlatformName()),
+		AstroPerfTelemetryStatics::CsvHeader);
+	const FTCHARToUTF8 CsvPreambleUTF8(*CsvPreamble);
+	CsvWriter->Serialize(const_cast<ANSICHAR*>(CsvPreambleUTF8.Get()), CsvPreambleUTF8.Length());
+
+	CsvCaptureStartTime = FPlatformTime::Seconds();
+	if (TelemetryRequestCount == 0)
+	{
+		ResetHistory();
+	}
+
+	UE_LOG(LogAstroPerfTelemetry, Display, TEXT("[%hs] Started telemetry capture (%s)."), __FUNCTION__, *CaptureFilePath);
+}
+
+void UAstroPerfTelemetrySubsystem::StopCsvCapture()
+{
+	if (!CsvWriter)
+	{
+		return;
+	}
+
+	CsvWriter->Close();
+	CsvWriter.Reset();
+
+	const FAstroPerfFrameStats FrameStats = GetFrameStats();
+	UE_LOG(LogAstroPerfTelemetry, Display, TEXT("[%hs] Stopped telemetry capture. P50=%.2fms P95=%.2fms P99=%.2fms Hitches=%d"), __FUNCTION__,
+		FrameStats.P50FrameMs, FrameStats.P95FrameMs, FrameStats.P99FrameMs, FrameStats.TotalHitchCount);
+}
+
+FAstroPerfFrameStats UAstroPerfTelemetrySubsystem::GetFrameStats() const
+{
+	FAstroPerfFrameStats FrameStats;
+	FrameStats.SampleCount = FrameHistory.Num();
+	FrameStats.TotalHitchCount = TotalHitchCount;
+	FrameStats.PoolMisses = LastPoolMisses - InitialPoolMisses;
+	if (FrameHistory.IsEmpty())
+	{
+		return FrameStats;
+	}
+
+	SortedFrameTimesScratch.Reset(FrameHistory.Num());
+
+	int64 TotalMessageBroadcasts = 0;
+	int64 TotalTraceCalls = 0;
+	for (const FAstroPerfFrameSample& FrameSample : FrameHistory)
+	{
+		SortedFrameTimesScratch.Add(FrameSample.FrameMs);
+		FrameStats.AverageFrameMs += FrameSample.FrameMs;
+		FrameStats.AverageGameThreadMs += FrameSample.GameThreadMs;
+		FrameStats.AverageRenderThreadMs += FrameSample.RenderThreadMs;
+		FrameStats.RecentHitchCount += FrameSample.FrameMs > AstroPerfTelemetryVars::HitchThresholdMs ? 1 : 0;
+		TotalMessageBroadcasts += FrameSample.MessageBroadcasts;
+		TotalTraceCalls += FrameSample.TraceCalls;
+	}
+
+	const float SampleCount = static_cast<float>(FrameHistory.Num());
+	FrameStats.AverageFrameMs /= SampleCount;
+	FrameStats.AverageGameThreadMs /= SampleCount;
+	FrameStats.AverageRenderThreadMs /= SampleCount;
+	FrameStats.AverageMessageBroadcastsPerFrame = TotalMessageBroadcasts / SampleCount;
+	FrameStats.AverageTraceCallsPerFrame = TotalTraceCalls / SampleCount;
+
+	// Nearest-rank percentiles
+	SortedFrameTimesScratch.Sort();
+	auto GetPercentile = [this](const float Percentile)
+	{
+		const int32 PercentileIndex = FMath::Clamp(FMath::CeilToInt(Percentile * SortedFrameTimesScratch.Num()) - 1, 0, SortedFrameTimesScratch.Num() - 1);
+		return SortedFrameTimesScratch[PercentileIndex];
+	};
+	FrameStats.P50FrameMs = GetPercentile(0.50f);
+	FrameStats.P95FrameMs = GetPercentile(0.95f);
+	FrameStats.P99FrameMs = GetPercentile(0.99f);
+
+	if (const FAstroPerfFrameSample* LastFrameSample = GetLastFrameSample())
+	{
+		FrameStats.ActiveBalls = LastFrameSample->ActiveBalls;
+		FrameStats.Indicators = LastFrameSample->Indicators;
+	}
+
+	return FrameStats;
+}
+
+const FAstroPerfFrameSample* UAstroPerfTelemetrySubsystem::GetLastFrameSample() const
+{
+	if (FrameHistory.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	const int32 LastFrameHistoryIndex = (NextFrameHistoryIndex - 1 + FrameHistory.Num()) % FrameHistory.Num();
+	return &FrameHistory[LastFrameHistoryIndex];
+}
+
+void UAstroPerfTelemetrySubsystem::RecordFrame()
+{
+	// NOTE: The tick's DeltaTime is affected by time dilation, so we use the real frame time instead.
+	FAstroPerfFrameSample FrameSample;
+	FrameSample.FrameMs = static_cast<float>(FApp::GetDeltaTime() * 1000.0);
+	FrameSample.GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	FrameSample.RenderThreadMs = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+
+	// Gameplay counters
+	const UAstroBallPoolManager* BallPoolManager = UAstroBallPoolManager::Get(this);
+	const FAstroBallPoolStats BallPoolStats = BallPoolManager ? BallPoolManager->GetAllPoolsStats() : FAstroBallPoolStats();
+	const UAstroIndicatorWidgetManagerComponent* IndicatorWidgetManagerComponent = GetIndicatorWidgetManagerComponent();
+	const int64 MessageBroadcastCount = UGameplayMessageSubsystem::HasInstance(this) ? UGameplayMessageSubsystem::Get(this).GetTotalBroadcastCount() : 0;
+	const uint64 TraceCallCount = AstroPerfCounters::GetTotalTraceCalls();
+
+	if (!bHasCounterBaseline)
+	{
+		bHasCounterBaseline = true;
+		InitialPoolMisses = BallPoolStats.Misses;
+		LastPoolMisses = BallPoolStats.Misses;
+		LastMessageBroadcastCount = MessageBroadcastCount;
+		LastTraceCallCount = TraceCallCount;
+	}
+
+	FrameSample.ActiveBalls = BallPoolStats.ActiveBalls;
+	FrameSample.PoolMisses = BallPoolStats.Misses - LastPoolMisses;
+	FrameSample.Indicators = IndicatorWidgetManagerComponent ? IndicatorWidgetManagerComponent->GetIndicatorCount() : 0;
+	FrameSample.MessageBroadcasts = static_cast<int32>(MessageBroadcastCount - LastMessageBroadcastCount);
+	FrameSample.TraceCalls = static_cast<int32>(TraceCallCount - LastTraceCallCount);
+
+	LastPoolMisses = BallPoolStats.Misses;
+	LastMessageBroadcastCount = MessageBroadcastCount;
+	LastTraceCallCount = TraceCallCount;
+
+	if (FrameSample.FrameMs > AstroPerfTelemetryVars::HitchThresholdMs)
+	{
+		TotalHitchCount++;
+	}
+
+	// Writes the frame into the ring buffer
+	// The history starts over if its size was changed through the cvar
+	const int32 FrameHistorySize = FMath::Max(AstroPerfTelemetryVars::FrameHistorySize, 1);
+	if (FrameHistorySize != ActiveFrameHistorySize)
+	{
+		ResetHistory();
+	}
+
+	if (FrameHistory.Num() < FrameHistorySize)
+	{
+		FrameHistory.Add(FrameSample);
+		NextFrameHistoryIndex = FrameHistory.Num() % FrameHistorySize;
+	}
+	else
+	{
+		FrameHistory[NextFrameHistoryIndex] = FrameSample;
+		NextFrameHistoryIndex = (NextFrameHistoryIndex + 1) % FrameHistorySize;
+	}
+
+	if (CsvWriter)
+	{
+		WriteCsvFrame(FrameSample);
+	}
+}
+
+void UAstroPerfTelemetrySubsystem::WriteCsvFrame(const FAstroPerfFrameSample& FrameSample)
+{
+	const FString CsvLine = FString::Printf(TEXT("%.3f,%.3f,%.3f,%.3f,%d,%d,%d,%d,%d\n"),
+		FPlatformTime::Seconds() - CsvCaptureStartTime, FrameSample.FrameMs, FrameSample.GameThreadMs, FrameSample.RenderThreadMs,
+		FrameSample.ActiveBalls, FrameSample.PoolMisses, FrameSample.Indicators, FrameSample.MessageBroadcasts, FrameSample.TraceCalls);
+
+	// NOTE: The file writer is buffered, so this doesn't hit the disk every frame.
+	const FTCHARToUTF8 CsvLineUTF8(*CsvLine);
+	CsvWriter->Serialize(const_cast<ANSICHAR*>(CsvLineUTF8.Get()), CsvLineUTF8.Length());
+}
+
+void UAstroPerfTelemetrySubsystem::ResetHistory()
+{
+	ActiveFrameHistorySize = FMath::Max(AstroPerfTelemetryVars::FrameHistorySize, 1);
+	FrameHistory.Reset(ActiveFrameHistorySize);
+	NextFrameHistoryIndex = 0;
+	TotalHitchCount = 0;
+	bHasCounterBaseline = false;
+}
+
+UAstroIndicatorWidgetManagerComponent* UAstroPerfTelemetrySubsystem::GetIndicatorWidgetManagerComponent()
+{
+	if (!CachedIndicatorWidgetManagerComponent.IsValid())
+	{
+		const UWorld* World = GetWorld();
+		const AGameStateBase* GameState = World ? World->GetGameState() : nullptr;
+		CachedIndicatorWidgetManagerComponent = GameState ? GameState->GetComponentByClass<UAstroIndicatorWidgetManagerComponent>() : nullptr;
+	}
+
+	return CachedIndicatorWidgetManagerComponent.Get();
+}
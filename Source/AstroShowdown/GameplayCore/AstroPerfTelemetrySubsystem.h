@@ -0,0 +1,159 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "AstroPerfTelemetrySubsystem.generated.h"
+
+class UAstroIndicatorWidgetManagerComponent;
+
+/** Everything that is recorded for a single frame. */
+struct FAstroPerfFrameSample
+{
+	float FrameMs = 0.f;
+	float GameThreadMs = 0.f;
+	float RenderThreadMs = 0.f;
+	int32 ActiveBalls = 0;
+	int32 PoolMisses = 0;
+	int32 Indicators = 0;
+	int32 MessageBroadcasts = 0;
+	int32 TraceCalls = 0;
+};
+
+/** Summary of the frames currently in the telemetry history. */
+USTRUCT(BlueprintType)
+struct FAstroPerfFrameStats
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly)
+	int32 SampleCount = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	float AverageFrameMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float P50FrameMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float P95FrameMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float P99FrameMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float AverageGameThreadMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float AverageRenderThreadMs = 0.f;
+
+	/** Frames above the hitch threshold, within the history. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 RecentHitchCount = 0;
+
+	/** Frames above the hitch threshold, since telemetry started. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 TotalHitchCount = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 ActiveBalls = 0;
+
+	/** Pool misses since telemetry started. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 PoolMisses = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Indicators = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	float AverageMessageBroadcastsPerFrame = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float AverageTraceCallsPerFrame = 0.f;
+
+};
+
+/**
+* AstroPerfTelemetrySubsystem records frame times and gameplay counters into a ring buffer, and optionally streams them to a CSV file.
+* It only ticks while something requested telemetry (e.g., UAstroPerfDisplayWidget) or while a CSV capture is running, so it costs nothing otherwise.
+* NOTE: This doesn't depend on any UI, so CSV captures also work on headless soak runs (e.g., with -AstroPerfCsv).
+*/
+UCLASS()
+class ASTROSHOWDOWN_API UAstroPerfTelemetrySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+#pragma region UWorldSubsystem
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+#pragma endregion
+
+
+#pragma region FTickableGameObject
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+#pragma endregion
+
+
+#pragma region UAstroPerfTelemetrySubsystem
+public:
+	static UAstroPerfTelemetrySubsystem* Get(const UObject* WorldContextObject);
+
+	/** Starts recording frames. Every call should be matched by a call to ReleaseTelemetry. */
+	void RequestTelemetry();
+	void ReleaseTelemetry();
+
+	/** Starts streaming every recorded frame to a CSV file in the profiling directory. */
+	void StartCsvCapture(const FString& CaptureName);
+	void StopCsvCapture();
+	bool IsCsvCaptureRunning() const { return CsvWriter.IsValid(); }
+
+	/** Computes the stats of all frames in the history. This sorts the history, so it shouldn't be called every frame. */
+	UFUNCTION(BlueprintPure)
+	FAstroPerfFrameStats GetFrameStats() const;
+
+	/** @return The last recorded frame, or nullptr if there's none. */
+	const FAstroPerfFrameSample* GetLastFrameSample() const;
+
+private:
+	void RecordFrame();
+	void WriteCsvFrame(const FAstroPerfFrameSample& FrameSample);
+	void ResetHistory();
+	UAstroIndicatorWidgetManagerComponent* GetIndicatorWidgetManagerComponent();
+
+private:
+	/** Ring buffer with the most recent frames. */
+	TArray<FAstroPerfFrameSample> FrameHistory;
+	int32 NextFrameHistoryIndex = 0;
+	int32 ActiveFrameHistorySize = 0;
+
+	/** Reused by GetFrameStats to sort frame times without allocating. */
+	mutable TArray<float> SortedFrameTimesScratch;
+
+	int32 TotalHitchCount = 0;
+	int32 TelemetryRequestCount = 0;
+
+	/** Counter values on the last recorded frame, used to compute per-frame deltas. */
+	int32 LastPoolMisses = 0;
+	int32 InitialPoolMisses = 0;
+	int64 LastMessageBroadcastCount = 0;
+	uint64 LastTraceCallCount = 0;
+	uint8 bHasCounterBaseline : 1 = false;
+
+	TUniquePtr<FArchive> CsvWriter;
+	double CsvCaptureStartTime = 0.0;
+
+	TWeakObjectPtr<UAstroIndicatorWidgetManagerComponent> CachedIndicatorWidgetManagerComponent;
+#pragma endregion
+
+};
@@ -22,13 +22,78 @@
 #include "TimerManager.h"
 
 
+DECLARE_LOG_CATEGORY_EXTERN(LogAstroStateMachine, Log, All);
+DEFINE_LOG_CATEGORY(LogAstroStateMachine);
+
 void UAstroStateMachine::SwitchState(AAstroCharacter* InOwner, TSubclassOf<UAstroStateBase> NewStateClass)
 {
-	if (UAbilitySystemComponent* OwnerAbilitySystemComponent = InOwner->GetAbilitySystemComponent())
+	UAbilitySystemComponent* OwnerAbilitySystemComponent = InOwner ? InOwner->GetAbilitySystemComponent() : nullptr;
+	if (!OwnerAbilitySystemComponent || !NewStateClass)
+	{
+		return;
+	}
+
+	const double TransitionStartTime = FPlatformTime::Seconds();
+
+	const FGameplayAbilitySpecHandle StateAbilitySpecHandle = FindOrGrantState(OwnerAbilitySystemComponent, NewStateClass);
+
+	// NOTE: We don't need to cancel the current state here, as activating the new state cancels all abilities with the AstroState tag.
+	// This also re-enters the current state when NewStateClass is already active, as states are retriggerable.
+	if (!OwnerAbilitySystemComponent->TryActivateAbility(StateAbilitySpecHandle))
+	{
+		UE_LOG(LogAstroStateMachine, Warning, TEXT("::WARNING: (%s) Failed to activate state %s"), ANSI_TO_TCHAR(__FUNCTION__), *GetNameSafe(NewStateClass));
+		return;
+	}
+
+	RecordTransition(TransitionStartTime);
+}
+
+void UAstroStateMachine::ClearGrantedStates()
+{
+	if (UAbilitySystemComponent* AbilitySystemComponent = GrantedStatesAbilitySystemComponent.Get())
+	{
+		for (const TPair<TSubclassOf<UAstroStateBase>, FGameplayAbilitySpecHandle>& GrantedStateHandle : GrantedStateHandles)
+		{
+			AbilitySystemComponent->ClearAbility(GrantedStateHandle.Value);
+		}
+	}
+
+	GrantedStateHandles.Reset();
+	GrantedStatesAbilitySystemComponent = nullptr;
+}
+
+FGameplayAbilitySpecHandle UAstroStateMachine::FindOrGrantState(UAbilitySystemComponent* AbilitySystemComponent, TSubclassOf<UAstroStateBase> StateClass)
+{
+	// Specs granted to a previous ASC can't be activated by the new one
+	if (GrantedStatesAbilitySystemComponent.Get() != AbilitySystemComponent)
 	{
-		FGameplayAbilitySpec StateAbilitySpec { NewStateClass };
-		FGameplayAbilitySpecHandle StateAbilitySpecHandle = OwnerAbilitySystemComponent->GiveAbilityAndActivateOnce(StateAbilitySpec);
+		ClearGrantedStates();
+		GrantedStatesAbilitySystemComponent = AbilitySystemComponent;
 	}
+
+	// NOTE: The spec may have been removed by someone else (e.g., ClearAllAbilities), so we have to make sure it's still there
+	if (const FGameplayAbilitySpecHandle* GrantedStateHandle = GrantedStateHandles.Find(StateClass))
+	{
+		if (AbilitySystemComponent->FindAbilitySpecFromHandle(*GrantedStateHandle))
+		{
+			return *GrantedStateHandle;
+		}
+	}
+
+	const FGameplayAbilitySpecHandle StateAbilitySpecHandle = AbilitySystemComponent->GiveAbility(FGameplayAbilitySpec{ StateClass });
+	GrantedStateHandles.Add(StateClass, StateAbilitySpecHandle);
+	TransitionStats.GrantedStateCount++;
+	return StateAbilitySpecHandle;
+}
+
+void UAstroStateMachine::RecordTransition(const double TransitionStartTime)
+{
+	const float TransitionMs = static_cast<float>((FPlatformTime::Seconds() - TransitionStartTime) * 1000.0);
+
+	TransitionStats.TransitionCount++;
+	TransitionStats.LastTransitionMs = TransitionMs;
+	TransitionStats.MaxTransitionMs = FMath::Max(TransitionStats.MaxTransitionMs, TransitionMs);
+	TransitionStats.AverageTransitionMs += (TransitionMs - TransitionStats.AverageTransitionMs) / TransitionStats.TransitionCount;
 }
 
 
@@ -42,6 +107,11 @@ UAstroStateBase::UAstroStateBase(const FObjectInitializer& ObjectInitializer) :
 	const FGameplayTag& AstroStateGameplayTag = AstroGameplayTags::AstroState;
 	AbilityTags.AddTag(AstroStateGameplayTag);
 	CancelAbilitiesWithTag.AddTag(AstroStateGameplayTag);
+
+	// States are granted once and re-activated on every transition (see UAstroStateMachine), so they must keep a single instance per actor.
+	// Retriggering allows re-entering the current state, which ends and re-activates it, just like granting a new spec would.
+	InstancingPolicy = EGameplayAbilityInstancingPolicy::InstancedPerActor;
+	bRetriggerInstancedAbility = true;
 }
 
 void UAstroStateBase::ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData)
@@ -291,6 +361,9 @@ void UAstroState_Focus::EnterState_Implementation(AAstroCharacter* InOwner)
 
 	GrantInputs();
 
+	// NOTE: The state is reused across focus activations, so stamina spent below the threshold in a previous focus must not carry over
+	AccumulatedSpentStamina = 0.f;
+
 	// AstroCharacter should ignore time dilation, effectively making it 'immune' to bullet time.
 	if (UAstroTimeDilationSubsystem* TimeDilationSubsystem = SubsystemUtils::GetWorldSubsystem<UAstroTimeDilationSubsystem>(this))
 	{
@@ -9,13 +9,43 @@
 #pragma once
 
 #include "Abilities/GameplayAbility.h"
+#include "GameplayAbilitySpecHandle.h"
 #include "GameplayTagContainer.h"
 #include "AstroStateMachine.generated.h"
 
+class UAbilitySystemComponent;
 class UAstroStateBase;
 class AAstroCharacter;
 
-/** Manages the state machine for the player. */
+USTRUCT(BlueprintType)
+struct FAstroStateTransitionStats
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly)
+	int32 TransitionCount = 0;
+
+	/** How many state classes had to be granted to the ASC. This should stop growing once every state has been visited once. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 GrantedStateCount = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	float LastTransitionMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float AverageTransitionMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float MaxTransitionMs = 0.f;
+
+};
+
+/**
+* Manages the state machine for the player.
+* Each state class is granted to the owner's ASC only once, the first time it's entered. After that, transitions just re-activate the persistent spec,
+* and the previous state is cancelled through the AstroState tag (see UAstroStateBase), so switching states doesn't allocate new specs or instances.
+*/
 UCLASS()
 class ASTROSHOWDOWN_API UAstroStateMachine final : public UObject
 {
@@ -24,6 +54,25 @@ class ASTROSHOWDOWN_API UAstroStateMachine final : public UObject
 public:
 	void SwitchState(AAstroCharacter* InOwner, TSubclassOf<UAstroStateBase> NewState);
 
+	/** Removes all granted states from the ASC. Should be called when the owner stops using the ASC (e.g., on EndPlay). */
+	void ClearGrantedStates();
+
+	const FAstroStateTransitionStats& GetTransitionStats() const { return TransitionStats; }
+
+private:
+	/** Returns the handle of the spec granted for the given state class, granting it if needed. */
+	FGameplayAbilitySpecHandle FindOrGrantState(UAbilitySystemComponent* AbilitySystemComponent, TSubclassOf<UAstroStateBase> StateClass);
+
+	void RecordTransition(const double TransitionStartTime);
+
+private:
+	/** ASC that owns the granted specs. If the owner switches to a different ASC, the granted specs are discarded. */
+	TWeakObjectPtr<UAbilitySystemComponent> GrantedStatesAbilitySystemComponent = nullptr;
+
+	TMap<TSubclassOf<UAstroStateBase>, FGameplayAbilitySpecHandle> GrantedStateHandles;
+
+	FAstroStateTransitionStats TransitionStats;
+
 };
 
 /** Base abstract class for states in the player's state machine. */
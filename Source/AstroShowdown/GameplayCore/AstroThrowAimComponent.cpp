@@ -147,8 +147,8 @@ void UAstroThrowAimComponent::UpdateAim()
 	}
 	else
 	{
-		FVector OutMouseWorldPosition, OutMouseWorldDirection;
-		CachedOwnerController->DeprojectMousePositionToWorld(OutMouseWorldPosition, OutMouseWorldDirection);
+		FVector OutMouseWorldPosition = FVector::ZeroVector, OutMouseWorldDirection = FVector::ZeroVector;
+		CachedOwnerController->GetCachedCursorRay(OutMouseWorldPosition, OutMouseWorldDirection);
 
 		// NOTE: For whatever reason, DeprojectMousePositionToWorld doesn't actually return the mouse's world position,
 		// so we need to project it to the character's plane
@@ -168,13 +168,11 @@ void UAstroThrowAimComponent::UpdateAim()
 
 	if (AAstroBall* CurrentBallPickup = CachedOwnerCharacter.IsValid() ? CachedOwnerCharacter->GetBallPickup() : nullptr)
 	{
-		// Simulates the ball's trajectory
-		TArray<FHitResult> BallHits;
-		SimulateBallTrajectory(CurrentThrowTarget.Location, CurrentBallPickup, /*OUT*/ BallHits);
+		// Simulates the ball's trajectory straight into CurrentAimResult, so that its bounce buffer is reused between frames
+		SimulateBallTrajectory(CurrentThrowTarget.Location, CurrentBallPickup, /*OUT*/ CurrentAimResult.TrajectoryHits);
 
 		// Updates CurrentAimResult with the current target
 		CurrentAimResult.TargetHitResult = CurrentThrowTarget;
-		CurrentAimResult.TrajectoryHits = BallHits;
 
 		const FVector BallStartPosition = CachedOwnerCharacter.IsValid() ? CachedOwnerCharacter->GetActorLocation() : CurrentThrowTarget.Location;
 		AstroThrowAimUtils::Private::CalculateThrowDirection(BallStartPosition, CurrentThrowTarget.Location, CurrentAimResult.CachedThrowDirection);
@@ -189,7 +187,7 @@ FHitResult UAstroThrowAimComponent::FindThrowTarget()
 	{
 		FHitResult CursorTraceHit;
 		constexpr bool bTraceComplex = false;
-		if (const bool bFoundHit = CachedOwnerController->GetHitResultUnderCursorByChannel(ThrowAimTargetChannel, bTraceComplex, CursorTraceHit))
+		if (const bool bFoundHit = CachedOwnerController->GetCachedHitResultUnderCursorByChannel(ThrowAimTargetChannel, bTraceComplex, CursorTraceHit))
 		{
 			return CursorTraceHit;
 		}
@@ -204,10 +202,7 @@ void UAstroThrowAimComponent::SimulateBallTrajectory(const FVector& TargetPositi
 	const FVector BallStartPosition = AstroThrowAimUtils::Private::GetActorCenterOfMassLocation(CachedOwnerCharacter.Get());
 	AstroThrowAimUtils::Private::CalculateThrowDirection(BallStartPosition, TargetPosition, OUT DeflectionDirection);
 
-	if (Ball)
-	{
-		Ball->SimulateTrajectory(BallStartPosition, DeflectionDirection, Hits);
-	}
+	TrajectorySolver.Solve(Ball, BallStartPosition, DeflectionDirection, OUT Hits);
 }
 
 TObjectPtr<UNiagaraComponent> UAstroThrowAimComponent::GetOrCreateThrowAimPointer(int32 AimPointerIndex)
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "AstroBallTrajectorySolver.h"
 #include "Components/ActorComponent.h"
 #include "Engine/HitResult.h"
 #include "AstroThrowAimComponent.generated.h"
@@ -111,4 +112,7 @@ private:
 	UPROPERTY(Transient)
 	TObjectPtr<UAstroThrowAimProvider> ThrowAimProvider = nullptr;
 
+	/** Owned per component, so that trajectory queries and bounce buffers are reused every aim frame. */
+	FAstroBallTrajectorySolver TrajectorySolver;
+
 };
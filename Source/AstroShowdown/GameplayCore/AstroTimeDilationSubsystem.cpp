@@ -9,9 +9,11 @@
 #include "AstroTimeDilationSubsystem.h"
 #include "AstroBall.h"
 #include "Engine/Engine.h"
+#include "Engine/World.h"
 #include "Kismet/KismetMaterialLibrary.h"
 #include "Kismet/GameplayStatics.h"
 #include "Materials/MaterialParameterCollection.h"
+#include "Misc/App.h"
 #include "NiagaraComponent.h"
 
 namespace AstroTimeDilationSubsystemVars
@@ -29,8 +31,36 @@ namespace AstroTimeDilationSubsystemVars
 		TimeDilationIncrementStep,
 		TEXT("Determines the increment step for time dilation changes."),
 		ECVF_Default);
+
+	static int32 MinIgnoreRegistryCompactionSize = 32;
+	static FAutoConsoleVariableRef CVarMinIgnoreRegistryCompactionSize(
+		TEXT("AstroTimeDilation.MinIgnoreRegistryCompactionSize"),
+		MinIgnoreRegistryCompactionSize,
+		TEXT("Ignore registries smaller than this are only compacted when the global time dilation changes."),
+		ECVF_Default);
+
+	static float MaxAbsoluteTimerDeltaSeconds = 1.f / 30.f;
+	static FAutoConsoleVariableRef CVarMaxAbsoluteTimerDeltaSeconds(
+		TEXT("AstroTimeDilation.MaxAbsoluteTimerDeltaSeconds"),
+		MaxAbsoluteTimerDeltaSeconds,
+		TEXT("Clamps how much absolute timers set with bClampFrameDelta advance in a single frame, so that hitches and unpausing don't fire them early."),
+		ECVF_Default);
+
+	static FAutoConsoleCommandWithWorld CVarDumpAbsoluteTimers(
+		TEXT("AstroTimeDilation.DumpAbsoluteTimers"),
+		TEXT("Logs all pending absolute (real-time) timers."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UAstroTimeDilationSubsystem* TimeDilationSubsystem = World ? World->GetSubsystem<UAstroTimeDilationSubsystem>() : nullptr)
+			{
+				TimeDilationSubsystem->DumpAbsoluteTimers();
+			}
+		}));
 }
 
+DECLARE_LOG_CATEGORY_EXTERN(LogAstroTimeDilation, Log, All);
+DEFINE_LOG_CATEGORY(LogAstroTimeDilation);
+
 namespace AstroStatics
 {
 	static const FName RealTimeMaterialParameterName = "RealTimeSeconds";
@@ -45,19 +75,29 @@ void UAstroTimeDilationSubsystem::Initialize(FSubsystemCollectionBase& Collectio
 	{
 		RealTimeMPC = TimeDilationSettings->RealTimeMPC.LoadSynchronous();
 	}
+
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &ThisClass::OnWorldTickStart);
 }
 
+void UAstroTimeDilationSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	WorldTickStartHandle.Reset();
+
+	Super::Deinitialize();
+}
 
-// UAstroTimeDilationSubsystem is implemented as an FTickableGameObject, so its tick comes after physics and TimerManager.
-// All time dilation changes are polled in this subsystem's tick, so they're not instant, and other ticks may take place
-// with old time dilation values, causing inconsistent behavior.
+
+// Time dilation changes are applied at the very start of the world tick, before the world scales its DeltaSeconds by the
+// global time dilation. This way, every tick group (including physics, whose DeltaTime is set up during TG_StartPhysics in
+// FChaosScene::SetUpForFrame), the real time MPC and the objects that ignore time dilation all see the same value in a single frame.
 // 
-// One prime example of this is physics simulation. Physics tick DeltaTime is calculated during TG_PrePhysics (check FChaosScene
-// ::SetUpForFrame), and iirc physics ticking happens on a separate thread, so there's no one-to-one relation between GT and PT ticks.
-// This implies that time dilation changes may not be picked accurately by the PT.
+// NOTE: A TG_PrePhysics tick function would be too late for this, since the world's DeltaSeconds is already dilated by then.
 // 
 // Tick order goes: (source = https://dev.epicgames.com/community/learning/tutorials/D7P8/unreal-engine-advanced-tick-functionality-tickables-multi-tick)
 // ==============================================
+// FWorldDelegates::OnWorldTickStart.Broadcast(...);									<< OnWorldTickStart is here!!!!
+// DeltaSeconds *= Info->GetEffectiveTimeDilation();
 // RunTickGroup(TG_PrePhysics);
 // RunTickGroup(TG_StartPhysics);
 // RunTickGroup(TG_DuringPhysics);
@@ -66,18 +106,52 @@ void UAstroTimeDilationSubsystem::Initialize(FSubsystemCollectionBase& Collectio
 // > tick timers (delays, latent actions...)
 // GetTimerManager().Tick(DeltaSeconds);
 // > tick tickables that inherit from FTickableGameObject
-// FTickableGameObject::TickObjects(this, TickType, bIsPaused, DeltaSeconds);			<< We're here!!!!
+// FTickableGameObject::TickObjects(this, TickType, bIsPaused, DeltaSeconds);			<< Tick is here!!!!
 // RunTickGroup(TG_PostUpdateWork);
 // RunTickGroup(TG_LastDemotable);
 // ==============================================
 // 
+void UAstroTimeDilationSubsystem::OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	UWorld* World = GetWorld();
+	if (InWorld != World || !World || World->IsPaused())
+	{
+		return;
+	}
+
+	// NOTE: The world only adds DeltaSeconds to its real time after this, so we add it ourselves
+	PreviousRealTimeSeconds = CurrentRealTimeSeconds;
+	CurrentRealTimeSeconds = World->GetRealTimeSeconds() + DeltaSeconds;
+
+	ApplyPendingTimeDilation();
+}
+
 void UAstroTimeDilationSubsystem::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	PreviousRealTimeSeconds = CurrentRealTimeSeconds;
-	CurrentRealTimeSeconds = GetWorld()->GetRealTimeSeconds();
+	// NOTE: FApp's delta time is the real frame time, so these clocks aren't affected by time dilation
+	const double RealDeltaSeconds = FApp::GetDeltaTime();
+	AbsoluteTimerClockSeconds += RealDeltaSeconds;
+	ClampedAbsoluteTimerClockSeconds += FMath::Min(RealDeltaSeconds, static_cast<double>(AstroTimeDilationSubsystemVars::MaxAbsoluteTimerDeltaSeconds));
+	TickAbsoluteTimers(AbsoluteTimerHeap, AbsoluteTimerClockSeconds);
+	TickAbsoluteTimers(ClampedAbsoluteTimerHeap, ClampedAbsoluteTimerClockSeconds);
 
+	// Ignore calls made during this frame can't wait for the next world tick, otherwise these objects would tick with the wrong dilation
+	if (bAreTimeDilationIgnoredActorsDirty)
+	{
+		UpdateIgnoredObjectsTimeDilation();
+		bAreTimeDilationIgnoredActorsDirty = false;
+	}
+}
+
+TStatId UAstroTimeDilationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAstroTimeDilationSubsystem, STATGROUP_Tickables);
+}
+
+void UAstroTimeDilationSubsystem::ApplyPendingTimeDilation()
+{
 	const UWorld* World = GetWorld();
 	FPhysScene* PhysScene = World ? World->GetPhysicsScene() : nullptr;
 	if (!World || !PhysScene)
@@ -114,11 +188,15 @@ void UAstroTimeDilationSubsystem::Tick(float DeltaTime)
 		}
 
 		UGameplayStatics::SetGlobalTimeDilation(this, NewGlobalTimeDilation);
+	}
 
+	// NOTE: This also picks up time dilation changes that didn't go through this subsystem
+	if (UGameplayStatics::GetGlobalTimeDilation(this) != LastPushedGlobalTimeDilation)
+	{
 		bAreTimeDilationIgnoredActorsDirty = true;
 	}
 
-	// NOTE: We're delaying this to the end of the frame to prevent sudden animation/movement/etc {over/under}ticks
+	// NOTE: Ignored objects are updated along with the global time dilation, so they never tick a frame with a mismatched value
 	if (bAreTimeDilationIgnoredActorsDirty)
 	{
 		UpdateIgnoredObjectsTimeDilation();
@@ -126,93 +204,235 @@ void UAstroTimeDilationSubsystem::Tick(float DeltaTime)
 	}
 }
 
-TStatId UAstroTimeDilationSubsystem::GetStatId() const
+void UAstroTimeDilationSubsystem::SetAbsoluteTimer(FAstroRealTimeTimerHandle& TimerHandle, const FTimerDelegate& TimerDelegate, float Duration, const bool bLoop, const bool bClampFrameDelta)
 {
-	RETURN_QUICK_DECLARE_CYCLE_STAT(UAstroTimeDilationSubsystem, STATGROUP_Tickables);
+	ClearAbsoluteTimer(TimerHandle);
+
+	if (!TimerDelegate.IsBound())
+	{
+		return;
+	}
+
+	// NOTE: Looping timers need a positive duration, otherwise they would fire forever within a single tick
+	ensureMsgf(!bLoop || Duration > 0.f, TEXT("Looping absolute timers need a positive duration"));
+
+	FAbsoluteTimer& AbsoluteTimer = AbsoluteTimers.Add(++LastAbsoluteTimerId);
+	AbsoluteTimer.TimerDelegate = TimerDelegate;
+	AbsoluteTimer.Duration = FMath::Max(Duration, 0.f);
+	AbsoluteTimer.FireTime = GetAbsoluteTimerClockSeconds(bClampFrameDelta) + AbsoluteTimer.Duration;
+	AbsoluteTimer.bLoop = bLoop && Duration > 0.f;
+	AbsoluteTimer.bClampFrameDelta = bClampFrameDelta;
+	GetAbsoluteTimerHeap(bClampFrameDelta).HeapPush({ AbsoluteTimer.FireTime, LastAbsoluteTimerId });
+
+	TimerHandle.TimerId = LastAbsoluteTimerId;
 }
 
-namespace AstroTimeDilationSubsystemUtils
+void UAstroTimeDilationSubsystem::ClearAbsoluteTimer(FAstroRealTimeTimerHandle& TimerHandle)
 {
-	namespace Private
+	if (TimerHandle.IsValid())
 	{
-		void ExecuteRealTimeTicker(TWeakObjectPtr<UAstroTimeDilationSubsystem> TimeDilationSubsystem, FTimerHandle& TimerHandle, const FTimerDelegate& TimerDelegate, float Duration, float CurrentCounter)
+		AbsoluteTimers.Remove(TimerHandle.TimerId);
+		TimerHandle.Invalidate();
+	}
+
+	// Stale heap entries are skipped when popped, but we don't want them to pile up if timers are constantly cleared before firing
+	if (AbsoluteTimerHeap.Num() + ClampedAbsoluteTimerHeap.Num() > 2 * AbsoluteTimers.Num() + 16)
+	{
+		for (TArray<FAbsoluteTimerHeapEntry>* Heap : { &AbsoluteTimerHeap, &ClampedAbsoluteTimerHeap })
 		{
-			if (!TimeDilationSubsystem.IsValid())
+			Heap->RemoveAllSwap([this](const FAbsoluteTimerHeapEntry& HeapEntry)
 			{
-				return;
-			}
+				const FAbsoluteTimer* AbsoluteTimer = AbsoluteTimers.Find(HeapEntry.TimerId);
+				return !AbsoluteTimer || AbsoluteTimer->FireTime != HeapEntry.FireTime;
+			});
+			Heap->Heapify();
+		}
+	}
+}
 
-			CurrentCounter += TimeDilationSubsystem->GetRealTimeDeltaSeconds();
-			if (CurrentCounter >= Duration)
-			{
-				TimerDelegate.ExecuteIfBound();
-			}
-			else
-			{
-				UWorld* World = TimeDilationSubsystem->GetWorld();
-				TimerHandle = World->GetTimerManager().SetTimerForNextTick([&TimerHandle, TimeDilationSubsystem, TimerDelegate, Duration, CurrentCounter]()
-				{
-					ExecuteRealTimeTicker(TimeDilationSubsystem, TimerHandle, TimerDelegate, Duration, CurrentCounter);
-				});
-			}
+bool UAstroTimeDilationSubsystem::IsAbsoluteTimerActive(const FAstroRealTimeTimerHandle& TimerHandle) const
+{
+	return TimerHandle.IsValid() && AbsoluteTimers.Contains(TimerHandle.TimerId);
+}
+
+float UAstroTimeDilationSubsystem::GetAbsoluteTimerRemaining(const FAstroRealTimeTimerHandle& TimerHandle) const
+{
+	const FAbsoluteTimer* AbsoluteTimer = TimerHandle.IsValid() ? AbsoluteTimers.Find(TimerHandle.TimerId) : nullptr;
+	return AbsoluteTimer ? FMath::Max(AbsoluteTimer->FireTime - GetAbsoluteTimerClockSeconds(AbsoluteTimer->bClampFrameDelta), 0.0) : -1.f;
+}
+
+void UAstroTimeDilationSubsystem::DumpAbsoluteTimers() const
+{
+	UE_LOG(LogAstroTimeDilation, Log, TEXT("[%hs] %d pending absolute timers (%d heap entries)"), __FUNCTION__, AbsoluteTimers.Num(), AbsoluteTimerHeap.Num() + ClampedAbsoluteTimerHeap.Num());
+
+	// NOTE: Sorted by remaining time, as clamped timers use a different clock
+	TArray<TPair<double, uint64>> SortedTimers;
+	SortedTimers.Reserve(AbsoluteTimers.Num());
+	for (const TPair<uint64, FAbsoluteTimer>& AbsoluteTimer : AbsoluteTimers)
+	{
+		SortedTimers.Emplace(AbsoluteTimer.Value.FireTime - GetAbsoluteTimerClockSeconds(AbsoluteTimer.Value.bClampFrameDelta), AbsoluteTimer.Key);
+	}
+	SortedTimers.Sort();
+
+	for (const TPair<double, uint64>& SortedTimer : SortedTimers)
+	{
+		const FAbsoluteTimer& AbsoluteTimer = AbsoluteTimers.FindChecked(SortedTimer.Value);
+		UE_LOG(LogAstroTimeDilation, Log, TEXT("[%hs]     Id=%llu Remaining=%.3fs Duration=%.3fs Loop=%d ClampFrameDelta=%d Object=%s"), __FUNCTION__,
+			SortedTimer.Value, SortedTimer.Key, AbsoluteTimer.Duration, AbsoluteTimer.bLoop, AbsoluteTimer.bClampFrameDelta, *GetNameSafe(AbsoluteTimer.TimerDelegate.GetUObject()));
+	}
+}
+
+void UAstroTimeDilationSubsystem::TickAbsoluteTimers(TArray<FAbsoluteTimerHeapEntry>& Heap, const double ClockSeconds)
+{
+	while (!Heap.IsEmpty() && Heap.HeapTop().FireTime <= ClockSeconds)
+	{
+		FAbsoluteTimerHeapEntry HeapEntry;
+		Heap.HeapPop(HeapEntry, EAllowShrinking::No);
+
+		// Skips timers that were cleared or replaced after this entry was pushed
+		FAbsoluteTimer* AbsoluteTimer = AbsoluteTimers.Find(HeapEntry.TimerId);
+		if (!AbsoluteTimer || AbsoluteTimer->FireTime != HeapEntry.FireTime)
+		{
+			continue;
 		}
 
-		void StopRealTimeTicker(FTimerHandle& TimerHandle, UWorld* World)
+		// NOTE: The delegate is copied because it may set or clear timers, which invalidates AbsoluteTimer
+		const FTimerDelegate TimerDelegate = AbsoluteTimer->TimerDelegate;
+		if (AbsoluteTimer->bLoop)
 		{
-			if (World)
-			{
-				World->GetTimerManager().ClearTimer(TimerHandle);
-			}
+			AbsoluteTimer->FireTime += AbsoluteTimer->Duration;
+			Heap.HeapPush({ AbsoluteTimer->FireTime, HeapEntry.TimerId });
+		}
+		else
+		{
+			AbsoluteTimers.Remove(HeapEntry.TimerId);
 		}
+
+		TimerDelegate.ExecuteIfBound();
 	}
 }
 
-void UAstroTimeDilationSubsystem::SetAbsoluteTimer(FTimerHandle& TimerHandle, const FTimerDelegate& TimerDelegate, float Duration)
+double UAstroTimeDilationSubsystem::GetAbsoluteTimerClockSeconds(const bool bClampFrameDelta) const
 {
-	UWorld* World = GetWorld();
-	AstroTimeDilationSubsystemUtils::Private::ExecuteRealTimeTicker(this, TimerHandle, TimerDelegate, Duration, 0.f);
+	return bClampFrameDelta ? ClampedAbsoluteTimerClockSeconds : AbsoluteTimerClockSeconds;
 }
 
-void UAstroTimeDilationSubsystem::ClearAbsoluteTimer(FTimerHandle& TimerHandle)
+TArray<UAstroTimeDilationSubsystem::FAbsoluteTimerHeapEntry>& UAstroTimeDilationSubsystem::GetAbsoluteTimerHeap(const bool bClampFrameDelta)
 {
-	UWorld* World = GetWorld();
-	AstroTimeDilationSubsystemUtils::Private::StopRealTimeTicker(TimerHandle, World);
+	return bClampFrameDelta ? ClampedAbsoluteTimerHeap : AbsoluteTimerHeap;
 }
 
-void UAstroTimeDilationSubsystem::RegisterIgnoreTimeDilation(AActor* Actor)
+FAstroTimeDilationIgnoreHandle UAstroTimeDilationSubsystem::RegisterIgnoreTimeDilation(AActor* Actor)
+{
+	return RegisterIgnoreTimeDilationImpl(IgnoreTimeDilationActors, Actor);
+}
+
+void UAstroTimeDilationSubsystem::UnregisterIgnoreTimeDilation(AActor* Actor)
 {
-	if (Actor && !IgnoreTimeDilationActors.Contains(Actor))
+	if (const int32* HandleId = Actor ? IgnoreTimeDilationActors.HandlesByObject.Find(Actor) : nullptr)
 	{
-		IgnoreTimeDilationActors.Add(Actor);
-		DispatchUpdateIgnoredObjectsTimeDilation();
+		UnregisterIgnoreTimeDilationImpl(IgnoreTimeDilationActors, *HandleId);
 	}
 }
 
-void UAstroTimeDilationSubsystem::UnregisterIgnoreTimeDilation(AActor* Actor)
+FAstroTimeDilationIgnoreHandle UAstroTimeDilationSubsystem::RegisterIgnoreTimeDilationParticle(UNiagaraComponent* ParticleComponent)
+{
+	return RegisterIgnoreTimeDilationImpl(IgnoreTimeDilationParticles, ParticleComponent);
+}
+
+void UAstroTimeDilationSubsystem::UnregisterIgnoreTimeDilationParticle(UNiagaraComponent* ParticleComponent)
 {
-	if (Actor && IgnoreTimeDilationActors.Contains(Actor) && !RemovedIgnoreTimeDilationActors.Contains(Actor))
+	if (const int32* HandleId = ParticleComponent ? IgnoreTimeDilationParticles.HandlesByObject.Find(ParticleComponent) : nullptr)
 	{
-		RemovedIgnoreTimeDilationActors.Add(Actor);
-		DispatchUpdateIgnoredObjectsTimeDilation();
+		UnregisterIgnoreTimeDilationImpl(IgnoreTimeDilationParticles, *HandleId);
 	}
 }
 
-void UAstroTimeDilationSubsystem::RegisterIgnoreTimeDilationParticle(UNiagaraComponent* ParticleComponent)
+void UAstroTimeDilationSubsystem::UnregisterIgnoreTimeDilationByHandle(FAstroTimeDilationIgnoreHandle& Handle)
 {
-	if (ParticleComponent && !IgnoreTimeDilationParticles.Contains(ParticleComponent))
+	if (!Handle.IsValid())
 	{
-		IgnoreTimeDilationParticles.Add(ParticleComponent);
-		DispatchUpdateIgnoredObjectsTimeDilation();
+		return;
 	}
+
+	// NOTE: Handle ids are shared between registries, so only one of these will succeed
+	if (!UnregisterIgnoreTimeDilationImpl(IgnoreTimeDilationActors, Handle.HandleId))
+	{
+		UnregisterIgnoreTimeDilationImpl(IgnoreTimeDilationParticles, Handle.HandleId);
+	}
+
+	Handle.Invalidate();
 }
 
-void UAstroTimeDilationSubsystem::UnregisterIgnoreTimeDilationParticle(UNiagaraComponent* ParticleComponent)
+template <typename T>
+FAstroTimeDilationIgnoreHandle UAstroTimeDilationSubsystem::RegisterIgnoreTimeDilationImpl(TAstroTimeDilationIgnoreRegistry<T>& Registry, T* Object)
+{
+	FAstroTimeDilationIgnoreHandle Handle;
+	if (!Object)
+	{
+		return Handle;
+	}
+
+	if (const int32* ExistingHandleId = Registry.HandlesByObject.Find(Object))
+	{
+		Handle.HandleId = *ExistingHandleId;
+		return Handle;
+	}
+
+	Handle.HandleId = ++LastIgnoreHandleId;
+	Registry.ObjectsByHandle.Add(Handle.HandleId, Object);
+	Registry.HandlesByObject.Add(Object, Handle.HandleId);
+	Registry.PendingAddedHandles.Add(Handle.HandleId);
+
+	// Objects that are unregistered and registered again within the same frame shouldn't have their custom time dilation reset
+	Registry.PendingRemovedObjects.RemoveSwap(Object);
+
+	DispatchUpdateIgnoredObjectsTimeDilation();
+	return Handle;
+}
+
+template <typename T>
+bool UAstroTimeDilationSubsystem::UnregisterIgnoreTimeDilationImpl(TAstroTimeDilationIgnoreRegistry<T>& Registry, const int32 HandleId)
 {
-	if (ParticleComponent && IgnoreTimeDilationParticles.Contains(ParticleComponent) && !RemovedIgnoreTimeDilationParticles.Contains(ParticleComponent))
+	TWeakObjectPtr<T> RemovedObject;
+	if (!Registry.ObjectsByHandle.RemoveAndCopyValue(HandleId, RemovedObject))
+	{
+		return false;
+	}
+
+	Registry.PendingAddedHandles.Remove(HandleId);
+	if (T* RemovedObjectPtr = RemovedObject.Get())
 	{
-		RemovedIgnoreTimeDilationParticles.Add(ParticleComponent);
+		Registry.HandlesByObject.Remove(RemovedObjectPtr);
+		Registry.PendingRemovedObjects.Add(RemovedObject);
 		DispatchUpdateIgnoredObjectsTimeDilation();
 	}
+
+	return true;
+}
+
+template <typename T>
+void UAstroTimeDilationSubsystem::CompactIgnoreRegistry(TAstroTimeDilationIgnoreRegistry<T>& Registry)
+{
+	for (auto It = Registry.ObjectsByHandle.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsValid())
+		{
+			Registry.PendingAddedHandles.Remove(It.Key());
+			It.RemoveCurrent();
+		}
+	}
+
+	// NOTE: Object keys of destroyed objects can't be resolved anymore, so we look for handles that are gone instead
+	for (auto It = Registry.HandlesByObject.CreateIterator(); It; ++It)
+	{
+		if (!Registry.ObjectsByHandle.Contains(It.Value()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	Registry.CompactedNum = Registry.ObjectsByHandle.Num();
 }
 
 void UAstroTimeDilationSubsystem::SetGlobalTimeDilation(float TimeDilation, const bool bSmooth, const float CustomTimeDilationIncrementStep)
@@ -263,7 +483,7 @@ float UAstroTimeDilationSubsystem::GetGlobalTimeDilationInverse(UObject* WorldCo
 template <typename T>
 struct FIgnoreTimeDilationImpl
 {
-	static void Ignore(T*)
+	static void Ignore(T*, const float)
 	{
 		check(false);
 	}
@@ -277,11 +497,11 @@ struct FIgnoreTimeDilationImpl
 template <>
 struct FIgnoreTimeDilationImpl<AActor>
 {
-	static void Ignore(AActor* Actor)
+	static void Ignore(AActor* Actor, const float GlobalTimeDilationInverse)
 	{
 		if (Actor)
 		{
-			Actor->CustomTimeDilation = UAstroTimeDilationSubsystem::GetGlobalTimeDilationInverse(Actor);
+			Actor->CustomTimeDilation = GlobalTimeDilationInverse;
 		}
 	}
 
@@ -297,11 +517,11 @@ struct FIgnoreTimeDilationImpl<AActor>
 template <>
 struct FIgnoreTimeDilationImpl<UNiagaraComponent>
 {
-	static void Ignore(UNiagaraComponent* ParticleComponent)
+	static void Ignore(UNiagaraComponent* ParticleComponent, const float GlobalTimeDilationInverse)
 	{
 		if (ParticleComponent)
 		{
-			ParticleComponent->SetCustomTimeDilation(UAstroTimeDilationSubsystem::GetGlobalTimeDilationInverse(ParticleComponent));
+			ParticleComponent->SetCustomTimeDilation(GlobalTimeDilationInverse);
 		}
 	}
 
@@ -316,34 +536,55 @@ struct FIgnoreTimeDilationImpl<UNiagaraComponent>
 
 void UAstroTimeDilationSubsystem::UpdateIgnoredObjectsTimeDilation()
 {
-	UpdateIgnoredObjectsTimeDilationImpl(IgnoreTimeDilationActors, RemovedIgnoreTimeDilationActors);
-	UpdateIgnoredObjectsTimeDilationImpl(IgnoreTimeDilationParticles, RemovedIgnoreTimeDilationParticles);
+	const float GlobalTimeDilation = UGameplayStatics::GetGlobalTimeDilation(this);
+	const bool bGlobalTimeDilationChanged = GlobalTimeDilation != LastPushedGlobalTimeDilation;
+	if (!bGlobalTimeDilationChanged && !IgnoreTimeDilationActors.IsDirty() && !IgnoreTimeDilationParticles.IsDirty())
+	{
+		return;
+	}
+
+	const float GlobalTimeDilationInverse = 1.f / GlobalTimeDilation;
+	UpdateIgnoredObjectsTimeDilationImpl(IgnoreTimeDilationActors, GlobalTimeDilationInverse, bGlobalTimeDilationChanged);
+	UpdateIgnoredObjectsTimeDilationImpl(IgnoreTimeDilationParticles, GlobalTimeDilationInverse, bGlobalTimeDilationChanged);
+	LastPushedGlobalTimeDilation = GlobalTimeDilation;
 }
 
 template <typename T>
-void UAstroTimeDilationSubsystem::UpdateIgnoredObjectsTimeDilationImpl(TArray<TWeakObjectPtr<T>>& IgnoreTimeDilationObjects, TArray<TWeakObjectPtr<T>>& RemovedIgnoreTimeDilationObjects)
+void UAstroTimeDilationSubsystem::UpdateIgnoredObjectsTimeDilationImpl(TAstroTimeDilationIgnoreRegistry<T>& Registry, const float GlobalTimeDilationInverse, const bool bGlobalTimeDilationChanged)
 {
-	for (const TWeakObjectPtr<T>& RemovedIgnoreTimeDilationObject : RemovedIgnoreTimeDilationObjects)
+	for (const TWeakObjectPtr<T>& RemovedObject : Registry.PendingRemovedObjects)
+	{
+		FIgnoreTimeDilationImpl<T>::RemoveIgnore(RemovedObject.Get());
+	}
+	Registry.PendingRemovedObjects.Reset();
+
+	if (bGlobalTimeDilationChanged)
 	{
-		if (!RemovedIgnoreTimeDilationObject.IsValid())
+		// We're going through every object anyway, so this is a good time to drop the ones that were destroyed
+		CompactIgnoreRegistry(Registry);
+		for (const TPair<int32, TWeakObjectPtr<T>>& IgnoredObject : Registry.ObjectsByHandle)
 		{
-			continue;
+			FIgnoreTimeDilationImpl<T>::Ignore(IgnoredObject.Value.Get(), GlobalTimeDilationInverse);
 		}
-
-		FIgnoreTimeDilationImpl<T>::RemoveIgnore(RemovedIgnoreTimeDilationObject.Get());
-		IgnoreTimeDilationObjects.Remove(RemovedIgnoreTimeDilationObject);
 	}
-	RemovedIgnoreTimeDilationObjects.Empty();
-
-	for (const TWeakObjectPtr<T>& IgnoreTimeDilationObject : IgnoreTimeDilationObjects)
+	else
 	{
-		if (!IgnoreTimeDilationObject.IsValid())
+		for (const int32 AddedHandleId : Registry.PendingAddedHandles)
 		{
-			continue;
+			if (const TWeakObjectPtr<T>* AddedObject = Registry.ObjectsByHandle.Find(AddedHandleId))
+			{
+				FIgnoreTimeDilationImpl<T>::Ignore(AddedObject->Get(), GlobalTimeDilationInverse);
+			}
 		}
 
-		FIgnoreTimeDilationImpl<T>::Ignore(IgnoreTimeDilationObject.Get());
+		const int32 CompactionThreshold = FMath::Max(AstroTimeDilationSubsystemVars::MinIgnoreRegistryCompactionSize, Registry.CompactedNum * 2);
+		if (Registry.ObjectsByHandle.Num() >= CompactionThreshold)
+		{
+			CompactIgnoreRegistry(Registry);
+		}
 	}
+
+	Registry.PendingAddedHandles.Reset();
 }
 
 void UAstroTimeDilationSubsystem::DispatchUpdateIgnoredObjectsTimeDilation()
@@ -10,6 +10,7 @@
 
 #include "Engine/DeveloperSettings.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
 #include "TimerManager.h"
 #include "AstroTimeDilationSubsystem.generated.h"
 
@@ -29,6 +30,65 @@ public:
 
 };
 
+/** Identifies an object registered to ignore time dilation. Handles are never reused. */
+USTRUCT(BlueprintType)
+struct FAstroTimeDilationIgnoreHandle
+{
+	GENERATED_BODY()
+
+public:
+	bool IsValid() const { return HandleId != INDEX_NONE; }
+	void Invalidate() { HandleId = INDEX_NONE; }
+
+	bool operator==(const FAstroTimeDilationIgnoreHandle& Other) const { return HandleId == Other.HandleId; }
+	friend uint32 GetTypeHash(const FAstroTimeDilationIgnoreHandle& Handle) { return GetTypeHash(Handle.HandleId); }
+
+private:
+	friend class UAstroTimeDilationSubsystem;
+
+	UPROPERTY()
+	int32 HandleId = INDEX_NONE;
+
+};
+
+/** Identifies a timer set through UAstroTimeDilationSubsystem::SetAbsoluteTimer. Handles are never reused. */
+struct FAstroRealTimeTimerHandle
+{
+public:
+	bool IsValid() const { return TimerId != 0; }
+	void Invalidate() { TimerId = 0; }
+
+	bool operator==(const FAstroRealTimeTimerHandle& Other) const { return TimerId == Other.TimerId; }
+
+private:
+	friend class UAstroTimeDilationSubsystem;
+
+	uint64 TimerId = 0;
+
+};
+
+/**
+* Set of objects that ignore time dilation, for a single object type.
+* Objects are hashed both by handle and by object, so that registering and unregistering is O(1).
+*/
+template <typename T>
+struct TAstroTimeDilationIgnoreRegistry
+{
+	TMap<int32, TWeakObjectPtr<T>> ObjectsByHandle;
+	TMap<TObjectKey<T>, int32> HandlesByObject;
+
+	/** Objects registered since the last push. These are the only ones that need to be updated if the global dilation didn't change. */
+	TSet<int32> PendingAddedHandles;
+
+	/** Objects unregistered since the last push, which need their custom time dilation restored. */
+	TArray<TWeakObjectPtr<T>> PendingRemovedObjects;
+
+	/** Registry size after the last compaction. Stale objects are only compacted once the registry doubles in size, or when all objects are pushed. */
+	int32 CompactedNum = 0;
+
+	bool IsDirty() const { return !PendingAddedHandles.IsEmpty() || !PendingRemovedObjects.IsEmpty(); }
+};
+
 /**
 * AstroTimeDilationSubsystem contains Astro-specific utility methods for time dilation.
 */
@@ -40,6 +100,7 @@ class UAstroTimeDilationSubsystem : public UTickableWorldSubsystem
 #pragma region UWorldSubsystem
 public:
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
 #pragma endregion
 
 
@@ -53,30 +114,48 @@ public:
 #pragma region UAstroTimeDilationSubsystem
 public:
 	/*
-	* Sets a timer that will ignore time dilation and execute for a real-world duration.
-	* 
-	* NOTE: This method expects TimerHandle to be a valid reference throughout the duration of the timer.
+	* Sets a timer that will ignore time dilation and execute after a real-world duration.
+	* If TimerHandle refers to an active timer, that timer is replaced.
+	* If bClampFrameDelta is set, the timer advances by at most AstroTimeDilation.MaxAbsoluteTimerDeltaSeconds per frame, so that hitches and unpausing
+	* don't fire it early. This makes it run late below that frame rate.
+	* NOTE: Timers are only checked once per frame, on this subsystem's tick.
 	*/
-	void SetAbsoluteTimer(FTimerHandle& TimerHandle, const FTimerDelegate& TimerDelegate, float Duration);
+	void SetAbsoluteTimer(FAstroRealTimeTimerHandle& TimerHandle, const FTimerDelegate& TimerDelegate, float Duration, const bool bLoop = false, const bool bClampFrameDelta = false);
 
 	/*
 	* Clears an absolute timer given a TimerHandle.
 	*/
-	void ClearAbsoluteTimer(FTimerHandle& TimerHandle);
+	void ClearAbsoluteTimer(FAstroRealTimeTimerHandle& TimerHandle);
+
+	/** @return true if the timer is still pending. */
+	bool IsAbsoluteTimerActive(const FAstroRealTimeTimerHandle& TimerHandle) const;
+
+	/** @return Real-world seconds until the timer fires, or -1 if it's not active. */
+	float GetAbsoluteTimerRemaining(const FAstroRealTimeTimerHandle& TimerHandle) const;
+
+	/** Logs all pending absolute timers. */
+	void DumpAbsoluteTimers() const;
 
 	/*
 	* Forces an actor to ignore custom time dilation values.
+	* Registering an object twice returns the same handle.
 	*/
 	UFUNCTION(BlueprintCallable)
-	void RegisterIgnoreTimeDilation(AActor* Actor);
+	FAstroTimeDilationIgnoreHandle RegisterIgnoreTimeDilation(AActor* Actor);
 	UFUNCTION(BlueprintCallable)
 	void UnregisterIgnoreTimeDilation(AActor* Actor);
 
 	UFUNCTION(BlueprintCallable)
-	void RegisterIgnoreTimeDilationParticle(UNiagaraComponent* ParticleComponent);
+	FAstroTimeDilationIgnoreHandle RegisterIgnoreTimeDilationParticle(UNiagaraComponent* ParticleComponent);
 	UFUNCTION(BlueprintCallable)
 	void UnregisterIgnoreTimeDilationParticle(UNiagaraComponent* ParticleComponent);
 
+	/*
+	* Unregisters an actor or particle given the handle returned when it was registered.
+	*/
+	UFUNCTION(BlueprintCallable)
+	void UnregisterIgnoreTimeDilationByHandle(UPARAM(ref) FAstroTimeDilationIgnoreHandle& Handle);
+
 	/*
 	* Sets the global time dilation.
 	*/
@@ -121,27 +200,52 @@ public:
 
 private:
 	/*
-	* Updates the custom time dilation for all objects that want to ignore time dilation.
+	* Updates the custom time dilation for objects that want to ignore time dilation.
+	* All objects are only updated when the global time dilation changed since the last update. Otherwise, only new and removed objects are.
 	*/
 	void UpdateIgnoredObjectsTimeDilation();
 	template <typename T>
-	void UpdateIgnoredObjectsTimeDilationImpl(TArray<TWeakObjectPtr<T>>& IgnoreTimeDilationObjects, TArray<TWeakObjectPtr<T>>& RemovedIgnoreTimeDilationObjects);
+	void UpdateIgnoredObjectsTimeDilationImpl(TAstroTimeDilationIgnoreRegistry<T>& Registry, const float GlobalTimeDilationInverse, const bool bGlobalTimeDilationChanged);
+
+	template <typename T>
+	FAstroTimeDilationIgnoreHandle RegisterIgnoreTimeDilationImpl(TAstroTimeDilationIgnoreRegistry<T>& Registry, T* Object);
+	template <typename T>
+	bool UnregisterIgnoreTimeDilationImpl(TAstroTimeDilationIgnoreRegistry<T>& Registry, const int32 HandleId);
+
+	/*
+	* Removes objects that were destroyed without unregistering.
+	*/
+	template <typename T>
+	void CompactIgnoreRegistry(TAstroTimeDilationIgnoreRegistry<T>& Registry);
+
+	/*
+	* Steps the global time dilation towards its target, and updates everything that depends on it.
+	* Called at the start of the world tick, so the whole frame sees the same time dilation.
+	*/
+	void OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+	void ApplyPendingTimeDilation();
 
 	/*
 	* Dispatches an UpdateIgnoredObjectsTimeDilation call to the next frame.
 	*/
 	void DispatchUpdateIgnoredObjectsTimeDilation();
 
+	struct FAbsoluteTimerHeapEntry;
+
+	/*
+	* Fires every absolute timer of a heap that is due on a given clock.
+	*/
+	void TickAbsoluteTimers(TArray<FAbsoluteTimerHeapEntry>& Heap, const double ClockSeconds);
+	double GetAbsoluteTimerClockSeconds(const bool bClampFrameDelta) const;
+	TArray<FAbsoluteTimerHeapEntry>& GetAbsoluteTimerHeap(const bool bClampFrameDelta);
+
 private:
-	UPROPERTY()
-	TArray<TWeakObjectPtr<AActor>> IgnoreTimeDilationActors;
-	UPROPERTY()
-	TArray<TWeakObjectPtr<AActor>> RemovedIgnoreTimeDilationActors;
+	TAstroTimeDilationIgnoreRegistry<AActor> IgnoreTimeDilationActors;
+	TAstroTimeDilationIgnoreRegistry<UNiagaraComponent> IgnoreTimeDilationParticles;
+	int32 LastIgnoreHandleId = INDEX_NONE;
 
-	UPROPERTY()
-	TArray<TWeakObjectPtr<UNiagaraComponent>> IgnoreTimeDilationParticles;
-	UPROPERTY()
-	TArray<TWeakObjectPtr<UNiagaraComponent>> RemovedIgnoreTimeDilationParticles;
+	/** Global time dilation on the last UpdateIgnoredObjectsTimeDilation. */
+	float LastPushedGlobalTimeDilation = 1.f;
 
 	UPROPERTY(Transient)
 	TObjectPtr<UMaterialParameterCollection> RealTimeMPC = nullptr;
@@ -156,6 +260,38 @@ private:
 	};
 	TOptional<FTargetTimeDilationValue> TargetTimeDilationValue;
 	bool bAreTimeDilationIgnoredActorsDirty;
+	FDelegateHandle WorldTickStartHandle;
+
+	struct FAbsoluteTimer
+	{
+		FTimerDelegate TimerDelegate;
+		double FireTime = 0.0;
+		float Duration = 0.f;
+		bool bLoop = false;
+		bool bClampFrameDelta = false;
+	};
+	TMap<uint64, FAbsoluteTimer> AbsoluteTimers;
+
+	/**
+	* Min-heaps with the fire time of every absolute timer, on the real-time clock and on the clamped clock.
+	* NOTE: Cleared timers are not removed from the heap right away. Their entries are skipped when they're popped instead, so clearing is O(1).
+	*/
+	struct FAbsoluteTimerHeapEntry
+	{
+		double FireTime = 0.0;
+		uint64 TimerId = 0;
+
+		bool operator<(const FAbsoluteTimerHeapEntry& Other) const { return FireTime < Other.FireTime; }
+	};
+	TArray<FAbsoluteTimerHeapEntry> AbsoluteTimerHeap;
+	TArray<FAbsoluteTimerHeapEntry> ClampedAbsoluteTimerHeap;
+
+	/** Real-world clock used by absolute timers. Only advances while this subsystem ticks. */
+	double AbsoluteTimerClockSeconds = 0.0;
+
+	/** Same as AbsoluteTimerClockSeconds, but advances by at most AstroTimeDilation.MaxAbsoluteTimerDeltaSeconds per frame. */
+	double ClampedAbsoluteTimerClockSeconds = 0.0;
+	uint64 LastAbsoluteTimerId = 0;
 
 #pragma endregion
 };
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "BallMachine.h"
 
 #include "AbilitySystemComponent.h"
+#include "AstroBallPoolManager.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Engine/World.h"
 #include "HealthAttributeSet.h"
@@ -20,6 +21,17 @@ ABallMachine::ABallMachine(const FObjectInitializer& ObjectInitializer) : Super(
 	SetRootComponent(BallMachineMesh);
 }
 
+void ABallMachine::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Pre-warms the ball pool while the room is still loading, so that the first shots don't have to spawn balls
+	if (UAstroBallPoolManager* BallPoolManager = UAstroBallPoolManager::Get(this))
+	{
+		BallPoolManager->RequestPrewarm(ThrowParameters.ThrownBallClass);
+	}
+}
+
 void ABallMachine::PossessedBy(AController* NewController)
 {
 	Super::PossessedBy(NewController);
@@ -77,6 +77,7 @@ public:
 	ABallMachine(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
 protected:
+	virtual void BeginPlay() override;
 	virtual void PossessedBy(AController* NewController);
 #pragma endregion
 
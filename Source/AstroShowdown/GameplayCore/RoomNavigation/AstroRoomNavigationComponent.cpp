@@ -49,6 +49,13 @@ namespace AstroRoomNavigationVars
 		bForcePlayInterstitials,
 		TEXT("When enabled, will forcibly play all interstitials."),
 		ECVF_Default);
+
+	static bool bEnableRoomPrefetch = true;
+	static FAutoConsoleVariableRef CVarEnableRoomPrefetch(
+		TEXT("RoomNavigation.EnableRoomPrefetch"),
+		bEnableRoomPrefetch,
+		TEXT("When enabled, neighbor rooms are loaded ahead of time as hidden levels, so that door transitions don't have to wait for them to load."),
+		ECVF_Default);
 }
 
 
@@ -102,7 +109,15 @@ void UAstroRoomNavigationComponent::BeginPlay()
 
 	FAstroCoreDelegates::OnPreRestartCurrentLevel.AddUObject(this, &UAstroRoomNavigationComponent::OnPreRestartCurrentLevel);
 
-	LoadStartingLevel();
+	// Room loading depends on the campaign's persistence (e.g., interstitials and door locks), so we have to wait for it
+	if (UAstroCampaignPersistenceSubsystem* CampaignPersistenceSubsystem = SubsystemUtils::GetGameInstanceSubsystem<UAstroCampaignPersistenceSubsystem>(this))
+	{
+		CampaignPersistenceSubsystem->CallOrRegister_OnPersistenceReady(FOnAstroCampaignPersistenceReady::FDelegate::CreateUObject(this, &UAstroRoomNavigationComponent::LoadStartingLevel));
+	}
+	else
+	{
+		LoadStartingLevel();
+	}
 }
 
 void UAstroRoomNavigationComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -113,6 +128,16 @@ void UAstroRoomNavigationComponent::EndPlay(const EEndPlayReason::Type EndPlayRe
 
 	FWorldDelegates::LevelAddedToWorld.Remove(WaitForMainLevelLoadDelegateHandle);
 	FAstroCoreDelegates::OnPreRestartCurrentLevel.RemoveAll(this);
+
+	if (UAstroCampaignPersistenceSubsystem* CampaignPersistenceSubsystem = SubsystemUtils::GetGameInstanceSubsystem<UAstroCampaignPersistenceSubsystem>(this))
+	{
+		CampaignPersistenceSubsystem->OnPersistenceReadyStatic.RemoveAll(this);
+	}
+
+	ReleaseAllPrefetchedRooms();
+
+	UE_LOG(LogAstroLevelStreaming, Display, TEXT("[%hs] Room prefetch stats: Hits=%d Misses=%d HitRate=%.2f Wasted=%d AverageTransition=%.2fs"), __FUNCTION__,
+		PrefetchStats.PrefetchHits, PrefetchStats.PrefetchMisses, PrefetchStats.GetHitRate(), PrefetchStats.WastedPrefetches, PrefetchStats.AverageTransitionSeconds);
 }
 
 bool UAstroRoomNavigationComponent::ShouldShowLoadingScreen(FString& OutReason) const
@@ -181,6 +206,8 @@ void UAstroRoomNavigationComponent::MoveToDirection(const EAstroRoomDoorDirectio
 
 void UAstroRoomNavigationComponent::RoomLoadFlowStep_UnloadCurrentRoom(FControlFlowNodeRef SubFlow, FRoomLoadFlowStepSharedState* SharedLoadFlowState)
 {
+	TransitionStartTime = FPlatformTime::Seconds();
+
 	// Unloads the current room
 	const FSoftWorldReference UnloadedRoomWorldAsset = GetCurrentRoomWorldAsset();
 	UnloadCurrentLevel();
@@ -287,6 +314,21 @@ void UAstroRoomNavigationComponent::RoomLoadFlowStep_StartLoadingRoom(FControlFl
 		return;
 	}
 
+	// If the room was prefetched, we only need to show it
+	if (ULevelStreamingDynamic* PrefetchedRoomWorldStreaming = ClaimPrefetchedRoom(TargetWorld))
+	{
+		UE_LOG(LogAstroLevelStreaming, Verbose, TEXT("[%hs] Using prefetched room (%s)."), __FUNCTION__, *TargetWorld.WorldAsset.ToString());
+		PrefetchStats.PrefetchHits++;
+
+		PrefetchedRoomWorldStreaming->SetShouldBeVisible(true);
+		bShouldShowLoadingScreen = true;		// Triggers the loading screen
+		SharedLoadFlowState->NextRoomWorldStreaming = PrefetchedRoomWorldStreaming;
+		SubFlow->ContinueFlow();
+		return;
+	}
+
+	PrefetchStats.PrefetchMisses++;
+
 	// NOTE: This is async, so we have to wait until the level is loaded AND shown before moving the player
 	bool bSuccess = false;
 	ULevelStreamingDynamic* NextRoomWorldStreaming = ULevelStreamingDynamic::LoadLevelInstanceBySoftObjectPtr(this, TargetWorld.WorldAsset, FTransform::Identity, bSuccess);
@@ -311,9 +353,11 @@ void UAstroRoomNavigationComponent::RoomLoadFlowStep_WaitForMainLevelLoad(FContr
 		return;
 	}
 
-	// If the world was already loaded, we can call the OnRoomLevelAdded event directly.
+	// If the world was already loaded and shown, we can call the OnRoomLevelAdded event directly.
 	// Otherwise, we need to wait until WP Subsystem loads each Level in the World (check UWorldPartitionLevelStreamingDynamic::IssueLoadRequests)
-	if (SharedLoadFlowState->NextRoomWorldStreaming->HasLoadedLevel())
+	// NOTE: Prefetched rooms are already loaded, but they're only added to the world once they become visible
+	const ULevel* NextRoomLevel = SharedLoadFlowState->NextRoomWorldStreaming->GetLoadedLevel();
+	if (NextRoomLevel && NextRoomLevel->bIsVisible)
 	{
 		SubFlow->ContinueFlow();
 	}
@@ -470,6 +514,16 @@ void UAstroRoomNavigationComponent::RoomLoadFlowStep_FinishMainLevelLoad(FContro
 	const FSoftWorldReference CurrentRoomWorld = GetCurrentRoomWorldAsset();
 	OnRoomLoaded.Broadcast(CurrentRoomWorld);
 
+	// Records how long the transition took
+	const float TransitionSeconds = static_cast<float>(FPlatformTime::Seconds() - TransitionStartTime);
+	PrefetchStats.TransitionCount++;
+	PrefetchStats.LastTransitionSeconds = TransitionSeconds;
+	PrefetchStats.AverageTransitionSeconds += (TransitionSeconds - PrefetchStats.AverageTransitionSeconds) / PrefetchStats.TransitionCount;
+	UE_LOG(LogAstroLevelStreaming, Log, TEXT("[%hs] Room transition took %.2fs (prefetch hit rate: %.2f)."), __FUNCTION__, TransitionSeconds, PrefetchStats.GetHitRate());
+
+	// Starts loading the rooms the player may go to next
+	PrefetchNeighborRooms();
+
 	SubFlow->ContinueFlow();
 }
 
@@ -539,7 +593,13 @@ ULevelStreamingDynamic* UAstroRoomNavigationComponent::FindCurrentRoomWorldStrea
 	{
 		for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
 		{
-			if (const bool bIsUnloaded = !StreamingLevel->IsLevelLoaded() || StreamingLevel->GetLevelStreamingState() == ELevelStreamingState::MakingInvisible)
+			if (const bool bIsUnloaded = !StreamingLevel->IsLevelLoaded() || StreamingLevel->GetLevelStreamingState() == ELevelStreamingState::MakingInvisible || StreamingLevel->GetIsRequestingUnloadAndRemoval())
+			{
+				continue;
+			}
+
+			// Prefetched rooms are loaded, but they're not the current room until they're claimed
+			if (IsPrefetchedRoomStreaming(StreamingLevel))
 			{
 				continue;
 			}
@@ -674,6 +734,134 @@ void UAstroRoomNavigationComponent::DeactivateRoom()
 	}
 }
 
+void UAstroRoomNavigationComponent::PrefetchNeighborRooms()
+{
+	const FSoftWorldReference CurrentRoomWorld = GetCurrentRoomWorldAsset();
+	const UAstroRoomNavigationSubsystem* RoomNavigationSubsystem = UAstroRoomNavigationSubsystem::Get(this);
+	const UAstroRoomNavigationSubsystem::FAstroRoomRuntimeNavigationData RoomNavigationData = RoomNavigationSubsystem ? RoomNavigationSubsystem->GetRoomRuntimeNavigationData(CurrentRoomWorld) : UAstroRoomNavigationSubsystem::FAstroRoomRuntimeNavigationData();
+
+	// North goes first, as players are more likely to move forward in the campaign
+	TArray<FSoftWorldReference, TInlineAllocator<2>> NeighborRoomWorlds;
+	if (AstroRoomNavigationVars::bEnableRoomPrefetch)
+	{
+		for (const UAstroRoomData* NeighborRoom : { RoomNavigationData.NorthNeighbor, RoomNavigationData.SouthNeighbor })
+		{
+			if (NeighborRoom && NeighborRoom->RoomLevel.WorldAsset != CurrentRoomWorld.WorldAsset && NeighborRoomWorlds.Num() < MaxPrefetchedRooms)
+			{
+				NeighborRoomWorlds.Add(NeighborRoom->RoomLevel);
+			}
+		}
+	}
+
+	// Releases rooms that are no longer neighbors
+	for (int32 PrefetchedRoomIndex = PrefetchedRooms.Num() - 1; PrefetchedRoomIndex >= 0; PrefetchedRoomIndex--)
+	{
+		const FAstroPrefetchedRoom& PrefetchedRoom = PrefetchedRooms[PrefetchedRoomIndex];
+		const bool bIsStillNeighbor = NeighborRoomWorlds.ContainsByPredicate([&PrefetchedRoom](const FSoftWorldReference& NeighborRoomWorld) { return NeighborRoomWorld.WorldAsset == PrefetchedRoom.RoomWorld.WorldAsset; });
+		if (!bIsStillNeighbor || !IsValid(PrefetchedRoom.LevelStreaming))
+		{
+			ReleasePrefetchedRoomAt(PrefetchedRoomIndex);
+		}
+	}
+
+	UWorld* World = GetWorld();
+	if (!World || !CanPrefetchRooms())
+	{
+		return;
+	}
+
+	// Loads the neighbors that are not prefetched yet, as hidden levels.
+	// NOTE: Hidden levels are never added to the world, so their actors won't begin play and their room actions won't be activated until they're claimed.
+	for (const FSoftWorldReference& NeighborRoomWorld : NeighborRoomWorlds)
+	{
+		const bool bIsAlreadyPrefetched = PrefetchedRooms.ContainsByPredicate([&NeighborRoomWorld](const FAstroPrefetchedRoom& PrefetchedRoom) { return PrefetchedRoom.RoomWorld.WorldAsset == NeighborRoomWorld.WorldAsset; });
+		if (bIsAlreadyPrefetched || PrefetchedRooms.Num() >= MaxPrefetchedRooms)
+		{
+			continue;
+		}
+
+		FLoadLevelInstanceParams LoadLevelInstanceParams(World, NeighborRoomWorld.WorldAsset.GetLongPackageName(), FTransform::Identity);
+		LoadLevelInstanceParams.bInitiallyVisible = false;
+
+		bool bSuccess = false;
+		ULevelStreamingDynamic* PrefetchedRoomWorldStreaming = ULevelStreamingDynamic::LoadLevelInstance(LoadLevelInstanceParams, OUT bSuccess);
+		if (bSuccess && PrefetchedRoomWorldStreaming)
+		{
+			FAstroPrefetchedRoom& PrefetchedRoom = PrefetchedRooms.AddDefaulted_GetRef();
+			PrefetchedRoom.RoomWorld = NeighborRoomWorld;
+			PrefetchedRoom.LevelStreaming = PrefetchedRoomWorldStreaming;
+			UE_LOG(LogAstroLevelStreaming, Verbose, TEXT("[%hs] Prefetching room (%s)."), __FUNCTION__, *NeighborRoomWorld.WorldAsset.ToString());
+		}
+		else
+		{
+			UE_LOG(LogAstroLevelStreaming, Warning, TEXT("[%hs] Failed to prefetch room (%s)."), __FUNCTION__, *NeighborRoomWorld.WorldAsset.ToString());
+		}
+	}
+}
+
+ULevelStreamingDynamic* UAstroRoomNavigationComponent::ClaimPrefetchedRoom(const FSoftWorldReference& RoomWorld)
+{
+	const int32 PrefetchedRoomIndex = PrefetchedRooms.IndexOfByPredicate([&RoomWorld](const FAstroPrefetchedRoom& PrefetchedRoom) { return PrefetchedRoom.RoomWorld.WorldAsset == RoomWorld.WorldAsset; });
+	if (PrefetchedRoomIndex == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	ULevelStreamingDynamic* PrefetchedRoomWorldStreaming = PrefetchedRooms[PrefetchedRoomIndex].LevelStreaming;
+	PrefetchedRooms.RemoveAtSwap(PrefetchedRoomIndex);
+
+	// The streaming object may have been removed from the world by someone else (e.g., a world cleanup)
+	return IsValid(PrefetchedRoomWorldStreaming) && PrefetchedRoomWorldStreaming->ShouldBeLoaded() ? PrefetchedRoomWorldStreaming : nullptr;
+}
+
+void UAstroRoomNavigationComponent::ReleasePrefetchedRoomAt(const int32 PrefetchedRoomIndex)
+{
+	if (!PrefetchedRooms.IsValidIndex(PrefetchedRoomIndex))
+	{
+		return;
+	}
+
+	if (ULevelStreamingDynamic* PrefetchedRoomWorldStreaming = PrefetchedRooms[PrefetchedRoomIndex].LevelStreaming; IsValid(PrefetchedRoomWorldStreaming))
+	{
+		UE_LOG(LogAstroLevelStreaming, Verbose, TEXT("[%hs] Releasing prefetched room (%s)."), __FUNCTION__, *PrefetchedRooms[PrefetchedRoomIndex].RoomWorld.WorldAsset.ToString());
+		PrefetchedRoomWorldStreaming->SetIsRequestingUnloadAndRemoval(true);		// Forces removal from World::StreamingLevels when unloading
+		PrefetchedRoomWorldStreaming->SetShouldBeLoaded(false);
+	}
+
+	PrefetchStats.WastedPrefetches++;
+	PrefetchedRooms.RemoveAtSwap(PrefetchedRoomIndex);
+}
+
+void UAstroRoomNavigationComponent::ReleaseAllPrefetchedRooms()
+{
+	while (!PrefetchedRooms.IsEmpty())
+	{
+		ReleasePrefetchedRoomAt(PrefetchedRooms.Num() - 1);
+	}
+}
+
+bool UAstroRoomNavigationComponent::IsPrefetchedRoomStreaming(const ULevelStreaming* LevelStreaming) const
+{
+	return LevelStreaming && PrefetchedRooms.ContainsByPredicate([LevelStreaming](const FAstroPrefetchedRoom& PrefetchedRoom) { return PrefetchedRoom.LevelStreaming == LevelStreaming; });
+}
+
+bool UAstroRoomNavigationComponent::CanPrefetchRooms() const
+{
+	if (!AstroRoomNavigationVars::bEnableRoomPrefetch || MaxPrefetchedRooms <= 0)
+	{
+		return false;
+	}
+
+	const uint64 AvailablePhysicalMemoryMB = FPlatformMemory::GetStats().AvailablePhysical / (1024 * 1024);
+	if (AvailablePhysicalMemoryMB < static_cast<uint64>(FMath::Max(MinAvailableMemoryForPrefetchMB, 0)))
+	{
+		UE_LOG(LogAstroLevelStreaming, Verbose, TEXT("[%hs] Skipping room prefetch, not enough memory (%llu MB available)."), __FUNCTION__, AvailablePhysicalMemoryMB);
+		return false;
+	}
+
+	return true;
+}
+
 FSoftWorldReference UAstroRoomNavigationComponent::GetCurrentRoomWorldAsset() const
 {
 	FSoftWorldReference CurrentRoomWorldAsset;
@@ -690,6 +878,8 @@ void UAstroRoomNavigationComponent::OnPreRestartCurrentLevel(bool& bShouldDeferR
 	// Deactivates all GFAs for the currently loaded room
 	DeactivateRoom();
 
+	ReleaseAllPrefetchedRooms();
+
 	// Sets the root level override to the current loaded room
 	bShouldDeferRestart = true;
 	SetShowLoadingScreen(true);
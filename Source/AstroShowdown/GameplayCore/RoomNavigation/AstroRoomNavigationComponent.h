@@ -24,6 +24,55 @@ class ULevelStreamingDynamic;
 enum class EAstroRoomDoorDirection : uint8;
 
 
+/** Neighbor room that is loaded ahead of time, but kept hidden until the player moves into it. */
+USTRUCT()
+struct FAstroPrefetchedRoom
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(Transient)
+	FSoftWorldReference RoomWorld;
+
+	UPROPERTY(Transient)
+	TObjectPtr<ULevelStreamingDynamic> LevelStreaming = nullptr;
+
+};
+
+USTRUCT(BlueprintType)
+struct FAstroRoomPrefetchStats
+{
+	GENERATED_BODY()
+
+public:
+	/** Room loads that were served by a prefetched room. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 PrefetchHits = 0;
+
+	/** Room loads that had to load the room from scratch. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 PrefetchMisses = 0;
+
+	/** Prefetches that were released without ever being used. */
+	UPROPERTY(BlueprintReadOnly)
+	int32 WastedPrefetches = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 TransitionCount = 0;
+
+	/** Wall time between unloading the previous room and the new room being ready, including interstitials. */
+	UPROPERTY(BlueprintReadOnly, meta = (ForceUnits = s))
+	float LastTransitionSeconds = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, meta = (ForceUnits = s))
+	float AverageTransitionSeconds = 0.f;
+
+public:
+	float GetHitRate() const { return PrefetchHits + PrefetchMisses > 0 ? static_cast<float>(PrefetchHits) / (PrefetchHits + PrefetchMisses) : 0.f; }
+
+};
+
+
 UCLASS()
 class UAstroRoomNavigationComponent : public UGameStateComponent, public ILoadingProcessInterface
 {
@@ -56,9 +105,26 @@ public:
 	UPROPERTY(EditDefaultsOnly, meta = (ForceUnits = s))
 	float MoveToTransitionDuration = 1.5f;
 
+	/** Maximum amount of neighbor rooms that may be loaded (hidden) ahead of time. Set to 0 to disable prefetching. */
+	UPROPERTY(EditDefaultsOnly, Category = "Prefetch", meta = (UIMin = 0, UIMax = 2))
+	int32 MaxPrefetchedRooms = 2;
+
+	/** Neighbor rooms won't be prefetched while the available physical memory is below this value. */
+	UPROPERTY(EditDefaultsOnly, Category = "Prefetch", meta = (ForceUnits = MB))
+	int32 MinAvailableMemoryForPrefetchMB = 1024;
+
 private:
 	TSharedPtr<FControlFlow> RoomWorldLoadFlow;
 
+	/** Neighbor rooms that are loaded, or being loaded, but hidden. */
+	UPROPERTY(Transient)
+	TArray<FAstroPrefetchedRoom> PrefetchedRooms;
+
+	FAstroRoomPrefetchStats PrefetchStats;
+
+	/** When the current transition started unloading the previous room. Used to measure transition times. */
+	double TransitionStartTime = 0.0;
+
 	FDelegateHandle WaitForMainLevelLoadDelegateHandle;
 
 public:
@@ -99,6 +165,19 @@ private:
 	void ActivateRoom();
 	void DeactivateRoom();
 
+private:
+	/** Loads the neighbors of the current room as hidden levels, and releases prefetched rooms that are no longer neighbors. */
+	void PrefetchNeighborRooms();
+	/** Removes a prefetched room from the prefetch list, and returns its level streaming so it can be made visible. */
+	ULevelStreamingDynamic* ClaimPrefetchedRoom(const FSoftWorldReference& RoomWorld);
+	void ReleasePrefetchedRoomAt(const int32 PrefetchedRoomIndex);
+	void ReleaseAllPrefetchedRooms();
+	bool IsPrefetchedRoomStreaming(const ULevelStreaming* LevelStreaming) const;
+	bool CanPrefetchRooms() const;
+
+public:
+	const FAstroRoomPrefetchStats& GetPrefetchStats() const { return PrefetchStats; }
+
 
 public:
 	FSoftWorldReference GetCurrentRoomWorldAsset() const;
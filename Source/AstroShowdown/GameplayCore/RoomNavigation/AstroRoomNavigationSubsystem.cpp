@@ -46,48 +46,38 @@ UAstroRoomNavigationSubsystem::FAstroRoomRuntimeNavigationData UAstroRoomNavigat
 		return FAstroRoomRuntimeNavigationData();
 	}
 
-	const UAstroCampaignData* CampaignData = UAstroCampaignDataSubsystem::GetCampaignData(this);
-	if (!ensureMsgf(CampaignData, TEXT("Invalid CampaignData")))
+	const UAstroCampaignDataSubsystem* CampaignDataSubsystem = SubsystemUtils::GetGameInstanceSubsystem<UAstroCampaignDataSubsystem>(this);
+	if (!ensureMsgf(CampaignDataSubsystem, TEXT("Invalid CampaignDataSubsystem")))
+	{
+		return FAstroRoomRuntimeNavigationData();
+	}
+
+	const FAstroCampaignRoomEntry* RoomEntry = CampaignDataSubsystem->FindRoomEntryByWorld(InRoomWorldAsset);
+	if (!RoomEntry)
 	{
 		return FAstroRoomRuntimeNavigationData();
 	}
 
 	// Right now, we can assume that all rooms are disposed linearly and consecutively, so a room may only have one entry and one exit,
-	// through the south and north, respectively.
-	UAstroRoomData* PreviousRoom = nullptr;
-	for (int32 SectionIndex = 0; SectionIndex < CampaignData->Sections.Num(); SectionIndex++)
+	// through the south and north, respectively. Room entries are indexed in campaign order, so neighbors are the adjacent entries.
+	FAstroRoomRuntimeNavigationData RoomRuntimeNavigationData;
+	RoomRuntimeNavigationData.Room = RoomEntry->Room;
+
+	if (const FAstroCampaignRoomEntry* PreviousRoomEntry = CampaignDataSubsystem->GetRoomEntryByCampaignIndex(RoomEntry->CampaignIndex - 1))
+	{
+		RoomRuntimeNavigationData.SouthNeighbor = PreviousRoomEntry->Room;
+	}
+
+	// NorthNeighbor is either the next room in this section, or the first room in the next section
+	if (const FAstroCampaignRoomEntry* NextRoomEntry = CampaignDataSubsystem->GetRoomEntryByCampaignIndex(RoomEntry->CampaignIndex + 1))
 	{
-		const UAstroSectionData* CurrentSection = CampaignData->Sections[SectionIndex];
-		for (int32 RoomIndex = 0; RoomIndex < CurrentSection->Rooms.Num(); RoomIndex++)
+		if (const bool bIsInSameOrNextSection = NextRoomEntry->SectionIndex <= RoomEntry->SectionIndex + 1)
 		{
-			UAstroRoomData* RoomData = CurrentSection->Rooms[RoomIndex];
-			if (const bool bIsAnother = RoomData->RoomLevel.WorldAsset != InRoomWorldAsset.WorldAsset)
-			{
-				PreviousRoom = RoomData;
-				continue;
-			}
-
-			const int32 NextRoomIndex = RoomIndex + 1;
-			const int32 NextSectionIndex = SectionIndex + 1;
-			FAstroRoomRuntimeNavigationData RoomRuntimeNavigationData;
-			RoomRuntimeNavigationData.Room = RoomData;
-			RoomRuntimeNavigationData.SouthNeighbor = PreviousRoom;
-
-			// NorthNeighbor is either the next room in this section, or the first room in the next section
-			if (CurrentSection->Rooms.IsValidIndex(NextRoomIndex))
-			{
-				RoomRuntimeNavigationData.NorthNeighbor = CurrentSection->Rooms[NextRoomIndex];
-			}
-			else if (CampaignData->Sections.IsValidIndex(NextSectionIndex) && CampaignData->Sections[NextSectionIndex]->Rooms.IsValidIndex(0))
-			{
-				RoomRuntimeNavigationData.NorthNeighbor = CampaignData->Sections[NextSectionIndex]->Rooms[0];
-			}
-
-			return RoomRuntimeNavigationData;
+			RoomRuntimeNavigationData.NorthNeighbor = NextRoomEntry->Room;
 		}
 	}
 
-	return FAstroRoomRuntimeNavigationData();
+	return RoomRuntimeNavigationData;
 }
 
 UAstroRoomData* UAstroRoomNavigationSubsystem::GetCurrentRoom() const
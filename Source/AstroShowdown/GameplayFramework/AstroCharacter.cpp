@@ -93,6 +93,12 @@ void AAstroCharacter::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// Stops listening to room enter messages
 	UGameplayMessageSubsystem::Get(this).UnregisterListener(RoomEnterMessageHandle);
+
+	// The ASC lives in the player state, so states granted to it would outlive this character
+	if (AstroStateMachine)
+	{
+		AstroStateMachine->ClearGrantedStates();
+	}
 }
 
 void AAstroCharacter::PossessedBy(AController* NewController)
@@ -466,3 +472,8 @@ UAstroInteractionComponent* AAstroCharacter::GetInteractionComponent() const
 {
 	return AstroInteractionComponent;
 }
+
+const FAstroStateTransitionStats* AAstroCharacter::GetStateTransitionStats() const
+{
+	return AstroStateMachine ? &AstroStateMachine->GetTransitionStats() : nullptr;
+}
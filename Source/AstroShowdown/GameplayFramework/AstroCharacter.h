@@ -25,6 +25,7 @@ class UGameplayAbility_BulletTime;
 class UGameplayAbility_AstroDash;
 class UGameplayEffect;
 struct FAstroRoomGenericMessage;
+struct FAstroStateTransitionStats;
 
 UCLASS()
 class ASTROSHOWDOWN_API AAstroCharacter : public AModularCharacter, public IAbilitySystemInterface
@@ -221,5 +222,7 @@ public:
 
 	UAstroInteractionComponent* GetInteractionComponent() const;
 
+	const FAstroStateTransitionStats* GetStateTransitionStats() const;
+
 #pragma endregion
 };
@@ -15,6 +15,7 @@
 #include "AstroGameState.h"
 #include "AstroThrowAimComponent.h"
 #include "AstroInteractionComponent.h"
+#include "AstroPerfCounters.h"
 #include "AstroTimeDilationSubsystem.h"
 #include "Engine/GameViewportClient.h"
 #include "Engine/LocalPlayer.h"
@@ -32,6 +33,24 @@ namespace AstroControllerStatics
 	static const FName AstroThrowAimAxisName = "AstroThrowAim";
 }
 
+namespace AstroControllerUtils
+{
+	namespace Private
+	{
+		enum class ECursorQueryType : uint8
+		{
+			Channel,
+			ObjectTypes,
+		};
+
+		/** Packs a cursor query profile into a single key. ChannelOrObjectTypes is either a collision channel, or an object types bitfield. */
+		uint64 MakeCursorQueryKey(const ECursorQueryType QueryType, const uint32 ChannelOrObjectTypes, const bool bTraceComplex)
+		{
+			return (static_cast<uint64>(QueryType) << 40) | (static_cast<uint64>(bTraceComplex) << 32) | ChannelOrObjectTypes;
+		}
+	}
+}
+
 AAstroController::AAstroController(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	AstroDashAimComponent = CreateDefaultSubobject<UAstroDashAimComponent>("AstroDashAimComponent");
@@ -252,42 +271,117 @@ void AAstroController::UnGrantAllInputs()
 
 bool AAstroController::GetHitResultsUnderCursorForObjects(const TArray<TEnumAsByte<EObjectTypeQuery>>& ObjectTypes, bool bTraceComplex, OUT TArray<FHitResult>& HitResults) const
 {
-	ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
-	bool bHit = false;
-	if (LocalPlayer && LocalPlayer->ViewportClient)
+	FCollisionObjectQueryParams const ObjParam(ObjectTypes);
+	const uint64 QueryKey = AstroControllerUtils::Private::MakeCursorQueryKey(AstroControllerUtils::Private::ECursorQueryType::ObjectTypes, static_cast<uint32>(ObjParam.GetQueryBitfield()), bTraceComplex);
+	const FAstroCursorQueryCache::FCachedCursorQuery* CursorQuery = FindOrRunCursorQuery(QueryKey, [this, &ObjParam, bTraceComplex](const FVector& TraceStart, const FVector& TraceEnd, TArray<FHitResult>& OutHitResults)
 	{
-		FVector2D MousePosition;
-		if (LocalPlayer->ViewportClient->GetMousePosition(MousePosition))
-		{
-			bHit = GetHitResultsAtScreenPosition(MousePosition, ObjectTypes, bTraceComplex, OUT HitResults);
-		}
-	}
+		return GetWorld()->LineTraceMultiByObjectType(OutHitResults, TraceStart, TraceEnd, ObjParam, FCollisionQueryParams(SCENE_QUERY_STAT(ClickableTrace), bTraceComplex));
+	});
 
-	if (!bHit)	// If there was no hit we reset the results. This is redundant but may help users.
+	// If there was no hit we reset the results. This is redundant but may help users.
+	if (!CursorQuery || !CursorQuery->bHit)
 	{
 		HitResults.Empty();
+		return false;
 	}
 
-	return bHit;
+	HitResults = CursorQuery->HitResults;
+	return true;
 }
 
-bool AAstroController::GetHitResultsAtScreenPosition(const FVector2D ScreenPosition, const TArray<TEnumAsByte<EObjectTypeQuery>>& ObjectTypes, bool bTraceComplex, OUT TArray<FHitResult>& HitResults) const
+bool AAstroController::GetCachedHitResultUnderCursorByChannel(ETraceTypeQuery TraceChannel, bool bTraceComplex, OUT FHitResult& HitResult) const
 {
-	// Early out if we clicked on a HUD hitbox
-	if (GetHUD() != NULL && GetHUD()->GetHitBoxAtCoordinates(ScreenPosition, true))
+	const ECollisionChannel CollisionChannel = UEngineTypes::ConvertToCollisionChannel(TraceChannel);
+	const uint64 QueryKey = AstroControllerUtils::Private::MakeCursorQueryKey(AstroControllerUtils::Private::ECursorQueryType::Channel, static_cast<uint32>(CollisionChannel), bTraceComplex);
+	const FAstroCursorQueryCache::FCachedCursorQuery* CursorQuery = FindOrRunCursorQuery(QueryKey, [this, CollisionChannel, bTraceComplex](const FVector& TraceStart, const FVector& TraceEnd, TArray<FHitResult>& OutHitResults)
+	{
+		FHitResult& OutHitResult = OutHitResults.AddDefaulted_GetRef();
+		return GetWorld()->LineTraceSingleByChannel(OutHitResult, TraceStart, TraceEnd, CollisionChannel, FCollisionQueryParams(SCENE_QUERY_STAT(ClickableTrace), bTraceComplex));
+	});
+
+	if (!CursorQuery || !CursorQuery->bHit || CursorQuery->HitResults.IsEmpty())
 	{
+		HitResult = FHitResult();
 		return false;
 	}
 
-	FVector WorldOrigin;
-	FVector WorldDirection;
-	if (UGameplayStatics::DeprojectScreenToWorld(this, ScreenPosition, WorldOrigin, WorldDirection))
+	HitResult = CursorQuery->HitResults[0];
+	return true;
+}
+
+bool AAstroController::GetCachedCursorRay(OUT FVector& WorldOrigin, OUT FVector& WorldDirection) const
+{
+	RefreshCursorQueryCache();
+	if (!CursorQueryCache.bHasCursorRay)
 	{
-		FCollisionObjectQueryParams const ObjParam(ObjectTypes);
-		return GetWorld()->LineTraceMultiByObjectType(HitResults, WorldOrigin, WorldOrigin + WorldDirection * HitResultTraceDistance, ObjParam, FCollisionQueryParams(SCENE_QUERY_STAT(ClickableTrace), bTraceComplex));
+		return false;
 	}
 
-	return false;
+	WorldOrigin = CursorQueryCache.RayOrigin;
+	WorldDirection = CursorQueryCache.RayDirection;
+	return true;
+}
+
+int32 AAstroController::GetCursorQueryRequestCount() const
+{
+	return CursorQueryCache.CachedFrame == GFrameCounter ? CursorQueryCache.RequestCount : 0;
+}
+
+int32 AAstroController::GetCursorQueryTraceCount() const
+{
+	return CursorQueryCache.CachedFrame == GFrameCounter ? CursorQueryCache.TraceCount : 0;
+}
+
+void AAstroController::RefreshCursorQueryCache() const
+{
+	if (CursorQueryCache.CachedFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	CursorQueryCache.CachedFrame = GFrameCounter;
+	CursorQueryCache.CachedQueries.Reset();
+	CursorQueryCache.RequestCount = 0;
+	CursorQueryCache.TraceCount = 0;
+	CursorQueryCache.bHasCursorRay = false;
+
+	ULocalPlayer* LocalPlayer = Cast<ULocalPlayer>(Player);
+	if (!LocalPlayer || !LocalPlayer->ViewportClient || !LocalPlayer->ViewportClient->GetMousePosition(CursorQueryCache.ScreenPosition))
+	{
+		return;
+	}
+
+	CursorQueryCache.bHasCursorRay = UGameplayStatics::DeprojectScreenToWorld(this, CursorQueryCache.ScreenPosition, CursorQueryCache.RayOrigin, CursorQueryCache.RayDirection);
+}
+
+const FAstroCursorQueryCache::FCachedCursorQuery* AAstroController::FindOrRunCursorQuery(const uint64 QueryKey, TFunctionRef<bool(const FVector&, const FVector&, TArray<FHitResult>&)> TraceFn) const
+{
+	RefreshCursorQueryCache();
+	CursorQueryCache.RequestCount++;
+
+	if (const FAstroCursorQueryCache::FCachedCursorQuery* CachedQuery = CursorQueryCache.CachedQueries.Find(QueryKey))
+	{
+		return CachedQuery;
+	}
+
+	FAstroCursorQueryCache::FCachedCursorQuery& CursorQuery = CursorQueryCache.CachedQueries.Add(QueryKey);
+	if (!CursorQueryCache.bHasCursorRay)
+	{
+		return &CursorQuery;
+	}
+
+	// Early out if we clicked on a HUD hitbox
+	if (GetHUD() != NULL && GetHUD()->GetHitBoxAtCoordinates(CursorQueryCache.ScreenPosition, true))
+	{
+		return &CursorQuery;
+	}
+
+	CursorQueryCache.TraceCount++;
+	AstroPerfCounters::AddTraceCalls();
+
+	const FVector TraceEnd = CursorQueryCache.RayOrigin + CursorQueryCache.RayDirection * HitResultTraceDistance;
+	CursorQuery.bHit = TraceFn(CursorQueryCache.RayOrigin, TraceEnd, CursorQuery.HitResults);
+	return &CursorQuery;
 }
 
 void AAstroController::SelfToggleFocusInputBlock(const bool bBlock)
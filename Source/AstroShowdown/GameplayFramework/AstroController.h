@@ -20,6 +20,31 @@ class UAstroDashAimComponent;
 class UAstroThrowAimComponent;
 class UAstroTimeDilationSubsystem;
 
+/**
+* Caches every cursor query made by the controller during a single frame.
+* The cursor is deprojected once per frame, and each query profile (channel or object types + trace complexity) is traced at most once.
+*/
+struct FAstroCursorQueryCache
+{
+	struct FCachedCursorQuery
+	{
+		TArray<FHitResult> HitResults;
+		bool bHit = false;
+	};
+
+	TMap<uint64, FCachedCursorQuery> CachedQueries;
+
+	FVector RayOrigin = FVector::ZeroVector;
+	FVector RayDirection = FVector::ForwardVector;
+	FVector2D ScreenPosition = FVector2D::ZeroVector;
+	uint64 CachedFrame = 0;
+	uint8 bHasCursorRay : 1 = false;
+
+	/** How many cursor queries were requested and traced this frame. */
+	int32 RequestCount = 0;
+	int32 TraceCount = 0;
+};
+
 UCLASS()
 class ASTROSHOWDOWN_API AAstroController : public ACommonPlayerController
 {
@@ -99,12 +124,30 @@ private:
 	void UnGrantAllInputs();
 
 public:
-	/** Same as APlayerController::GetHitResultUnderCursorForObjects, but returns multiple hits. */
+	/**
+	* Same as APlayerController::GetHitResultUnderCursorForObjects, but returns multiple hits.
+	* NOTE: Results are cached for the current frame, so repeated queries with the same profile don't trace again.
+	*/
 	bool GetHitResultsUnderCursorForObjects(const TArray<TEnumAsByte<EObjectTypeQuery> >& ObjectTypes, bool bTraceComplex, OUT TArray<FHitResult>& HitResults) const;
 
+	/** Same as APlayerController::GetHitResultUnderCursorByChannel, but cached for the current frame. */
+	bool GetCachedHitResultUnderCursorByChannel(ETraceTypeQuery TraceChannel, bool bTraceComplex, OUT FHitResult& HitResult) const;
+
+	/** Same as APlayerController::DeprojectMousePositionToWorld, but cached for the current frame. */
+	bool GetCachedCursorRay(OUT FVector& WorldOrigin, OUT FVector& WorldDirection) const;
+
+	/** @return How many cursor queries were requested this frame, and how many of them actually traced. */
+	int32 GetCursorQueryRequestCount() const;
+	int32 GetCursorQueryTraceCount() const;
+
 private:
-	/** Same as APlayerController::GetHitResultAtScreenPosition, but returns multiple hits. */
-	bool GetHitResultsAtScreenPosition(const FVector2D ScreenPosition, const TArray<TEnumAsByte<EObjectTypeQuery> >& ObjectTypes, bool bTraceComplex, OUT TArray<FHitResult>& HitResults) const;
+	/** Resets the cursor query cache if it's from a previous frame, and deprojects the cursor. */
+	void RefreshCursorQueryCache() const;
+
+	/** Runs a cursor trace, or returns its cached result. TraceFn is only called on cache misses. */
+	const FAstroCursorQueryCache::FCachedCursorQuery* FindOrRunCursorQuery(const uint64 QueryKey, TFunctionRef<bool(const FVector&, const FVector&, TArray<FHitResult>&)> TraceFn) const;
+
+	mutable FAstroCursorQueryCache CursorQueryCache;
 
 private:
 	/** WORKAROUND: Prevents self-registering the focus input block multiple times. This should be replaced by an instigator mechanism on the input block code. */
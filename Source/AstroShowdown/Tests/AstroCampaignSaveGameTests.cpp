@@ -0,0 +1,234 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#include "AstroCampaignSaveGame.h"
+#include "AstroCampaignSaveGameLegacyFixture.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AstroCampaignSaveGameTestStatics
+{
+	struct FExpectedRoomProgress
+	{
+		const TCHAR* RoomName = nullptr;
+		FGuid RoomId;
+		bool bUnlocked = false;
+		bool bVisited = false;
+		bool bCompleted = false;
+	};
+
+	/** Checks every progress of every expected room, prefixing failures with Stage. */
+	static void TestRoomProgress(FAutomationTestBase& Test, const TCHAR* Stage, const UAstroCampaignSaveGame* SaveGame, const TArray<FExpectedRoomProgress>& ExpectedRooms)
+	{
+		for (const FExpectedRoomProgress& ExpectedRoom : ExpectedRooms)
+		{
+			Test.TestEqual(*FString::Printf(TEXT("%s: %s unlocked"), Stage, ExpectedRoom.RoomName),
+				SaveGame->HasRoomProgress(ExpectedRoom.RoomId, EAstroRoomProgress::Unlocked), ExpectedRoom.bUnlocked);
+			Test.TestEqual(*FString::Printf(TEXT("%s: %s visited"), Stage, ExpectedRoom.RoomName),
+				SaveGame->HasRoomProgress(ExpectedRoom.RoomId, EAstroRoomProgress::Visited), ExpectedRoom.bVisited);
+			Test.TestEqual(*FString::Printf(TEXT("%s: %s completed"), Stage, ExpectedRoom.RoomName),
+				SaveGame->HasRoomProgress(ExpectedRoom.RoomId, EAstroRoomProgress::Completed), ExpectedRoom.bCompleted);
+		}
+	}
+
+	/** Serializes the properties of a save game the same way UGameplayStatics::SaveGameToMemory does, without the save game header. */
+	static TArray<uint8> SerializeSaveGameProperties(USaveGame* SaveGame)
+	{
+		TArray<uint8> SaveData;
+		FMemoryWriter MemoryWriter(SaveData, true);
+		FObjectAndNameAsStringProxyArchive Archive(MemoryWriter, false);
+		SaveGame->Serialize(Archive);
+		return SaveData;
+	}
+
+	/**
+	* Writes the legacy fixture's properties after a UAstroCampaignSaveGame header, which is what SaveGameToMemory wrote before the save game was versioned.
+	* @return false if the header couldn't be extracted.
+	*/
+	static bool WriteLegacyCampaignSaveGame(FAutomationTestBase& Test, UAstroCampaignSaveGameLegacyFixture* LegacySaveGame, TArray<uint8>& OutSaveData)
+	{
+		// The header only depends on the save game class, so it's taken from an empty save game of the current class
+		UAstroCampaignSaveGame* HeaderSaveGame = NewObject<UAstroCampaignSaveGame>();
+		TArray<uint8> HeaderSaveData;
+		if (!Test.TestTrue(TEXT("Empty save game serialized to memory"), UGameplayStatics::SaveGameToMemory(HeaderSaveGame, HeaderSaveData)))
+		{
+			return false;
+		}
+
+		const TArray<uint8> HeaderSaveGameProperties = SerializeSaveGameProperties(HeaderSaveGame);
+		const int32 HeaderSize = HeaderSaveData.Num() - HeaderSaveGameProperties.Num();
+		if (!Test.TestTrue(TEXT("SaveGameToMemory writes the header followed by the save game properties"), HeaderSize > 0
+			&& FMemory::Memcmp(HeaderSaveData.GetData() + HeaderSize, HeaderSaveGameProperties.GetData(), HeaderSaveGameProperties.Num()) == 0))
+		{
+			return false;
+		}
+
+		OutSaveData.Reset();
+		OutSaveData.Append(HeaderSaveData.GetData(), HeaderSize);
+		OutSaveData.Append(SerializeSaveGameProperties(LegacySaveGame));
+		return true;
+	}
+}
+
+/**
+* Upgrades a RoomGuidArrays save game to the latest version, round-trips it through the save game serializer,
+* and re-syncs it against a campaign that was reordered and shrunk, checking that room progress is never lost along the way.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAstroCampaignSaveGameUpgradeTest, "AstroShowdown.CampaignSaveGame.UpgradeAndRoundTrip",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FAstroCampaignSaveGameUpgradeTest::RunTest(const FString& Parameters)
+{
+	using namespace AstroCampaignSaveGameTestStatics;
+
+	const FGuid RoomA = FGuid::NewGuid();
+	const FGuid RoomB = FGuid::NewGuid();
+	const FGuid RoomC = FGuid::NewGuid();
+	// NOTE: Room D was removed from the campaign before the upgrade, so it's orphaned from the very first sync
+	const FGuid RoomD = FGuid::NewGuid();
+
+	UAstroCampaignSaveGame* LegacySaveGame = CastChecked<UAstroCampaignSaveGame>(UGameplayStatics::CreateSaveGameObject(UAstroCampaignSaveGame::StaticClass()));
+	LegacySaveGame->Version = static_cast<int32>(EAstroCampaignSaveGameVersion::RoomGuidArrays);
+	LegacySaveGame->UnlockedRooms_DEPRECATED = { RoomA, RoomB, RoomD };
+	LegacySaveGame->VisitedRooms_DEPRECATED = { RoomA, RoomB, RoomD };
+	LegacySaveGame->CompletedRooms_DEPRECATED = { RoomA, RoomD };
+
+	const TArray<FExpectedRoomProgress> ExpectedRooms =
+	{
+		{ TEXT("Room A"), RoomA, true, true, true },
+		{ TEXT("Room B"), RoomB, true, true, false },
+		{ TEXT("Room C"), RoomC, false, false, false },
+		{ TEXT("Room D"), RoomD, true, true, true },
+	};
+
+	// Upgrade
+	LegacySaveGame->SyncRoomTable({ RoomA, RoomB, RoomC });
+	TestEqual(TEXT("Version after the upgrade"), LegacySaveGame->GetVersion(), static_cast<int32>(EAstroCampaignSaveGameVersion::Latest));
+	TestTrue(TEXT("Legacy arrays are emptied by the upgrade"),
+		LegacySaveGame->UnlockedRooms_DEPRECATED.IsEmpty() && LegacySaveGame->VisitedRooms_DEPRECATED.IsEmpty() && LegacySaveGame->CompletedRooms_DEPRECATED.IsEmpty());
+	TestRoomProgress(*this, TEXT("Upgrade"), LegacySaveGame, ExpectedRooms);
+	TestTrue(TEXT("Upgrade: unlocked rooms follow the campaign order, then orphans"),
+		LegacySaveGame->GetRoomsWithProgress(EAstroRoomProgress::Unlocked) == TArray<FGuid>({ RoomA, RoomB, RoomD }));
+
+	// Round trip
+	TArray<uint8> SaveGameBytes;
+	if (!TestTrue(TEXT("Save game serialized to memory"), UGameplayStatics::SaveGameToMemory(LegacySaveGame, SaveGameBytes)))
+	{
+		return false;
+	}
+
+	UAstroCampaignSaveGame* LoadedSaveGame = Cast<UAstroCampaignSaveGame>(UGameplayStatics::LoadGameFromMemory(SaveGameBytes));
+	if (!TestNotNull(TEXT("Save game loaded from memory"), LoadedSaveGame))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("Version after the round trip"), LoadedSaveGame->GetVersion(), static_cast<int32>(EAstroCampaignSaveGameVersion::Latest));
+	TestTrue(TEXT("Room table after the round trip"), LoadedSaveGame->RoomIds == LegacySaveGame->RoomIds);
+	TestRoomProgress(*this, TEXT("Round trip"), LoadedSaveGame, ExpectedRooms);
+
+	// Re-sync against a reordered campaign that dropped room A
+	LoadedSaveGame->SyncRoomTable({ RoomC, RoomB });
+	TestRoomProgress(*this, TEXT("Re-sync"), LoadedSaveGame, ExpectedRooms);
+	TestTrue(TEXT("Re-sync: unlocked rooms follow the new campaign order, then orphans"),
+		LoadedSaveGame->GetRoomsWithProgress(EAstroRoomProgress::Unlocked) == TArray<FGuid>({ RoomB, RoomA, RoomD }));
+
+	// Duplicate and invalid campaign room IDs never get a bit, so the table still matches the campaign
+	LoadedSaveGame->SyncRoomTable({ RoomC, RoomB, RoomC, FGuid() });
+	TestTrue(TEXT("Duplicates: room table"), LoadedSaveGame->RoomIds == TArray<FGuid>({ RoomC, RoomB, RoomA, RoomD }));
+	TestFalse(TEXT("Duplicates: invalid room IDs can't get progress"), LoadedSaveGame->AddRoomProgress(FGuid(), EAstroRoomProgress::Unlocked));
+	TestFalse(TEXT("Duplicates: invalid room IDs have no progress"), LoadedSaveGame->HasRoomProgress(FGuid(), EAstroRoomProgress::Unlocked));
+
+	// Progress added after the re-sync lands on the campaign room's remapped bit
+	TestTrue(TEXT("Re-sync: room C can be unlocked"), LoadedSaveGame->AddRoomProgress(RoomC, EAstroRoomProgress::Unlocked));
+	TestTrue(TEXT("Re-sync: room C is unlocked"), LoadedSaveGame->HasRoomProgress(RoomC, EAstroRoomProgress::Unlocked));
+	TestFalse(TEXT("Re-sync: room C isn't visited"), LoadedSaveGame->HasRoomProgress(RoomC, EAstroRoomProgress::Visited));
+
+	return true;
+}
+
+/**
+* Loads a save game written with the property names used before versioning (UnlockedRooms, VisitedRooms and CompletedRooms),
+* and checks that its progress ends up in the *_DEPRECATED properties, survives the upgrade, and is saved again in the new format only.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAstroCampaignSaveGameLegacyLoadTest, "AstroShowdown.CampaignSaveGame.LoadLegacyFormat",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FAstroCampaignSaveGameLegacyLoadTest::RunTest(const FString& Parameters)
+{
+	using namespace AstroCampaignSaveGameTestStatics;
+
+	const FGuid RoomA = FGuid::NewGuid();
+	const FGuid RoomB = FGuid::NewGuid();
+	const FGuid RoomC = FGuid::NewGuid();
+
+	UAstroCampaignSaveGameLegacyFixture* LegacySaveGame = NewObject<UAstroCampaignSaveGameLegacyFixture>();
+	LegacySaveGame->UnlockedRooms = { RoomA, RoomB };
+	LegacySaveGame->VisitedRooms = { RoomA, RoomB };
+	LegacySaveGame->CompletedRooms = { RoomA };
+	LegacySaveGame->LastVisitedRoomId = RoomB;
+	LegacySaveGame->DisplayedHints = { 2 };
+
+	TArray<uint8> LegacySaveData;
+	if (!WriteLegacyCampaignSaveGame(*this, LegacySaveGame, LegacySaveData))
+	{
+		return false;
+	}
+
+	UAstroCampaignSaveGame* LoadedSaveGame = Cast<UAstroCampaignSaveGame>(UGameplayStatics::LoadGameFromMemory(LegacySaveData));
+	if (!TestNotNull(TEXT("Legacy save game loaded from memory"), LoadedSaveGame))
+	{
+		return false;
+	}
+
+	const TArray<FExpectedRoomProgress> ExpectedRooms =
+	{
+		{ TEXT("Room A"), RoomA, true, true, true },
+		{ TEXT("Room B"), RoomB, true, true, false },
+		{ TEXT("Room C"), RoomC, false, false, false },
+	};
+
+	// Legacy load
+	TestEqual(TEXT("Legacy save games load as RoomGuidArrays"), LoadedSaveGame->GetVersion(), static_cast<int32>(EAstroCampaignSaveGameVersion::RoomGuidArrays));
+	TestTrue(TEXT("Legacy unlocked rooms load into UnlockedRooms_DEPRECATED"), LoadedSaveGame->UnlockedRooms_DEPRECATED == LegacySaveGame->UnlockedRooms);
+	TestTrue(TEXT("Legacy visited rooms load into VisitedRooms_DEPRECATED"), LoadedSaveGame->VisitedRooms_DEPRECATED == LegacySaveGame->VisitedRooms);
+	TestTrue(TEXT("Legacy completed rooms load into CompletedRooms_DEPRECATED"), LoadedSaveGame->CompletedRooms_DEPRECATED == LegacySaveGame->CompletedRooms);
+	TestTrue(TEXT("Last visited room"), LoadedSaveGame->LastVisitedRoomId == RoomB);
+	TestTrue(TEXT("Displayed hints"), LoadedSaveGame->DisplayedHints == LegacySaveGame->DisplayedHints);
+
+	// Upgrade
+	LoadedSaveGame->SyncRoomTable({ RoomA, RoomB, RoomC });
+	TestEqual(TEXT("Version after the upgrade"), LoadedSaveGame->GetVersion(), static_cast<int32>(EAstroCampaignSaveGameVersion::Latest));
+	TestRoomProgress(*this, TEXT("Upgrade"), LoadedSaveGame, ExpectedRooms);
+
+	// Saved again, in the new format only
+	TArray<uint8> UpgradedSaveData;
+	if (!TestTrue(TEXT("Upgraded save game serialized to memory"), UGameplayStatics::SaveGameToMemory(LoadedSaveGame, UpgradedSaveData)))
+	{
+		return false;
+	}
+
+	UAstroCampaignSaveGame* UpgradedSaveGame = Cast<UAstroCampaignSaveGame>(UGameplayStatics::LoadGameFromMemory(UpgradedSaveData));
+	if (!TestNotNull(TEXT("Upgraded save game loaded from memory"), UpgradedSaveGame))
+	{
+		return false;
+	}
+
+	TestEqual(TEXT("Version after the round trip"), UpgradedSaveGame->GetVersion(), static_cast<int32>(EAstroCampaignSaveGameVersion::Latest));
+	TestTrue(TEXT("Legacy arrays aren't saved anymore"),
+		UpgradedSaveGame->UnlockedRooms_DEPRECATED.IsEmpty() && UpgradedSaveGame->VisitedRooms_DEPRECATED.IsEmpty() && UpgradedSaveGame->CompletedRooms_DEPRECATED.IsEmpty());
+	TestRoomProgress(*this, TEXT("Round trip"), UpgradedSaveGame, ExpectedRooms);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,110 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#include "AstroTimeDilationSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AstroTimeDilationTestStatics
+{
+	constexpr float FrameDeltaSeconds = 1.f / 60.f;
+	constexpr float ProjectileSpeed = 1000.f;
+	constexpr float TargetTimeDilation = 0.25f;
+	constexpr int32 FramesBeforeTimeDilation = 10;
+	constexpr int32 FramesAfterTimeDilation = 20;
+	constexpr double DisplacementTolerance = 0.01;
+
+	/** Spawns an actor that moves along +X at ProjectileSpeed, without gravity or collision. */
+	static UProjectileMovementComponent* SpawnProjectile(UWorld* World)
+	{
+		AActor* ProjectileActor = World->SpawnActor<AActor>();
+		USceneComponent* ProjectileRoot = NewObject<USceneComponent>(ProjectileActor);
+		ProjectileActor->SetRootComponent(ProjectileRoot);
+		ProjectileRoot->RegisterComponent();
+
+		UProjectileMovementComponent* ProjectileMovement = NewObject<UProjectileMovementComponent>(ProjectileActor);
+		ProjectileMovement->ProjectileGravityScale = 0.f;
+		ProjectileMovement->SetUpdatedComponent(ProjectileRoot);
+		ProjectileMovement->RegisterComponent();
+		ProjectileMovement->Velocity = FVector(ProjectileSpeed, 0.f, 0.f);
+		return ProjectileMovement;
+	}
+
+	static double GetProjectileX(const UProjectileMovementComponent* ProjectileMovement)
+	{
+		return ProjectileMovement->UpdatedComponent->GetComponentLocation().X;
+	}
+}
+
+/**
+* Steps a projectile through a global time dilation change, and checks that the change is picked up by the very first frame after it was requested.
+* An actor that ignores time dilation must keep moving at its undilated speed on that same frame.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAstroTimeDilationWorldTickStartTest, "AstroShowdown.TimeDilation.AppliedAtWorldTickStart",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FAstroTimeDilationWorldTickStartTest::RunTest(const FString& Parameters)
+{
+	using namespace AstroTimeDilationTestStatics;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	UAstroTimeDilationSubsystem* TimeDilationSubsystem = World->GetSubsystem<UAstroTimeDilationSubsystem>();
+	if (TestNotNull(TEXT("Time dilation subsystem"), TimeDilationSubsystem))
+	{
+		UProjectileMovementComponent* DilatedProjectile = SpawnProjectile(World);
+		UProjectileMovementComponent* IgnoredProjectile = SpawnProjectile(World);
+		TimeDilationSubsystem->RegisterIgnoreTimeDilation(IgnoredProjectile->GetOwner());
+
+		const double DilatedStartX = GetProjectileX(DilatedProjectile);
+		const double IgnoredStartX = GetProjectileX(IgnoredProjectile);
+
+		for (int32 FrameIndex = 0; FrameIndex < FramesBeforeTimeDilation; FrameIndex++)
+		{
+			World->Tick(LEVELTICK_All, FrameDeltaSeconds);
+		}
+
+		// NOTE: Requested between frames, like gameplay code does. The next world tick must already run fully dilated.
+		TimeDilationSubsystem->SetGlobalTimeDilation(TargetTimeDilation);
+
+		const double DilatedXBeforeChange = GetProjectileX(DilatedProjectile);
+		const double IgnoredXBeforeChange = GetProjectileX(IgnoredProjectile);
+		World->Tick(LEVELTICK_All, FrameDeltaSeconds);
+
+		TestEqual(TEXT("Global time dilation after the first dilated frame"), UAstroTimeDilationSubsystem::GetGlobalTimeDilation(World), TargetTimeDilation);
+		TestEqual(TEXT("Dilated projectile displacement on the first dilated frame"),
+			GetProjectileX(DilatedProjectile) - DilatedXBeforeChange, static_cast<double>(ProjectileSpeed * FrameDeltaSeconds * TargetTimeDilation), DisplacementTolerance);
+		TestEqual(TEXT("Ignored projectile displacement on the first dilated frame"),
+			GetProjectileX(IgnoredProjectile) - IgnoredXBeforeChange, static_cast<double>(ProjectileSpeed * FrameDeltaSeconds), DisplacementTolerance);
+
+		for (int32 FrameIndex = 1; FrameIndex < FramesAfterTimeDilation; FrameIndex++)
+		{
+			World->Tick(LEVELTICK_All, FrameDeltaSeconds);
+		}
+
+		const double ExpectedDilatedDisplacement = ProjectileSpeed * FrameDeltaSeconds * (FramesBeforeTimeDilation + FramesAfterTimeDilation * TargetTimeDilation);
+		const double ExpectedIgnoredDisplacement = ProjectileSpeed * FrameDeltaSeconds * (FramesBeforeTimeDilation + FramesAfterTimeDilation);
+		TestEqual(TEXT("Dilated projectile total displacement"), GetProjectileX(DilatedProjectile) - DilatedStartX, ExpectedDilatedDisplacement, DisplacementTolerance);
+		TestEqual(TEXT("Ignored projectile total displacement"), GetProjectileX(IgnoredProjectile) - IgnoredStartX, ExpectedIgnoredDisplacement, DisplacementTolerance);
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -49,11 +49,17 @@ void UAstroIndicatorWidget::SetIndicatorReviveProgress(const float InReviveProgr
 
 void UAstroIndicatorWidget::SetIndicatorIcon(UTexture2D* Icon)
 {
-	if (Icon && IndicatorPortrait)
+	if (IndicatorPortrait)
 	{
 		if (UMaterialInstanceDynamic* DynamicMaterial = IndicatorPortrait->GetDynamicMaterial())
 		{
-			DynamicMaterial->SetTextureParameterValue(AstroIndicatorWidgetStatics::PortraitParameterName, Icon);
+			// Without an icon, falls back to the portrait material's default texture
+			UTexture* PortraitTexture = Icon;
+			if (!PortraitTexture && DynamicMaterial->Parent)
+			{
+				DynamicMaterial->Parent->GetTextureParameterValue(FMaterialParameterInfo(AstroIndicatorWidgetStatics::PortraitParameterName), OUT PortraitTexture);
+			}
+			DynamicMaterial->SetTextureParameterValue(AstroIndicatorWidgetStatics::PortraitParameterName, PortraitTexture);
 		}
 	}
 }
@@ -23,6 +23,7 @@ public:
 	void SetIndicatorAngle(const float InAngle);
 	void SetIndicatorDistance(float InDistance);
 	void SetIndicatorReviveProgress(const float InReviveProgress);
+	/** Sets the portrait texture. A null Icon restores the portrait material's default texture. */
 	void SetIndicatorIcon(UTexture2D* Icon);
 	void SetIndicatorDead(bool bIsDead);
 	void SetIndicatorOwnerBeingRendered(const bool bInIsOwnerBeingRendered);
@@ -19,11 +19,23 @@
 #include "Components/CanvasPanel.h"
 #include "Components/CanvasPanelSlot.h"
 #include "Components/MeshComponent.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "HealthAttributeSet.h"
 #include "PrimaryGameLayout.h"
+#include "SceneView.h"
 #include "SubsystemUtils.h"
 
+namespace AstroIndicatorWidgetManagerStatics
+{
+	// Minimum change required before a value is pushed to the indicator widget
+	static constexpr float PositionUpdateDistSqrThreshold = 1.f;
+	static constexpr float AngleUpdateThreshold = 0.5f;
+	static constexpr float DistanceUpdateThreshold = 0.5f;
+	static constexpr float ReviveProgressUpdateThreshold = 0.001f;
+}
+
 UAstroIndicatorWidgetManagerComponent::UAstroIndicatorWidgetManagerComponent(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
 	PrimaryComponentTick.bCanEverTick = true;
@@ -67,6 +79,7 @@ void UAstroIndicatorWidgetManagerComponent::EndPlay(const EEndPlayReason::Type E
 	}
 
 	RemoveAllIndicators();
+	EmptyWidgetPools();
 
 	// Stops listening to indicator register/unregister requests
 	UGameplayMessageSubsystem::Get(this).UnregisterListener(RegisterRequestMessageHandle);
@@ -84,18 +97,21 @@ void UAstroIndicatorWidgetManagerComponent::TickComponent(float DeltaTime, ELeve
 		return;
 	}
 
-	// Reverse iterates indicators, removing invalids, and updating the visibility of valids
-	const FVector2D ViewportSize = UWidgetLayoutLibrary::GetViewportSize(this);
+	// Reverse iterates indicators, removing invalids
 	for (int32 Index = Indicators.Num() - 1; Index >= 0; Index--)
 	{
-		FNPCIndicatorData& Indicator = Indicators[Index];
+		const FNPCIndicatorData& Indicator = Indicators[Index];
 		if (!Indicator.Owner.IsValid() || !Indicator.Widget.IsValid() || Indicator.Owner->IsHidden())
 		{
 			RemoveIndicatorAt(Index);
-			continue;
 		}
+	}
 
-		FVector IndicatorOwnerWorldPosition = Indicator.Owner->GetActorLocation() + Indicator.OwnerPositionOffset;
+	// Gathers the world positions of all valid indicators
+	IndicatorWorldPositions.Reset(Indicators.Num());
+	for (const FNPCIndicatorData& Indicator : Indicators)
+	{
+		FVector& IndicatorOwnerWorldPosition = IndicatorWorldPositions.Add_GetRef(Indicator.Owner->GetActorLocation() + Indicator.OwnerPositionOffset);
 
 		// Overrides the owner's position with a socket's position if one was specified
 		if (!Indicator.SocketName.IsNone())
@@ -105,65 +121,140 @@ void UAstroIndicatorWidgetManagerComponent::TickComponent(float DeltaTime, ELeve
 				IndicatorOwnerWorldPosition = Indicator.CachedOwnerMeshComponent->GetSocketLocation(Indicator.SocketName);
 			}
 		}
+	}
 
-		FVector2D OwnerScreenLocation;
-		constexpr bool bPlayerViewportRelative = true;		// Ensures that the calculation will work in all aspect ratios
-		UWidgetLayoutLibrary::ProjectWorldLocationToWidgetPosition(LocalPlayerController, IndicatorOwnerWorldPosition, OUT OwnerScreenLocation, bPlayerViewportRelative);
-		const FVector2D ClampedOwnerScreenLocation = FVector2D::Clamp(OwnerScreenLocation, FVector2D::ZeroVector, ViewportSize);
-
-		// We consider the widget to be visible if the enemy's screen location is out of the [0, ViewportSize] bounds.
-		// NOTE: We can't use Owner->WasRecentlyRendered here because the owner's LastRenderTime is being updated on the shadow pass
-		// even when objects are offscreen. We should investigate this though, and revisit later.
-		bool bIsWidgetVisible = true;
-		const bool bIsOwnerBeingRendered = OwnerScreenLocation == ClampedOwnerScreenLocation;
-		if (Indicator.bOffscreenActorOnly)
+	// Projects all indicators at once
+	if (!ProjectIndicatorPositions(LocalPlayerController))
+	{
+		return;
+	}
+
+	// Updates the visibility of all indicators
+	const FVector2D ViewportSize = UWidgetLayoutLibrary::GetViewportSize(this);
+	for (int32 Index = 0; Index < Indicators.Num(); Index++)
+	{
+		UpdateIndicatorWidget(Indicators[Index], IndicatorScreenPositions[Index], ViewportSize);
+	}
+}
+
+bool UAstroIndicatorWidgetManagerComponent::ProjectIndicatorPositions(APlayerController* LocalPlayerController)
+{
+	IndicatorScreenPositions.Reset(IndicatorWorldPositions.Num());
+
+	// NOTE: This mirrors what UWidgetLayoutLibrary::ProjectWorldLocationToWidgetPosition does, but it only computes the view projection matrix
+	// and the viewport scale once, instead of doing it for every indicator.
+	const ULocalPlayer* LocalPlayer = LocalPlayerController->GetLocalPlayer();
+	FSceneViewProjectionData ProjectionData;
+	if (!LocalPlayer || !LocalPlayer->ViewportClient || !LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, OUT ProjectionData))
+	{
+		return false;
+	}
+
+	const FMatrix ViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+	const FIntRect ViewRect = ProjectionData.GetConstrainedViewRect();
+	const float ViewportScale = UWidgetLayoutLibrary::GetViewportScale(LocalPlayerController);
+	const float InverseViewportScale = ViewportScale > 0.f ? 1.f / ViewportScale : 1.f;
+
+	for (const FVector& IndicatorWorldPosition : IndicatorWorldPositions)
+	{
+		FVector2D& IndicatorScreenPosition = IndicatorScreenPositions.Add_GetRef(FVector2D::ZeroVector);
+
+		FVector2D PixelPosition;
+		if (FSceneView::ProjectWorldToScreen(IndicatorWorldPosition, ViewRect, ViewProjectionMatrix, OUT PixelPosition))
 		{
-			bIsWidgetVisible = !bIsOwnerBeingRendered;
+			// Makes the position relative to the player's viewport, which ensures that the calculation will work in all aspect ratios.
+			// The pixel position is rounded to reduce jittering due to layout rounding, just like the widget layout library does.
+			PixelPosition -= FVector2D(ViewRect.Min);
+			PixelPosition.X = FMath::RoundToDouble(PixelPosition.X);
+			PixelPosition.Y = FMath::RoundToDouble(PixelPosition.Y);
+			IndicatorScreenPosition = PixelPosition * InverseViewportScale;
 		}
+	}
 
-		const ESlateVisibility NewWidgetVisibility = bIsWidgetVisible ? ESlateVisibility::HitTestInvisible : ESlateVisibility::Collapsed;
-		Indicator.Widget->SetVisibility(NewWidgetVisibility);
+	return true;
+}
 
-		// If the indicator is visible, its position is updated
-		if (bIsWidgetVisible)
-		{
-			const FVector2D ViewportPadding = Indicator.Widget->GetDesiredSize() * 0.5f;
-			const FVector2D OriginPadding = ViewportPadding;
-			const FVector2D PaddedViewportSize = ViewportSize - ViewportPadding;
-			const FVector2D PaddedOwnerScreenLocation = FVector2D::Clamp(OwnerScreenLocation, OriginPadding, PaddedViewportSize);
-			const FVector2D ToWidgetOrigin = (OwnerScreenLocation - PaddedOwnerScreenLocation);
-			const FVector2D WidgetDirection = ToWidgetOrigin.GetSafeNormal();
-			const UHealthAttributeSet* HealthAttributeSet = Indicator.CachedOwnerHealthAttributeSet.Get();
-
-			const float Angle = FMath::Atan2(WidgetDirection.Y, WidgetDirection.X);
-			const float Distance = ToWidgetOrigin.Length();
-			const float ReviveProgress = HealthAttributeSet ? HealthAttributeSet->GetReviveCounter() / HealthAttributeSet->GetReviveDuration() : 0.f;
-			const bool bNewDead = HealthAttributeSet ? HealthAttributeSet->GetCurrentHealth() == 0.f : false;
-			Indicator.Widget->SetIndicatorAngle(bIsOwnerBeingRendered ? 0.f : FMath::RadiansToDegrees(Angle));
-			Indicator.Widget->SetIndicatorDistance(Distance);
-			Indicator.Widget->SetIndicatorReviveProgress(ReviveProgress);
-			Indicator.Widget->SetIndicatorOwnerBeingRendered(bIsOwnerBeingRendered);
-
-			// Only sets IndicatorDead if it's changed
-			if (bNewDead != Indicator.bDead)
-			{
-				Indicator.Widget->SetIndicatorDead(bNewDead);
-				Indicator.bDead = bNewDead;
-			}
+void UAstroIndicatorWidgetManagerComponent::UpdateIndicatorWidget(FNPCIndicatorData& Indicator, const FVector2D& OwnerScreenLocation, const FVector2D& ViewportSize)
+{
+	UAstroIndicatorWidget* IndicatorWidget = Indicator.Widget.Get();
+	const FVector2D ClampedOwnerScreenLocation = FVector2D::Clamp(OwnerScreenLocation, FVector2D::ZeroVector, ViewportSize);
+
+	// We consider the widget to be visible if the enemy's screen location is out of the [0, ViewportSize] bounds.
+	// NOTE: We can't use Owner->WasRecentlyRendered here because the owner's LastRenderTime is being updated on the shadow pass
+	// even when objects are offscreen. We should investigate this though, and revisit later.
+	bool bIsWidgetVisible = true;
+	const bool bIsOwnerBeingRendered = OwnerScreenLocation == ClampedOwnerScreenLocation;
+	if (Indicator.bOffscreenActorOnly)
+	{
+		bIsWidgetVisible = !bIsOwnerBeingRendered;
+	}
 
-			// Updates the indicator's position
-			constexpr float PositionUpdateDistSqrThreshold = 1.f;
-			if (FVector2D::DistSquared(PaddedOwnerScreenLocation, Indicator.PreviousPosition) > PositionUpdateDistSqrThreshold)
-			{
-				// Assumes the widget is attached to a canvas panel
-				if (UCanvasPanelSlot* PanelSlot = UWidgetLayoutLibrary::SlotAsCanvasSlot(Indicator.Widget.Get()))
-				{
-					PanelSlot->SetPosition(PaddedOwnerScreenLocation);
-					Indicator.PreviousPosition = PaddedOwnerScreenLocation;
-				}
-			}
+	const ESlateVisibility NewWidgetVisibility = bIsWidgetVisible ? ESlateVisibility::HitTestInvisible : ESlateVisibility::Collapsed;
+	if (Indicator.bForceUpdate || NewWidgetVisibility != Indicator.PreviousVisibility)
+	{
+		IndicatorWidget->SetVisibility(NewWidgetVisibility);
+		Indicator.PreviousVisibility = NewWidgetVisibility;
+	}
+
+	// Hidden indicators are not updated. Their values will be pushed once they become visible again.
+	if (!bIsWidgetVisible)
+	{
+		return;
+	}
+
+	const FVector2D ViewportPadding = IndicatorWidget->GetDesiredSize() * 0.5f;
+	const FVector2D OriginPadding = ViewportPadding;
+	const FVector2D PaddedViewportSize = ViewportSize - ViewportPadding;
+	const FVector2D PaddedOwnerScreenLocation = FVector2D::Clamp(OwnerScreenLocation, OriginPadding, PaddedViewportSize);
+	const FVector2D ToWidgetOrigin = (OwnerScreenLocation - PaddedOwnerScreenLocation);
+	const FVector2D WidgetDirection = ToWidgetOrigin.GetSafeNormal();
+	const UHealthAttributeSet* HealthAttributeSet = Indicator.CachedOwnerHealthAttributeSet.Get();
+
+	const float Angle = bIsOwnerBeingRendered ? 0.f : FMath::RadiansToDegrees(FMath::Atan2(WidgetDirection.Y, WidgetDirection.X));
+	const float Distance = ToWidgetOrigin.Length();
+	const float ReviveProgress = HealthAttributeSet ? HealthAttributeSet->GetReviveCounter() / HealthAttributeSet->GetReviveDuration() : 0.f;
+	const bool bNewDead = HealthAttributeSet ? HealthAttributeSet->GetCurrentHealth() == 0.f : false;
+
+	if (Indicator.bForceUpdate || !FMath::IsNearlyEqual(Angle, Indicator.PreviousAngle, AstroIndicatorWidgetManagerStatics::AngleUpdateThreshold))
+	{
+		IndicatorWidget->SetIndicatorAngle(Angle);
+		Indicator.PreviousAngle = Angle;
+	}
+
+	if (Indicator.bForceUpdate || !FMath::IsNearlyEqual(Distance, Indicator.PreviousDistance, AstroIndicatorWidgetManagerStatics::DistanceUpdateThreshold))
+	{
+		IndicatorWidget->SetIndicatorDistance(Distance);
+		Indicator.PreviousDistance = Distance;
+	}
+
+	if (Indicator.bForceUpdate || !FMath::IsNearlyEqual(ReviveProgress, Indicator.PreviousReviveProgress, AstroIndicatorWidgetManagerStatics::ReviveProgressUpdateThreshold))
+	{
+		IndicatorWidget->SetIndicatorReviveProgress(ReviveProgress);
+		Indicator.PreviousReviveProgress = ReviveProgress;
+	}
+
+	// NOTE: The widget already early-outs if this didn't change
+	IndicatorWidget->SetIndicatorOwnerBeingRendered(bIsOwnerBeingRendered);
+
+	// Only sets IndicatorDead if it's changed
+	if (Indicator.bForceUpdate || bNewDead != Indicator.bDead)
+	{
+		IndicatorWidget->SetIndicatorDead(bNewDead);
+		Indicator.bDead = bNewDead;
+	}
+
+	// Updates the indicator's position
+	if (Indicator.bForceUpdate || FVector2D::DistSquared(PaddedOwnerScreenLocation, Indicator.PreviousPosition) > AstroIndicatorWidgetManagerStatics::PositionUpdateDistSqrThreshold)
+	{
+		// Assumes the widget is attached to a canvas panel
+		if (UCanvasPanelSlot* PanelSlot = UWidgetLayoutLibrary::SlotAsCanvasSlot(IndicatorWidget))
+		{
+			PanelSlot->SetPosition(PaddedOwnerScreenLocation);
+			Indicator.PreviousPosition = PaddedOwnerScreenLocation;
 		}
 	}
+
+	Indicator.bForceUpdate = false;
 }
 
 void UAstroIndicatorWidgetManagerComponent::RegisterActorIndicator(const FAstroIndicatorWidgetSettings& IndicatorSettings)
@@ -197,6 +288,13 @@ void UAstroIndicatorWidgetManagerComponent::CreateIndicatorFor(const FAstroIndic
 				TSoftClassPtr<UAstroIndicatorWidget> IndicatorClass = IndicatorSettings.bUseEnemyIndicator ? EnemyIndicatorWidgetClass : IndicatorWidgetClass;
 				IndicatorClass = IndicatorSettings.IndicatorWidgetClassOverride.GetAssetName().IsEmpty() ? IndicatorClass : IndicatorSettings.IndicatorWidgetClassOverride;
 
+				// Reuses a pooled widget if there's one available. Pooled widgets can only exist if the class is already loaded.
+				if (UAstroIndicatorWidget* PooledWidget = AcquirePooledWidget(IndicatorClass.Get()))
+				{
+					AddIndicator(PooledWidget, IndicatorSettings);
+					return;
+				}
+
 				// Spawns the indicator widget asynchronously
 				constexpr bool bSuspendInputUntilComplete = false;
 				UAsyncAction_CreateWidgetAsync* CreateWidgetAsyncAction = UAsyncAction_CreateWidgetAsync::CreateWidgetAsync(this, IndicatorClass, LocalPlayerController, bSuspendInputUntilComplete);
@@ -211,10 +309,9 @@ void UAstroIndicatorWidgetManagerComponent::RemoveIndicatorAt(const int32 Index)
 {
 	if (Indicators.IsValidIndex(Index))
 	{
-		// Destroys the widget and removes it from Indicators
-		Indicators[Index].Widget->SetVisibility(ESlateVisibility::Collapsed);
-		Indicators[Index].Widget->RemoveFromParent();
-		Indicators.RemoveAt(Index);
+		// Recycles the widget and removes it from Indicators
+		ReleaseWidget(Indicators[Index].Widget.Get());
+		Indicators.RemoveAtSwap(Index);
 	}
 }
 
@@ -222,10 +319,63 @@ void UAstroIndicatorWidgetManagerComponent::RemoveAllIndicators()
 {
 	while (!Indicators.IsEmpty())
 	{
-		RemoveIndicatorAt(0);
+		RemoveIndicatorAt(Indicators.Num() - 1);
+	}
+}
+
+UAstroIndicatorWidget* UAstroIndicatorWidgetManagerComponent::AcquirePooledWidget(TSubclassOf<UAstroIndicatorWidget> WidgetClass)
+{
+	FAstroIndicatorWidgetPool* WidgetPool = WidgetClass ? IndicatorWidgetPools.Find(WidgetClass) : nullptr;
+	while (WidgetPool && !WidgetPool->FreeWidgets.IsEmpty())
+	{
+		// NOTE: The widget may have been removed from the canvas by someone else (e.g., the layout being destroyed), in which case we discard it
+		UAstroIndicatorWidget* PooledWidget = WidgetPool->FreeWidgets.Pop(EAllowShrinking::No);
+		if (PooledWidget && PooledWidget->GetParent() == IndicatorRoot)
+		{
+			return PooledWidget;
+		}
+	}
+
+	return nullptr;
+}
+
+void UAstroIndicatorWidgetManagerComponent::ReleaseWidget(UAstroIndicatorWidget* Widget)
+{
+	if (!Widget)
+	{
+		return;
+	}
+
+	Widget->SetVisibility(ESlateVisibility::Collapsed);
+
+	// Keeps the widget attached to the canvas, so that reusing it doesn't need to create a new slot
+	FAstroIndicatorWidgetPool& WidgetPool = IndicatorWidgetPools.FindOrAdd(Widget->GetClass());
+	if (IndicatorRoot && Widget->GetParent() == IndicatorRoot && WidgetPool.FreeWidgets.Num() < MaxPooledIndicatorsPerClass)
+	{
+		WidgetPool.FreeWidgets.Push(Widget);
+	}
+	else
+	{
+		Widget->RemoveFromParent();
 	}
 }
 
+void UAstroIndicatorWidgetManagerComponent::EmptyWidgetPools()
+{
+	for (TPair<TSubclassOf<UAstroIndicatorWidget>, FAstroIndicatorWidgetPool>& WidgetPool : IndicatorWidgetPools)
+	{
+		for (UAstroIndicatorWidget* PooledWidget : WidgetPool.Value.FreeWidgets)
+		{
+			if (PooledWidget)
+			{
+				PooledWidget->RemoveFromParent();
+			}
+		}
+	}
+
+	IndicatorWidgetPools.Empty();
+}
+
 
 namespace AstroUtils
 {
@@ -279,20 +429,33 @@ namespace AstroUtils
 
 void UAstroIndicatorWidgetManagerComponent::OnIndicatorSpawned(UUserWidget* NewWidget, const FAstroIndicatorWidgetSettings IndicatorSettings)
 {
-	if (!NewWidget || !IndicatorRoot || !IndicatorSettings.Owner.IsValid())
+	UAstroIndicatorWidget* NewIndicatorWidget = Cast<UAstroIndicatorWidget>(NewWidget);
+	if (!NewIndicatorWidget || !IndicatorRoot)
 	{
-		NewWidget->RemoveFromRoot();
 		return;
 	}
 
-	NewWidget->SetVisibility(ESlateVisibility::Collapsed);
-	IndicatorRoot->AddChild(NewWidget);
+	NewIndicatorWidget->SetVisibility(ESlateVisibility::Collapsed);
+	IndicatorRoot->AddChild(NewIndicatorWidget);
+
+	// The owner may have been unregistered while the widget was being created, in which case we keep the widget for later
+	if (!IndicatorSettings.Owner.IsValid())
+	{
+		ReleaseWidget(NewIndicatorWidget);
+		return;
+	}
+
+	AddIndicator(NewIndicatorWidget, IndicatorSettings);
+}
 
+void UAstroIndicatorWidgetManagerComponent::AddIndicator(UAstroIndicatorWidget* Widget, const FAstroIndicatorWidgetSettings& IndicatorSettings)
+{
 	FNPCIndicatorData NPCIndicatorData;
 	NPCIndicatorData.Owner = IndicatorSettings.Owner;
-	NPCIndicatorData.Widget = Cast<UAstroIndicatorWidget>(NewWidget);
+	NPCIndicatorData.Widget = Widget;
 	NPCIndicatorData.CachedOwnerHealthAttributeSet = IndicatorSettings.bShouldCheckAliveState ? AstroUtils::Private::FindActorHealthAttributeSet(IndicatorSettings.Owner.Get()) : nullptr;
 	NPCIndicatorData.CachedOwnerMeshComponent = AstroUtils::Private::FindMeshComponentWithSocket(IndicatorSettings.Owner.Get(), IndicatorSettings.SocketName);
+	NPCIndicatorData.Icon = IndicatorSettings.Icon;
 	NPCIndicatorData.OwnerPositionOffset = IndicatorSettings.OwnerPositionOffset;
 	NPCIndicatorData.SocketName = IndicatorSettings.SocketName;
 	NPCIndicatorData.bOffscreenActorOnly = IndicatorSettings.bOffscreenActorOnly;
@@ -303,23 +466,33 @@ void UAstroIndicatorWidgetManagerComponent::OnIndicatorSpawned(UUserWidget* NewW
 		ensureMsgf(NPCIndicatorData.CachedOwnerMeshComponent.IsValid(), TEXT("Could not find MeshComponent with the specified SocketName"));
 	}
 
+	// Clears the icon of the widget's previous indicator, since widgets are recycled
+	Widget->SetIndicatorIcon(nullptr);
+
 	// Assigns indicator icon, OR loads it asynchronously if not loaded yet
 	const TSoftObjectPtr<UTexture2D> IndicatorIcon = IndicatorSettings.Icon;
 	if (IndicatorIcon.IsValid())
 	{
-		NPCIndicatorData.Widget->SetIndicatorIcon(IndicatorIcon.Get());
+		Widget->SetIndicatorIcon(IndicatorIcon.Get());
 	}
 	else if (const bool bHasIndicatorPath = !IndicatorIcon.GetAssetName().IsEmpty())
 	{
 		UAsyncAction_LoadTexture* LoadTextureAsyncAction = UAsyncAction_LoadTexture::LoadTexture(this, IndicatorIcon);
-		LoadTextureAsyncAction->OnCompleteDelegate.AddUObject(this, &UAstroIndicatorWidgetManagerComponent::OnIndicatorIconLoaded, NPCIndicatorData.Widget.Get());
+		LoadTextureAsyncAction->OnCompleteDelegate.AddUObject(this, &UAstroIndicatorWidgetManagerComponent::OnIndicatorIconLoaded, Widget);
 		LoadTextureAsyncAction->Activate();
 	}
 }
 
 void UAstroIndicatorWidgetManagerComponent::OnIndicatorIconLoaded(UTexture2D* IndicatorIcon, UAstroIndicatorWidget* Widget)
 {
-	if (Widget && IndicatorIcon)
+	if (!Widget || !IndicatorIcon)
+	{
+		return;
+	}
+
+	// Widgets are recycled, so by the time the icon is loaded, the widget may belong to an indicator that uses a different icon
+	const FNPCIndicatorData* Indicator = Indicators.FindByPredicate([Widget](const FNPCIndicatorData& Other) { return Other.Widget.Get() == Widget; });
+	if (Indicator && Indicator->Icon.Get() == IndicatorIcon)
 	{
 		Widget->SetIndicatorIcon(IndicatorIcon);
 	}
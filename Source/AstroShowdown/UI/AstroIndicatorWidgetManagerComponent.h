@@ -10,6 +10,7 @@
 
 #include "AstroIndicatorTypes.h"
 #include "Components/GameStateComponent.h"
+#include "Components/SlateWrapperTypes.h"
 #include "GameFramework/GameplayMessageSubsystem.h"
 #include "AstroIndicatorWidgetManagerComponent.generated.h"
 
@@ -19,6 +20,17 @@ class UCanvasPanel;
 class UHealthAttributeSet;
 class UMeshComponent;
 
+USTRUCT()
+struct FAstroIndicatorWidgetPool
+{
+	GENERATED_BODY()
+
+public:
+	/** Hidden widgets, still attached to the indicator root. This is used as a stack. */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAstroIndicatorWidget>> FreeWidgets;
+
+};
 
 UCLASS()
 class UAstroIndicatorWidgetManagerComponent : public UGameStateComponent
@@ -41,6 +53,10 @@ public:
 	UPROPERTY(EditAnywhere, Category = UI)
 	TSoftClassPtr<UAstroIndicatorWidget> EnemyIndicatorWidgetClass;
 
+	/** Maximum amount of hidden widgets kept around for each indicator class. Released widgets beyond this are removed from the canvas. */
+	UPROPERTY(EditAnywhere, Category = UI, Meta = (UIMin = 0, UIMax = 64))
+	int32 MaxPooledIndicatorsPerClass = 16;
+
 private:
 	/** Keeps track of all indicators in the world. We'll use this to update their positions and visibility. */
 	struct FNPCIndicatorData
@@ -49,12 +65,23 @@ private:
 		TWeakObjectPtr<UAstroIndicatorWidget> Widget = nullptr;
 		TWeakObjectPtr<const UHealthAttributeSet> CachedOwnerHealthAttributeSet = nullptr;
 		TWeakObjectPtr<const UMeshComponent> CachedOwnerMeshComponent = nullptr;
+		TSoftObjectPtr<UTexture2D> Icon;
 		FVector2D PreviousPosition = FVector2D::ZeroVector;
 		FVector OwnerPositionOffset = FVector::ZeroVector;
 		FName SocketName;
+
+		// Last values pushed to the widget. Values are only pushed when they change, to avoid invalidating the widget every frame.
+		ESlateVisibility PreviousVisibility = ESlateVisibility::Collapsed;
+		float PreviousAngle = 0.f;
+		float PreviousDistance = 0.f;
+		float PreviousReviveProgress = 0.f;
+
 		uint8 bDead : 1 = false;
 		uint8 bOffscreenActorOnly : 1 = true;
 
+		/** When set, all values are pushed to the widget on the next update. This is needed because widgets are recycled, so they may hold values from their previous owner. */
+		uint8 bForceUpdate : 1 = true;
+
 		bool operator==(const FNPCIndicatorData& Other)
 		{
 			return Owner == Other.Owner && Widget == Other.Widget;
@@ -62,6 +89,16 @@ private:
 	};
 	TArray<FNPCIndicatorData> Indicators;
 
+	/** Scratch buffer with the world positions of all indicators, so that they can all be projected in a single pass. Kept around to avoid reallocating it every frame. */
+	TArray<FVector> IndicatorWorldPositions;
+
+	/** Scratch buffer with the projected positions of IndicatorWorldPositions, in widget space. */
+	TArray<FVector2D> IndicatorScreenPositions;
+
+	/** Hidden widgets that can be reused by new indicators, for each indicator class. */
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<UAstroIndicatorWidget>, FAstroIndicatorWidgetPool> IndicatorWidgetPools;
+
 	UPROPERTY(Transient)
 	TWeakObjectPtr<UAstroTimeDilationSubsystem> CachedTimeDilationSubsystem = nullptr;
 
@@ -80,9 +117,29 @@ public:
 
 private:
 	void CreateIndicatorFor(const FAstroIndicatorWidgetSettings& IndicatorSettings);
+	void AddIndicator(UAstroIndicatorWidget* Widget, const FAstroIndicatorWidgetSettings& IndicatorSettings);
 	void RemoveIndicatorAt(const int32 IndicatorIndex);
 	void RemoveAllIndicators();
 
+	/** Pulls a hidden widget from the pool of the given class. Returns nullptr if there's none. */
+	UAstroIndicatorWidget* AcquirePooledWidget(TSubclassOf<UAstroIndicatorWidget> WidgetClass);
+	/** Hides the widget and stores it in the pool, or removes it from the canvas if the pool is full. */
+	void ReleaseWidget(UAstroIndicatorWidget* Widget);
+	void EmptyWidgetPools();
+
+	/**
+	* Projects IndicatorWorldPositions to widget space, writing the results into IndicatorScreenPositions.
+	* The view projection matrix is only computed once, instead of once per indicator.
+	* @return False if the local player has no valid view.
+	*/
+	bool ProjectIndicatorPositions(APlayerController* LocalPlayerController);
+
+	/** Pushes the new indicator values to its widget. Only values that changed since the last update are pushed. */
+	void UpdateIndicatorWidget(FNPCIndicatorData& Indicator, const FVector2D& OwnerScreenLocation, const FVector2D& ViewportSize);
+
+public:
+	int32 GetIndicatorCount() const { return Indicators.Num(); }
+
 private:
 	UFUNCTION()
 	void OnIndicatorSpawned(UUserWidget* NewWidget, const FAstroIndicatorWidgetSettings IndicatorSettings);
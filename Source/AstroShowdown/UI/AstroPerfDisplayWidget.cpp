@@ -7,8 +7,32 @@
 */
 
 #include "AstroPerfDisplayWidget.h"
+#include "AstroPerfTelemetrySubsystem.h"
 #include "Components/TextBlock.h"
 
+void UAstroPerfDisplayWidget::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	// Frames are recorded by the telemetry subsystem, as this widget only refreshes every TickInterval
+	if (UAstroPerfTelemetrySubsystem* PerfTelemetrySubsystem = UAstroPerfTelemetrySubsystem::Get(this))
+	{
+		PerfTelemetrySubsystem->RequestTelemetry();
+		RequestedPerfTelemetrySubsystem = PerfTelemetrySubsystem;
+	}
+}
+
+void UAstroPerfDisplayWidget::NativeDestruct()
+{
+	Super::NativeDestruct();
+
+	if (UAstroPerfTelemetrySubsystem* PerfTelemetrySubsystem = RequestedPerfTelemetrySubsystem.Get())
+	{
+		PerfTelemetrySubsystem->ReleaseTelemetry();
+	}
+	RequestedPerfTelemetrySubsystem.Reset();
+}
+
 void UAstroPerfDisplayWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 {
 	// If TickInterval is set, we'll only run Tick every few frames
@@ -27,4 +51,26 @@ void UAstroPerfDisplayWidget::NativeTick(const FGeometry& MyGeometry, float InDe
 		const int32 CurrentFPS = FMath::RoundToInt(1.0f / InDeltaTime);
 		FPSTextWidget->SetText(FText::FromString(FString::Printf(TEXT("FPS: %d"), CurrentFPS)));
 	}
+
+	const UAstroPerfTelemetrySubsystem* PerfTelemetrySubsystem = RequestedPerfTelemetrySubsystem.Get();
+	if (!PerfTelemetrySubsystem || (!FrameTimeTextWidget && !CountersTextWidget))
+	{
+		return;
+	}
+
+	const FAstroPerfFrameStats FrameStats = PerfTelemetrySubsystem->GetFrameStats();
+	if (FrameTimeTextWidget)
+	{
+		FrameTimeTextWidget->SetText(FText::FromString(FString::Printf(TEXT("Frame: p50 %.1fms | p95 %.1fms | p99 %.1fms\nGT: %.1fms | RT: %.1fms\nHitches: %d (%d total)"),
+			FrameStats.P50FrameMs, FrameStats.P95FrameMs, FrameStats.P99FrameMs,
+			FrameStats.AverageGameThreadMs, FrameStats.AverageRenderThreadMs,
+			FrameStats.RecentHitchCount, FrameStats.TotalHitchCount)));
+	}
+
+	if (CountersTextWidget)
+	{
+		CountersTextWidget->SetText(FText::FromString(FString::Printf(TEXT("Balls: %d | Pool Misses: %d\nIndicators: %d\nMessages/Frame: %.1f | Traces/Frame: %.1f"),
+			FrameStats.ActiveBalls, FrameStats.PoolMisses, FrameStats.Indicators,
+			FrameStats.AverageMessageBroadcastsPerFrame, FrameStats.AverageTraceCallsPerFrame)));
+	}
 }
@@ -11,6 +11,7 @@
 #include "Blueprint/UserWidget.h"
 #include "AstroPerfDisplayWidget.generated.h"
 
+class UAstroPerfTelemetrySubsystem;
 class UTextBlock;
 
 UCLASS()
@@ -20,6 +21,8 @@ class UAstroPerfDisplayWidget : public UUserWidget
 
 #pragma region UserWidget
 protected:
+	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
 	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
 #pragma endregion
 
@@ -27,10 +30,21 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
 	UTextBlock* FPSTextWidget = nullptr;
 
+	/** Shows frame time percentiles, thread times and hitches. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
+	UTextBlock* FrameTimeTextWidget = nullptr;
+
+	/** Shows gameplay counters (e.g., active balls, pool misses, indicators, messages and traces). */
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
+	UTextBlock* CountersTextWidget = nullptr;
+
 	UPROPERTY(EditDefaultsOnly)
 	float TickInterval = 0.1f;
 
 private:
 	float CurrentTickCounter = 0.f;
 
+	/** Set while this widget holds a telemetry request on UAstroPerfTelemetrySubsystem. */
+	TWeakObjectPtr<UAstroPerfTelemetrySubsystem> RequestedPerfTelemetrySubsystem;
+
 };
@@ -88,6 +88,9 @@ void UAstroGameplayHintComponent::EndPlay(const EEndPlayReason::Type EndPlayReas
 	{
 		LoadingScreenManager->OnLoadingScreenVisibilityChangedDelegate().RemoveAll(this);
 	}
+
+	// Releases the loading screen lock, as this component may be replaced while the loading screen is still visible
+	SetLoadingScreenLock(false);
 }
 
 void UAstroGameplayHintComponent::OnPlayerFocusStarted()
@@ -118,7 +121,12 @@ void UAstroGameplayHintComponent::OnPlayerDied()
 
 void UAstroGameplayHintComponent::OnLoadingScreenVisibilityChanged(const bool bIsLoadingScreenVisible)
 {
-	if (!CachedGameplayHintSubsystem.IsValid())
+	SetLoadingScreenLock(bIsLoadingScreenVisible);
+}
+
+void UAstroGameplayHintComponent::SetLoadingScreenLock(const bool bLocked)
+{
+	if (bHoldsLoadingScreenLock == bLocked || !CachedGameplayHintSubsystem.IsValid())
 	{
 		return;
 	}
@@ -129,7 +137,7 @@ void UAstroGameplayHintComponent::OnLoadingScreenVisibilityChanged(const bool bI
 		return;
 	}
 
-	if (bIsLoadingScreenVisible)
+	if (bLocked)
 	{
 		CachedGameplayHintSubsystem->AddLockInstigator(LoadingScreenManager);
 	}
@@ -137,6 +145,8 @@ void UAstroGameplayHintComponent::OnLoadingScreenVisibilityChanged(const bool bI
 	{
 		CachedGameplayHintSubsystem->RemoveLockInstigator(LoadingScreenManager);
 	}
+
+	bHoldsLoadingScreenLock = bLocked;
 }
 
 void UAstroGameplayHintComponent::OnPracticeModeStart(const FGameplayTag ChannelTag, const FPracticeModeGenericMessage& Message)
@@ -39,6 +39,12 @@ private:
 	/** Prevents from adding the revive hint multiple times during the same match. */
 	float LastAddedReviveHintTimestamp = 0.f;
 
+	/**
+	* Whether this component added the loading screen manager as a lock instigator.
+	* NOTE: Locks are ref-counted, so this prevents from stacking one per visibility event, and lets EndPlay release it.
+	*/
+	uint8 bHoldsLoadingScreenLock : 1 = false;
+
 private:
 	UFUNCTION()
 	void OnPlayerFocusStarted();
@@ -52,6 +58,8 @@ private:
 	UFUNCTION()
 	void OnLoadingScreenVisibilityChanged(const bool bIsLoadingScreenVisible);
 
+	void SetLoadingScreenLock(const bool bLocked);
+
 	void OnPracticeModeStart(const FGameplayTag ChannelTag, const FPracticeModeGenericMessage& Message);
 
 	void OnNPCRevive(const FGameplayTag ChannelTag, const FAstroGenericNPCReviveMessage& Message);
@@ -27,6 +27,59 @@ namespace AstroCVars
 DECLARE_LOG_CATEGORY_EXTERN(LogAstroGameplayHint, Log, All);
 DEFINE_LOG_CATEGORY(LogAstroGameplayHint);
 
+void FAstroGameplayHintQueue::Initialize(const int32 NumHintTypes)
+{
+	Entries.SetNum(FMath::RoundUpToPowerOfTwo(FMath::Max(NumHintTypes, 1)));
+	QueuedHints.Init(false, NumHintTypes);
+	Head = 0;
+	Count = 0;
+}
+
+void FAstroGameplayHintQueue::Reset()
+{
+	QueuedHints.SetRange(0, QueuedHints.Num(), false);
+	Head = 0;
+	Count = 0;
+}
+
+bool FAstroGameplayHintQueue::Enqueue(const EAstroGameplayHintType GameplayHint, const int32 Priority)
+{
+	const int32 HintIndex = static_cast<int32>(GameplayHint);
+	if (!ensureMsgf(QueuedHints.IsValidIndex(HintIndex) && Count < Entries.Num(), TEXT("Hint queue wasn't initialized for this hint type.")) || QueuedHints[HintIndex])
+	{
+		return false;
+	}
+
+	// Shifts lower priority hints towards the tail, so that the new hint lands after every hint with the same or higher priority
+	int32 Offset = Count;
+	while (Offset > 0 && Entries[GetSlot(Offset - 1)].Priority < Priority)
+	{
+		Entries[GetSlot(Offset)] = Entries[GetSlot(Offset - 1)];
+		Offset--;
+	}
+
+	FEntry& Entry = Entries[GetSlot(Offset)];
+	Entry.Hint = GameplayHint;
+	Entry.Priority = Priority;
+	QueuedHints[HintIndex] = true;
+	Count++;
+	return true;
+}
+
+EAstroGameplayHintType FAstroGameplayHintQueue::Dequeue()
+{
+	if (Count == 0)
+	{
+		return EAstroGameplayHintType::None;
+	}
+
+	const EAstroGameplayHintType TopmostHint = Entries[Head].Hint;
+	QueuedHints[static_cast<int32>(TopmostHint)] = false;
+	Head = GetSlot(1);
+	Count--;
+	return TopmostHint;
+}
+
 void UAstroGameplayHintSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
@@ -38,24 +91,36 @@ void UAstroGameplayHintSubsystem::Initialize(FSubsystemCollectionBase& Collectio
 		CachedCampaignPersistenceSubsystem = CampaignPersistenceSubsystem;
 	}
 
-	// Converts GameplayHintWidgetsConfig to GameplayHintWidgets
+	// Compiles GameplayHintWidgetsConfig into a table indexed by hint type
+	const int32 NumHintTypes = StaticEnum<EAstroGameplayHintType>()->GetMaxEnumValue() + 1;
+	CompiledHints.SetNum(NumHintTypes);
 	for (const FGameplayHintWidgetPair& GameplayHintWidgetConfig : GameplayHintWidgetsConfig)
 	{
-		ensureMsgf(!GameplayHintWidgets.Contains(GameplayHintWidgetConfig.Type), TEXT("Duplicate GameplayHint entry"));
-		GameplayHintWidgets.Add(GameplayHintWidgetConfig.Type, GameplayHintWidgetConfig.Widget);
-
-		if (GameplayHintWidgetConfig.bForceDisplayDuringOnboarding)
+		const int32 HintIndex = static_cast<int32>(GameplayHintWidgetConfig.Type);
+		if (GameplayHintWidgetConfig.Type == EAstroGameplayHintType::None || !CompiledHints.IsValidIndex(HintIndex))
 		{
-			OnboardingPermanentHints.Add(GameplayHintWidgetConfig.Type);
+			continue;
 		}
+
+		ensureMsgf(CompiledHints[HintIndex].Type == EAstroGameplayHintType::None, TEXT("Duplicate GameplayHint entry"));
+		CompiledHints[HintIndex] = GameplayHintWidgetConfig;
 	}
+
+	QueuedHints.Initialize(NumHintTypes);
 }
 
 void UAstroGameplayHintSubsystem::Deinitialize()
 {
 	Super::Deinitialize();
 
-	QueuedHints.Empty();
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(HintQueuedTimerHandle);
+	}
+	HintQueuedTimerHandle.Invalidate();
+
+	QueuedHints.Reset();
+	ActiveLockInstigators.Empty();
 }
 
 void UAstroGameplayHintSubsystem::QueueHint(const EAstroGameplayHintType GameplayHint)
@@ -70,10 +135,13 @@ void UAstroGameplayHintSubsystem::QueueHint(const EAstroGameplayHintType Gamepla
 		return;
 	}
 
-	if (ensureMsgf(GameplayHintWidgets.Contains(GameplayHint), TEXT("Couldn't find widget for the GameplayHint")))
+	const FGameplayHintWidgetPair* CompiledHint = FindCompiledHint(GameplayHint);
+	if (ensureMsgf(CompiledHint, TEXT("Couldn't find widget for the GameplayHint")))
 	{
-		QueuedHints.AddUnique(GameplayHint);
-		OnHintQueued.Broadcast(GameplayHint);
+		if (QueuedHints.Enqueue(GameplayHint, CompiledHint->Priority))
+		{
+			DirtyQueuedHints();
+		}
 	}
 }
 
@@ -89,8 +157,7 @@ void UAstroGameplayHintSubsystem::DequeueHint()
 		return;
 	}
 
-	const EAstroGameplayHintType TopmostHint = QueuedHints[0];
-	QueuedHints.RemoveAt(0);
+	const EAstroGameplayHintType TopmostHint = QueuedHints.Dequeue();
 
 	// Consider moving to AstroCampaignPersistenceComponent
 	if (CachedCampaignPersistenceSubsystem.IsValid())
@@ -101,10 +168,17 @@ void UAstroGameplayHintSubsystem::DequeueHint()
 
 void UAstroGameplayHintSubsystem::AddLockInstigator(UObject* NewLockInstigator)
 {
+	if (!NewLockInstigator)
+	{
+		return;
+	}
+
 	const bool bOldLockState = AreHintsLocked();
 
-	ActiveLockInstigators.Remove(nullptr);		// Clears invalid instigators
-	ActiveLockInstigators.Add(NewLockInstigator);
+	RemoveInvalidLockInstigators();
+	FAstroGameplayHintLock& Lock = ActiveLockInstigators.FindOrAdd(NewLockInstigator);
+	Lock.LockInstigator = NewLockInstigator;
+	Lock.LockCount++;
 
 	const bool bNewLockState = AreHintsLocked();
 	if (bOldLockState != bNewLockState)
@@ -117,8 +191,12 @@ void UAstroGameplayHintSubsystem::RemoveLockInstigator(UObject* LockInstigator)
 {
 	const bool bOldLockState = AreHintsLocked();
 
-	ActiveLockInstigators.Remove(nullptr);		// Clears invalid instigators
-	ActiveLockInstigators.Remove(LockInstigator);
+	RemoveInvalidLockInstigators();
+	FAstroGameplayHintLock* Lock = LockInstigator ? ActiveLockInstigators.Find(LockInstigator) : nullptr;
+	if (Lock && --Lock->LockCount <= 0)
+	{
+		ActiveLockInstigators.Remove(LockInstigator);
+	}
 
 	const bool bNewLockState = AreHintsLocked();
 	if (bOldLockState != bNewLockState)
@@ -127,6 +205,26 @@ void UAstroGameplayHintSubsystem::RemoveLockInstigator(UObject* LockInstigator)
 	}
 }
 
+TSoftClassPtr<UAstroGameplayHintWidget> UAstroGameplayHintSubsystem::GetHintWidget(const EAstroGameplayHintType GameplayHint) const
+{
+	const FGameplayHintWidgetPair* CompiledHint = FindCompiledHint(GameplayHint);
+	return CompiledHint ? CompiledHint->Widget : nullptr;
+}
+
+bool UAstroGameplayHintSubsystem::AreHintsLocked() const
+{
+	// NOTE: Instigators that were destroyed without removing their locks don't lock hints anymore
+	for (const TPair<TObjectKey<UObject>, FAstroGameplayHintLock>& Lock : ActiveLockInstigators)
+	{
+		if (Lock.Value.LockInstigator.IsValid())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 bool UAstroGameplayHintSubsystem::CanDisplayHint(const EAstroGameplayHintType GameplayHint) const
 {
 	if (AstroCVars::bIgnoreDisplayedHintCheck)
@@ -159,10 +257,73 @@ bool UAstroGameplayHintSubsystem::WasHintDisplayed(const EAstroGameplayHintType
 
 bool UAstroGameplayHintSubsystem::ShouldForceDisplayHint(const EAstroGameplayHintType GameplayHint) const
 {
-	if (CachedCampaignPersistenceSubsystem.IsValid() && OnboardingPermanentHints.Contains(GameplayHint))
+	const FGameplayHintWidgetPair* CompiledHint = FindCompiledHint(GameplayHint);
+	if (CachedCampaignPersistenceSubsystem.IsValid() && CompiledHint && CompiledHint->bForceDisplayDuringOnboarding)
 	{
 		return CachedCampaignPersistenceSubsystem->NumSectionsUnlocked() <= 1;
 	}
 
 	return false;
 }
+
+const FGameplayHintWidgetPair* UAstroGameplayHintSubsystem::FindCompiledHint(const EAstroGameplayHintType GameplayHint) const
+{
+	const int32 HintIndex = static_cast<int32>(GameplayHint);
+	if (CompiledHints.IsValidIndex(HintIndex) && CompiledHints[HintIndex].Type != EAstroGameplayHintType::None)
+	{
+		return &CompiledHints[HintIndex];
+	}
+
+	return nullptr;
+}
+
+void UAstroGameplayHintSubsystem::DirtyQueuedHints()
+{
+	if (const bool bIsAlreadyDirty = HintQueuedTimerHandle.IsValid() || bBroadcastWhenPersistenceReady)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		BroadcastQueuedHints();
+		return;
+	}
+
+	HintQueuedTimerHandle = World->GetTimerManager().SetTimerForNextTick(this, &ThisClass::BroadcastQueuedHints);
+}
+
+void UAstroGameplayHintSubsystem::BroadcastQueuedHints()
+{
+	HintQueuedTimerHandle.Invalidate();
+
+	// Hints queued before the displayed hints were loaded are re-checked once they are
+	if (CachedCampaignPersistenceSubsystem.IsValid() && !CachedCampaignPersistenceSubsystem->IsPersistenceReady())
+	{
+		bBroadcastWhenPersistenceReady = true;
+		CachedCampaignPersistenceSubsystem->CallOrRegister_OnPersistenceReady(FOnAstroCampaignPersistenceReady::FDelegate::CreateWeakLambda(this, [this]()
+		{
+			bBroadcastWhenPersistenceReady = false;
+			QueuedHints.RemoveAll([this](const EAstroGameplayHintType GameplayHint) { return !CanDisplayHint(GameplayHint); });
+			BroadcastQueuedHints();
+		}));
+		return;
+	}
+
+	if (!QueuedHints.IsEmpty())
+	{
+		OnHintQueued.Broadcast(QueuedHints.Peek());
+	}
+}
+
+void UAstroGameplayHintSubsystem::RemoveInvalidLockInstigators()
+{
+	for (auto It = ActiveLockInstigators.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().LockInstigator.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
@@ -9,6 +9,8 @@
 #pragma once
 
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "TimerManager.h"
+#include "UObject/ObjectKey.h"
 #include "AstroGameplayHintSubsystem.generated.h"
 
 class UAstroCampaignPersistenceSubsystem;
@@ -40,8 +42,70 @@ struct FGameplayHintWidgetPair
 
 	UPROPERTY()
 	uint8 bForceDisplayDuringOnboarding = false;
+
+	/** Queued hints with a higher priority are displayed first. Hints with the same priority are displayed in the order they were queued. */
+	UPROPERTY()
+	int32 Priority = 0;
 };
 
+/**
+* Ring buffer of unique hints, sorted by priority (highest first), and then by the order they were queued.
+* NOTE: Each hint can only be queued once, so the queue never holds more hints than there are hint types, and inserting is cheap.
+*/
+struct FAstroGameplayHintQueue
+{
+public:
+	void Initialize(const int32 NumHintTypes);
+	void Reset();
+
+	/** @return false if the hint was already queued. */
+	bool Enqueue(const EAstroGameplayHintType GameplayHint, const int32 Priority);
+	EAstroGameplayHintType Dequeue();
+	EAstroGameplayHintType Peek() const { return Count > 0 ? Entries[Head].Hint : EAstroGameplayHintType::None; }
+
+	/** Removes every queued hint that matches Predicate, keeping the order of the others. */
+	template <typename PredicateType>
+	void RemoveAll(PredicateType Predicate);
+
+	bool IsEmpty() const { return Count == 0; }
+	int32 Num() const { return Count; }
+
+private:
+	int32 GetSlot(const int32 Offset) const { return (Head + Offset) & (Entries.Num() - 1); }
+
+private:
+	struct FEntry
+	{
+		EAstroGameplayHintType Hint = EAstroGameplayHintType::None;
+		int32 Priority = 0;
+	};
+
+	/** Power of two sized, so that slots wrap with a mask. */
+	TArray<FEntry> Entries;
+	int32 Head = 0;
+	int32 Count = 0;
+
+	/** Which hint types are currently queued, indexed by EAstroGameplayHintType. */
+	TBitArray<> QueuedHints;
+};
+
+template <typename PredicateType>
+void FAstroGameplayHintQueue::RemoveAll(PredicateType Predicate)
+{
+	int32 NewCount = 0;
+	for (int32 Offset = 0; Offset < Count; Offset++)
+	{
+		const FEntry Entry = Entries[GetSlot(Offset)];
+		if (Predicate(Entry.Hint))
+		{
+			QueuedHints[static_cast<int32>(Entry.Hint)] = false;
+			continue;
+		}
+		Entries[GetSlot(NewCount++)] = Entry;
+	}
+	Count = NewCount;
+}
+
 
 UCLASS(Config=Game)
 class UAstroGameplayHintSubsystem : public UGameInstanceSubsystem
@@ -59,21 +123,26 @@ private:
 	UPROPERTY(Config)
 	TArray<FGameplayHintWidgetPair> GameplayHintWidgetsConfig;
 
-	/** Maps AstroGameplayHintTypes to their respective widget class. This is derived from GameplayHintWidgetsConfig. */
+	/** GameplayHintWidgetsConfig, indexed by EAstroGameplayHintType. Hint types without a config have their Type set to None. */
 	UPROPERTY()
-	TMap<EAstroGameplayHintType, TSoftClassPtr<UAstroGameplayHintWidget>> GameplayHintWidgets;
-
-	/** Contains the list of hints that should always be displayed during onboarding, no matter if they already were. */
-	UPROPERTY()
-	TSet<EAstroGameplayHintType> OnboardingPermanentHints;
+	TArray<FGameplayHintWidgetPair> CompiledHints;
 
 	/** Hints waiting to get processed and displayed on the screen. */
-	UPROPERTY()
-	TArray<EAstroGameplayHintType> QueuedHints;
+	FAstroGameplayHintQueue QueuedHints;
 
-	/** Stores a list of objects that are actively locking hints. */
-	UPROPERTY()
-	TSet<TWeakObjectPtr<UObject>> ActiveLockInstigators;
+	/** Objects that are actively locking hints, along with how many times each of them locked hints. */
+	struct FAstroGameplayHintLock
+	{
+		TWeakObjectPtr<UObject> LockInstigator;
+		int32 LockCount = 0;
+	};
+	TMap<TObjectKey<UObject>, FAstroGameplayHintLock> ActiveLockInstigators;
+
+	/** Defers OnHintQueued to the next frame, so that multiple hints queued in a single frame cause a single UI update. */
+	FTimerHandle HintQueuedTimerHandle;
+
+	/** Set while OnHintQueued is waiting for the campaign persistence to load, so that already displayed hints can be dropped first. */
+	uint8 bBroadcastWhenPersistenceReady : 1 = false;
 
 	UPROPERTY()
 	TWeakObjectPtr<UAstroCampaignPersistenceSubsystem> CachedCampaignPersistenceSubsystem = nullptr;
@@ -83,37 +152,47 @@ protected:
 	UPROPERTY(BlueprintAssignable)
 	FOnLockStateChanged OnLockStateChanged;
 
-	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnHintQueued, EAstroGameplayHintType, NewGameplayHint);
+	/**
+	* Broadcast on the frame after one or more hints were queued, with the hint that should be displayed now.
+	* NOTE: TopmostGameplayHint is the top of the queue (highest priority, then FIFO), which isn't necessarily one of the hints that were just queued.
+	*/
+	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnHintQueued, EAstroGameplayHintType, TopmostGameplayHint);
 	UPROPERTY(BlueprintAssignable)
 	FOnHintQueued OnHintQueued;
 
 public:
-	/** Adds a hint to the queue. */
+	/**
+	* Adds a hint to the queue. Queueing a hint that is already queued is a no-op.
+	* NOTE: OnHintQueued is only broadcast on the next frame, once for all the hints queued in a frame.
+	*/
 	UFUNCTION(BlueprintCallable)
 	void QueueHint(const EAstroGameplayHintType GameplayHint);
 
-	/** Removes the least recent hint from the queue (FIFO). */
+	/** Removes the topmost hint from the queue (highest priority, then FIFO). */
 	UFUNCTION(BlueprintCallable)
 	void DequeueHint();
 
-	/** Adds a lock instigator. Those will prevent the UI from dequeueing/displaying hints. */
+	/**
+	* Adds a lock instigator. Those will prevent the UI from dequeueing/displaying hints.
+	* Locks are ref-counted, so each call should be matched by a RemoveLockInstigator call. Destroyed instigators release their locks.
+	*/
 	void AddLockInstigator(UObject* NewLockInstigator);
 
-	/** Removes a lock instigator, if it's active. */
+	/** Removes one lock from a lock instigator, if it's active. */
 	void RemoveLockInstigator(UObject* LockInstigator);
 
 public:
-	/** @return Least recent hint from the queue (FIFO). */
+	/** @return Topmost hint from the queue (highest priority, then FIFO). */
 	UFUNCTION(BlueprintPure)
-	EAstroGameplayHintType GetQueuedHint() const { return QueuedHints.IsEmpty() ? EAstroGameplayHintType::None : QueuedHints[0]; }
+	EAstroGameplayHintType GetQueuedHint() const { return QueuedHints.Peek(); }
 
 	/** @return UAstroGameplayHintWidget that represents the specified hint, as defined in GameplayHintWidgetsConfig. */
 	UFUNCTION(BlueprintPure)
-	TSoftClassPtr<UAstroGameplayHintWidget> GetHintWidget(const EAstroGameplayHintType GameplayHint) const { return GameplayHintWidgets.FindRef(GameplayHint, nullptr); }
+	TSoftClassPtr<UAstroGameplayHintWidget> GetHintWidget(const EAstroGameplayHintType GameplayHint) const;
 
 	/** @return True if hints are locked. */
 	UFUNCTION(BlueprintPure)
-	bool AreHintsLocked() const { return ActiveLockInstigators.Num() > 0; }
+	bool AreHintsLocked() const;
 
 	/** @return True if the hint passes the display checks. */
 	bool CanDisplayHint(const EAstroGameplayHintType GameplayHint) const;
@@ -125,4 +204,14 @@ private:
 	/** @return True if the hint should always be displayed, no matter if it already was. */
 	bool ShouldForceDisplayHint(const EAstroGameplayHintType GameplayHint) const;
 
+	/** @return Config of a hint, or nullptr if the hint has no widget. */
+	const FGameplayHintWidgetPair* FindCompiledHint(const EAstroGameplayHintType GameplayHint) const;
+
+	/** Schedules a single OnHintQueued broadcast for every hint queued during this frame. */
+	void DirtyQueuedHints();
+	void BroadcastQueuedHints();
+
+	/** Drops instigators that were destroyed while locking hints. */
+	void RemoveInvalidLockInstigators();
+
 };
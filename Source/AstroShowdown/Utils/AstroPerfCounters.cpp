@@ -0,0 +1,25 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#include "AstroPerfCounters.h"
+
+namespace AstroPerfCounters
+{
+	static uint64 TotalTraceCalls = 0;
+
+	void AddTraceCalls(const int32 TraceCount)
+	{
+		checkSlow(IsInGameThread());
+		TotalTraceCalls += TraceCount;
+	}
+
+	uint64 GetTotalTraceCalls()
+	{
+		return TotalTraceCalls;
+	}
+}
@@ -0,0 +1,24 @@
+/*
+* Copyright (c) 2024 DodgeBowl Team
+* Licensed under the Creative Commons Attribution-NonCommercial 4.0 International (CC BY-NC 4.0).
+*
+* Full license terms: https://creativecommons.org/licenses/by-nc/4.0/
+* This file is part of Astro Showdown, and is intended for educational and non-commercial use only.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Lightweight counters for gameplay hot paths that the engine doesn't track on its own.
+* These are only read by the perf telemetry, so they're plain game thread counters.
+*/
+namespace AstroPerfCounters
+{
+	/** Should be called by gameplay code whenever it issues a scene query (trace, sweep or overlap). */
+	ASTROSHOWDOWN_API void AddTraceCalls(const int32 TraceCount = 1);
+
+	/** @return How many scene queries gameplay code issued since the game started. */
+	ASTROSHOWDOWN_API uint64 GetTotalTraceCalls();
+}